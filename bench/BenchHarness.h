@@ -0,0 +1,224 @@
+#pragma once
+
+// ============== HARNESS DE MICROBENCHMARKS ==============
+// Sem dependências externas. Cada caso roda uma vez de aquecimento e depois
+// repete até atingir o tempo mínimo (--min-time) ou o limite de iterações;
+// cada iteração é cronometrada separadamente para dar mínimo, mediana e p99.
+// As alocações são contadas substituindo operator new/delete (defina
+// BENCH_HARNESS_IMPLEMENTATION em exatamente um .cpp antes do include);
+// código C que usa malloc pode contar com benchMalloc/benchRealloc/benchFree.
+//
+// Opções: --filter TEXTO   só casos cujo nome contém TEXTO
+//         --min-time S     tempo mínimo por caso (padrão 0.25 s)
+//         --max-iters N    limite de iterações por caso (padrão 100000)
+//         --json ARQUIVO   grava os resultados em JSON para comparar execuções
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+struct BenchAllocStats {
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+};
+
+inline BenchAllocStats benchAllocs;
+
+// Impede o compilador de descartar um resultado
+template <typename T>
+inline void benchKeep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;
+    int opsPerIteration = 1;
+    double minNs = 0, medianNs = 0, p99Ns = 0, meanNs = 0; // por operação
+    double allocsPerIteration = 0, bytesPerIteration = 0;
+};
+
+class BenchRunner {
+public:
+    BenchRunner(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--filter" && hasValue)
+                filter = argv[++i];
+            else if (arg == "--min-time" && hasValue)
+                minTime = std::atof(argv[++i]);
+            else if (arg == "--max-iters" && hasValue)
+                maxIters = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--json" && hasValue)
+                jsonPath = argv[++i];
+        }
+    }
+
+    // 'body' executa 'ops' operações; tempos e alocações são divididos por 'ops' (para casos de poucos ns)
+    template <typename F>
+    void run(const std::string& name, F&& body, int ops = 1)
+    {
+        if (!selected(name))
+            return;
+        body(); // aquecimento (caches, páginas, alocador)
+
+        std::vector<double> samples;
+        samples.reserve(1024);
+        uint64_t allocs0 = benchAllocs.count.load(), bytes0 = benchAllocs.bytes.load();
+        auto start = Clock::now();
+        double elapsed = 0.0;
+        while ((elapsed < minTime || samples.size() < 5) && samples.size() < maxIters) {
+            auto t0 = Clock::now();
+            body();
+            auto t1 = Clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / ops);
+            elapsed = std::chrono::duration<double>(t1 - start).count();
+        }
+        // O vetor de amostras cresce durante a medição; desconta as realocações dele
+        uint64_t ownAllocs = 0, ownBytes = 0;
+        for (size_t cap = 1024; cap < samples.size(); cap *= 2) {
+            ownAllocs++;
+            ownBytes += cap * 2 * sizeof(double);
+        }
+
+        BenchResult r;
+        r.name = name;
+        r.iterations = samples.size();
+        r.opsPerIteration = ops;
+        r.allocsPerIteration = double(benchAllocs.count.load() - allocs0 - ownAllocs) / ((double)r.iterations * ops);
+        r.bytesPerIteration = double(benchAllocs.bytes.load() - bytes0 - ownBytes) / ((double)r.iterations * ops);
+        double sum = 0.0;
+        for (double s : samples)
+            sum += s;
+        r.meanNs = sum / samples.size();
+        std::sort(samples.begin(), samples.end());
+        r.minNs = samples.front();
+        r.medianNs = samples[samples.size() / 2];
+        r.p99Ns = samples[std::min(samples.size() - 1, (size_t)(samples.size() * 0.99))];
+        results.push_back(r);
+        print(r);
+    }
+
+    // O caso passa pelo --filter
+    bool selected(const std::string& name) const { return filter.empty() || name.find(filter) != std::string::npos; }
+
+    const std::vector<BenchResult>& all() const { return results; }
+
+    // Grava o JSON pedido em --json; devolve false se não conseguiu
+    bool finish() const
+    {
+        if (jsonPath.empty())
+            return true;
+        FILE* f = std::fopen(jsonPath.c_str(), "w");
+        if (!f) {
+            std::cerr << "[bench] erro ao gravar " << jsonPath << std::endl;
+            return false;
+        }
+        std::fprintf(f, "{\n  \"timestamp\": %lld,\n  \"optimized\": %s,\n  \"benchmarks\": [", (long long)std::time(nullptr),
+#ifdef NDEBUG
+                     "true"
+#else
+                     "false"
+#endif
+        );
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            std::fprintf(f,
+                         "%s\n    {\"name\": \"%s\", \"iterations\": %llu, \"ops_per_iteration\": %d, \"min_ns\": %.2f, "
+                         "\"median_ns\": %.2f, \"p99_ns\": %.2f, \"mean_ns\": %.2f, \"allocs_per_iteration\": %.2f, "
+                         "\"bytes_per_iteration\": %.1f}",
+                         i ? "," : "", r.name.c_str(), (unsigned long long)r.iterations, r.opsPerIteration, r.minNs,
+                         r.medianNs, r.p99Ns, r.meanNs, r.allocsPerIteration, r.bytesPerIteration);
+        }
+        std::fprintf(f, "\n  ]\n}\n");
+        std::fclose(f);
+        std::cout << "[bench] " << results.size() << " resultados em " << jsonPath << std::endl;
+        return true;
+    }
+
+    static void printHeader()
+    {
+        std::printf("%-40s %10s %12s %12s %12s %10s %12s\n", "caso", "iter", "min", "mediana", "p99", "aloc/it", "bytes/it");
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    std::string filter, jsonPath;
+    double minTime = 0.25;
+    uint64_t maxIters = 100000;
+    std::vector<BenchResult> results;
+
+    static std::string formatNs(double ns)
+    {
+        char buf[32];
+        if (ns < 1e3)
+            std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+        else if (ns < 1e6)
+            std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+        else
+            std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+        return buf;
+    }
+
+    static void print(const BenchResult& r)
+    {
+        std::printf("%-40s %10llu %12s %12s %12s %10.1f %12.0f\n", r.name.c_str(), (unsigned long long)r.iterations,
+                    formatNs(r.minNs).c_str(), formatNs(r.medianNs).c_str(), formatNs(r.p99Ns).c_str(),
+                    r.allocsPerIteration, r.bytesPerIteration);
+        std::fflush(stdout);
+    }
+};
+
+inline void* benchMalloc(std::size_t size)
+{
+    benchAllocs.count.fetch_add(1, std::memory_order_relaxed);
+    benchAllocs.bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+
+inline void* benchRealloc(void* p, std::size_t size)
+{
+    benchAllocs.count.fetch_add(1, std::memory_order_relaxed);
+    benchAllocs.bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::realloc(p, size);
+}
+
+inline void benchFree(void* p) { std::free(p); }
+
+#ifdef BENCH_HARNESS_IMPLEMENTATION
+// ==== CONTAGEM DE ALOCAÇÕES ====
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // new e delete daqui usam malloc/free
+#endif
+void* operator new(std::size_t size)
+{
+    benchAllocs.count.fetch_add(1, std::memory_order_relaxed);
+    benchAllocs.bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
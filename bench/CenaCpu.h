@@ -0,0 +1,301 @@
+#pragma once
+
+// ============== CENAS PARA OS RENDERIZADORES EM CPU ==============
+// Geometria, materiais, câmera e luz da CenaFinal e do Phong montados sem GL,
+// compartilhados pelo cg_softraster e pelo cg_raytrace, e as rotinas de
+// imagem usadas para comparar com as capturas do modo headless.
+// stb_image/stb_image_write: a implementação fica no .cpp que inclui este header.
+//
+// Cenas:
+//   cenafinal  estado inicial da CenaFinal (luz da casa), com os mesmos
+//              caminhos, materiais e clips (animacao.arquivo) do config.ini:
+//              a pose de ovni e vaca vem do clip inicial, como na CenaFinal;
+//              céu de fundo, chão, casa, ovni e vaca, na ordem do pass "modelos".
+//   phong      Cube.obj do Phong.cpp girado pelo ângulo 't'.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stb_image.h>
+#include <stb_image_write.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <Config.h>
+#include <Camera.h>
+#include <Herd.h>
+#include <ObjLoader.h>
+#include <SoftShading.h>
+
+struct Parte {
+    std::vector<Vertex> vertices;
+    SoftMaterial material;
+};
+
+struct Objeto {
+    std::vector<Parte> partes;
+    glm::mat4 model = glm::mat4(1.0f);
+};
+
+struct Cena {
+    std::vector<Objeto> objetos;
+    const SoftTexture* fundo = nullptr; // quad de tela cheia (céu), ou corFundo
+    glm::vec3 corFundo = glm::vec3(0.0f);
+    glm::mat4 view = glm::mat4(1.0f), proj = glm::mat4(1.0f);
+    glm::vec3 viewPos = glm::vec3(0.0f);
+    SoftLight luz;
+};
+
+// Texturas carregadas uma vez por caminho (várias partes usam a mesma)
+inline std::map<std::string, std::unique_ptr<SoftTexture>> texturasCpu;
+
+inline const SoftTexture* carregarTextura(const std::string& path)
+{
+    auto it = texturasCpu.find(path);
+    if (it != texturasCpu.end())
+        return it->second.get();
+    int w, h, c;
+    unsigned char* data = stbi_load(path.c_str(), &w, &h, &c, 0);
+    if (!data) {
+        std::cerr << "[cena cpu] erro ao carregar textura: " << path << std::endl;
+        texturasCpu[path] = nullptr;
+        return nullptr;
+    }
+    std::unique_ptr<SoftTexture> tex(new SoftTexture());
+    tex->assign(data, w, h, c);
+    stbi_image_free(data);
+    return (texturasCpu[path] = std::move(tex)).get();
+}
+
+inline bool carregarObjeto(const std::string& objPath, Objeto& objeto, bool inverterV = false)
+{
+    ObjData data;
+    std::string dir = objPath.substr(0, objPath.find_last_of("/\\"));
+    if (!parseOBJ(objPath, dir, data)) {
+        std::cerr << "[cena cpu] erro ao abrir " << objPath << std::endl;
+        return false;
+    }
+    std::vector<MeshPart> parts;
+    assembleMeshParts(data, parts);
+    for (MeshPart& mp : parts) {
+        Parte p;
+        p.vertices = std::move(mp.vertices);
+        if (inverterV) {
+            for (Vertex& v : p.vertices)
+                v.texCoord.y = 1.0f - v.texCoord.y;
+        }
+        p.material.material = mp.material;
+        if (!mp.texture.empty())
+            p.material.texture = carregarTextura(mp.texture);
+        objeto.partes.push_back(std::move(p));
+    }
+    return true;
+}
+
+inline bool montarCenaFinal(const std::string& assets, float t, int largura, int altura, Cena& cena)
+{
+    using namespace glm;
+    std::string base = assets + "/Modelos3D/final/";
+    cena.fundo = carregarTextura(getString("texturas.textura_ceu", base + "ceu.png"));
+
+    // Estado inicial da simulação: o mesmo clip e os mesmos parâmetros da CenaFinal
+    std::shared_ptr<const Settings> cfg = currentSettings();
+    std::map<std::string, float> params = {
+        { "abducao", cfg->alturas.abducao },
+        { "ovni_topo", cfg->estadoInicial.ovniTopo },
+        { "ovni_baixo", cfg->estadoInicial.ovniBaixo },
+        { "amplitude", cfg->curvas.amplitude },
+    };
+    AnimationLibrary animacoes;
+    AbductionClips clips;
+    if (!animacoes.load(getString("animacao.arquivo", assets + "/Animacoes/abducao.anim"), params) ||
+        !clips.resolve(animacoes))
+        return false;
+    AnimationPlayer abducao;
+    clips.start(abducao, animacoes, cfg->estadoInicial.casaLuz, cfg->estadoInicial.vacaY);
+    const AnimationPose& pose = abducao.pose();
+    float ovniY = pose.floats[clips.ufoY];
+    float vacaY = pose.floats[clips.cowY];
+
+    Objeto ovni, vaca, casa, chao;
+    if (!carregarObjeto(getString("modelo_paths.ovni", base + "Nave.obj"), ovni) ||
+        !carregarObjeto(getString("modelo_paths.vaca", base + "vaca.obj"), vaca) ||
+        !carregarObjeto(getString("modelo_paths.casa", base + "casa.obj"), casa))
+        return false;
+    ovni.model = ufoModel(vec3(0.0f), ovniY, t);
+    casa.model = translate(mat4(1.0f), vec3(5, 0, -5));
+    vaca.model = cowModel(vec3(0.0f), vacaY, pose.vec3s[clips.cowOffset], pose.quats[clips.cowRot]);
+
+    Parte p;
+    p.vertices = {
+        {{-50.0f, 0.0f, -50.0f}, {0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{ 50.0f, 0.0f, -50.0f}, {1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{ 50.0f, 0.0f,  50.0f}, {1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+        {{-50.0f, 0.0f, -50.0f}, {0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{ 50.0f, 0.0f,  50.0f}, {1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+        {{-50.0f, 0.0f,  50.0f}, {0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+    };
+    p.material.texture = carregarTextura(getString("texturas.textura_chao", base + "grama.png"));
+    p.material.material.ka = getVec3("chao_ka", vec3(0.2f));
+    p.material.material.kd = getVec3("chao_kd", vec3(0.8f));
+    p.material.material.ks = getVec3("chao_ks", vec3(0.1f));
+    p.material.material.shininess = getFloat("chao_shininess", 8.0f);
+    chao.partes.push_back(std::move(p));
+
+    // Mesma ordem de desenho do pass "modelos"
+    cena.objetos.clear();
+    cena.objetos.push_back(std::move(chao));
+    cena.objetos.push_back(std::move(casa));
+    cena.objetos.push_back(std::move(ovni));
+    cena.objetos.push_back(std::move(vaca));
+
+    Camera camera(vec3(0.0f, 1.5f, 10.0f));
+    cena.view = camera.GetViewMatrix();
+    cena.proj = perspective(radians(45.0f), (float)largura / altura, 0.1f, 100.0f);
+    cena.viewPos = camera.position;
+
+    // Luz da casa apontando para a vaca
+    cena.luz.position = vec3(5.0f, 1.5f, -6.5f);
+    cena.luz.direction = normalize(vec3(0, vacaY, 0) - cena.luz.position);
+    cena.luz.color = vec3(1.0f);
+    cena.luz.specColor = cena.luz.color * 0.4f + vec3(0.2f);
+    return true;
+}
+
+inline bool montarCenaPhong(const std::string& assets, float t, int largura, int altura, Cena& cena)
+{
+    using namespace glm;
+    // O Phong.cpp lê as UVs sem inverter o v
+    Objeto cubo;
+    if (!carregarObjeto(assets + "/Modelos3D/Cube.obj", cubo, true))
+        return false;
+    cubo.model = rotate(mat4(1.0f), t, vec3(1, 1, 0));
+    cena.objetos.clear();
+    cena.objetos.push_back(std::move(cubo));
+    cena.corFundo = vec3(0.1f);
+    cena.view = translate(mat4(1.0f), vec3(0, 0, -5.0f));
+    cena.proj = perspective(radians(45.0f), (float)largura / altura, 0.1f, 100.0f);
+    cena.viewPos = vec3(0.0f, 0.0f, 5.0f);
+
+    cena.luz.position = vec3(3.0f, 3.0f, 3.0f);
+    cena.luz.color = vec3(1.0f);
+    cena.luz.specColor = vec3(1.0f);
+    cena.luz.spot = false;
+    cena.luz.attenuation = false;
+    cena.luz.gain = 1.0f;
+    return true;
+}
+
+// largura/altura: tamanho da imagem, para a proporção da projeção
+inline bool montarCena(const std::string& nome, const std::string& assets, float t, int largura, int altura, Cena& cena)
+{
+    if (nome == "phong")
+        return montarCenaPhong(assets, t, largura, altura, cena);
+    if (nome != "cenafinal") {
+        std::cerr << "[cena cpu] cena desconhecida: " << nome << " (cenafinal ou phong)" << std::endl;
+        return false;
+    }
+    return montarCenaFinal(assets, t, largura, altura, cena);
+}
+
+// ==== IMAGENS ====
+// FNV-1a do framebuffer
+inline uint64_t hashImagem(const std::vector<uint32_t>& pixels)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (uint32_t p : pixels) {
+        h ^= p;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Framebuffer RGBA8 (linha 0 embaixo) -> RGB de cima para baixo, como nos PNGs do modo headless
+inline std::vector<unsigned char> paraRGB(const std::vector<uint32_t>& pixels, int w, int h)
+{
+    std::vector<unsigned char> rgb((size_t)w * h * 3);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint32_t p = pixels[(size_t)(h - 1 - y) * w + x];
+            unsigned char* d = &rgb[((size_t)y * w + x) * 3];
+            d[0] = p & 0xff;
+            d[1] = (p >> 8) & 0xff;
+            d[2] = (p >> 16) & 0xff;
+        }
+    }
+    return rgb;
+}
+
+inline bool gravarPNG(const std::string& path, const std::vector<unsigned char>& rgb, int w, int h, const char* prefixo)
+{
+    if (!stbi_write_png(path.c_str(), w, h, 3, rgb.data(), w * 3)) {
+        std::cerr << prefixo << " erro ao gravar " << path << std::endl;
+        return false;
+    }
+    std::cout << prefixo << " imagem em " << path << std::endl;
+    return true;
+}
+
+// Erro médio, RMSE, PSNR e pixels diferentes (algum canal com |d| > limiar); 'diffPath' grava |d| x8
+inline bool compararImagem(const std::vector<unsigned char>& rgb, int w, int h, const std::string& refPath,
+                           const std::string& diffPath, const char* prefixo)
+{
+    int rw, rh, rc;
+    unsigned char* ref = stbi_load(refPath.c_str(), &rw, &rh, &rc, 3);
+    if (!ref) {
+        std::cerr << prefixo << " erro ao carregar referência: " << refPath << std::endl;
+        return false;
+    }
+    if (rw != w || rh != h) {
+        std::cerr << prefixo << " referência com " << rw << "x" << rh << ", esperado " << w << "x" << h << std::endl;
+        stbi_image_free(ref);
+        return false;
+    }
+    const int LIMIAR = 8;
+    double somaAbs = 0.0, somaQuad = 0.0;
+    size_t diferentes = 0;
+    int maxDiff = 0;
+    std::vector<unsigned char> diff(diffPath.empty() ? 0 : rgb.size());
+    for (size_t i = 0; i < (size_t)w * h; i++) {
+        int maior = 0;
+        for (int c = 0; c < 3; c++) {
+            int d = std::abs((int)rgb[i * 3 + c] - (int)ref[i * 3 + c]);
+            somaAbs += d;
+            somaQuad += (double)d * d;
+            maior = std::max(maior, d);
+            if (!diff.empty())
+                diff[i * 3 + c] = (unsigned char)std::min(255, d * 8);
+        }
+        maxDiff = std::max(maxDiff, maior);
+        if (maior > LIMIAR)
+            diferentes++;
+    }
+    stbi_image_free(ref);
+
+    double n = (double)w * h * 3;
+    double rmse = std::sqrt(somaQuad / n);
+    double psnr = rmse > 0.0 ? 20.0 * std::log10(255.0 / rmse) : INFINITY;
+    std::printf("%s referência %s: erro médio %.3f, RMSE %.3f, PSNR %.2f dB, máx %d, %.2f%% dos pixels com diferença > %d\n",
+                prefixo, refPath.c_str(), somaAbs / n, rmse, psnr, maxDiff, 100.0 * diferentes / ((double)w * h), LIMIAR);
+    if (!diff.empty() && stbi_write_png(diffPath.c_str(), w, h, 3, diff.data(), w * 3))
+        std::cout << prefixo << " diferença (x8) em " << diffPath << std::endl;
+    return true;
+}
+
+// Contagens de threads para as tabelas de escalonamento: 1, 2, 4, ... e o total da máquina
+inline std::vector<int> contagensDeThreads(int maximo)
+{
+    std::vector<int> contagens;
+    for (int n = 1; n < maximo; n *= 2)
+        contagens.push_back(n);
+    contagens.push_back(maximo);
+    return contagens;
+}
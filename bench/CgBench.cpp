@@ -0,0 +1,634 @@
+// ============== CG_BENCH ==============
+// Microbenchmarks das rotinas de CPU da CenaFinal, sem janela nem contexto GL:
+//   obj_parse/*      parseOBJ (inclui o .mtl referenciado) de cada .obj em assets/Modelos3D
+//   obj_assemble/*   montagem dos vértices intercalados a partir dos índices já lidos
+//   mtl_parse/*      parseMTL de cada .mtl
+//   stbi_load/*      decodificação de cada .png
+//   camera/*         Camera::Rotate e Camera::GetViewMatrix
+//   config/*         getFloat / getVec3 / getString sobre um config com as chaves da cena,
+//                    parseSettings do mesmo mapa e a leitura por frame via SettingsSnapshot
+//   herd/*           Herd::step e Herd::buildMatrices com 1k, 10k e 100k vacas (um ovni a cada 10)
+//   anim/*           AnimationBatch::advance + evaluate de 25k instâncias x 4 trilhas (100k trilhas
+//                    por frame): um clip, dois clips misturados, a mesma amostragem sem cursor
+//                    (busca a cada amostra) e os clips reais da abdução
+//   path/*           SplinePath: build (coeficientes + LUT) de um caminho de 100k pontos e 10k objetos
+//                    andando nele com cursor e com busca binária; imprime quanto a velocidade
+//                    foge de constante
+//   particles/*      CpuParticles (fallback sem compute do raio trator): um passo de 1M partículas
+//                    em regime (emissão = mortes), com 1 thread e com todas; ns/op x 1M = ms/frame
+//   transform/*      TransformBatch (escalar, SSE, AVX2) montando model, e model+mvp+normal, de 10k
+//                    objetos; antes confere cada kernel contra glm::translate/rotate/scale e imprime
+//                    o erro em ulps e a vazão em matrizes/s
+//   scene/*          SceneGraph::update em hierarquia profunda (cadeia de 10k nós) e larga (raiz +
+//                    10k filhos): raiz suja (tudo recalculado), uma folha suja e 1% dos filhos sujos
+//   jobs/*           JobSystem: custo de run()+wait() de um job vazio e escalonamento de um
+//                    parallelFor com 1, 2, 4... threads (imprime roubos e contenção de cada caso)
+//
+// Uso: cg_bench [--assets DIR] [--filter TEXTO] [--min-time S] [--max-iters N] [--json ARQUIVO]
+// (rodando de build/, como os exercícios, DIR padrão = ../assets/Modelos3D; as animações
+// vêm de DIR/../Animacoes)
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define BENCH_HARNESS_IMPLEMENTATION
+#include "BenchHarness.h"
+
+// stb_image aloca com malloc: passa pelos contadores do harness
+#define STBI_MALLOC(sz) benchMalloc(sz)
+#define STBI_REALLOC(p, newsz) benchRealloc(p, newsz)
+#define STBI_FREE(p) benchFree(p)
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <Config.h>
+#include <Camera.h>
+#include <ObjLoader.h>
+#include <Animation.h>
+#include <Herd.h>
+#include <JobSystem.h>
+#include <TransformBatch.h>
+#include <SceneGraph.h>
+#include <SplinePath.h>
+#include <ParticleSystem.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Arquivos com a extensão pedida, em ordem (para a saída ser comparável entre execuções)
+vector<fs::path> listarArquivos(const fs::path& dir, const string& extensao) {
+    vector<fs::path> arquivos;
+    error_code ec;
+    for (fs::recursive_directory_iterator it(dir, ec), fim; !ec && it != fim; it.increment(ec)) {
+        if (it->is_regular_file() && it->path().extension() == extensao)
+            arquivos.push_back(it->path());
+    }
+    sort(arquivos.begin(), arquivos.end());
+    return arquivos;
+}
+
+string nomeRelativo(const fs::path& arquivo, const fs::path& base) {
+    return fs::relative(arquivo, base).generic_string();
+}
+
+// Chaves que a CenaFinal consulta (valores no formato do config.ini)
+void preencherConfig() {
+    config.clear();
+    const char* secoes[] = { "window", "alturas", "curvas", "estado_inicial", "luz_casa", "luz_ovni", "luzes",
+                             "renderer", "sombra", "oclusao", "texturas", "modelo_paths", "simulacao", "profiler" };
+    for (const char* secao : secoes) {
+        for (int i = 0; i < 6; i++)
+            config[string(secao) + ".chave" + to_string(i)] = to_string(i * 0.5f);
+    }
+    config["luz_casa.ka"] = "0.2,0.2,0.2";
+    config["luz_casa.kd"] = "1.5,1.5,1.5";
+    config["luz_casa.ks"] = "0.3,0.3,0.3";
+    config["luz_ovni.ka"] = "0.05,0.2,0.05";
+    config["luz_ovni.kd"] = "0.2,1.0,0.2";
+    config["luz_ovni.ks"] = "0.1,0.8,0.1";
+    config["alturas.abducao"] = "5.0";
+    config["luzes.raio"] = "2.5";
+    config["window.title"] = "OVNI vs Vaca";
+}
+
+int main(int argc, char** argv) {
+    fs::path assets = "../assets/Modelos3D";
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--assets")
+            assets = argv[i + 1];
+    }
+    if (!fs::is_directory(assets)) {
+        cerr << "[bench] pasta de assets não encontrada: " << assets << " (use --assets DIR)" << endl;
+        return 1;
+    }
+#ifndef NDEBUG
+    cout << "[bench] aviso: build sem otimização (NDEBUG não definido)" << endl;
+#endif
+
+    BenchRunner bench(argc, argv);
+    BenchRunner::printHeader();
+
+    // ==== OBJ / MTL ====
+    for (const fs::path& obj : listarArquivos(assets, ".obj")) {
+        string nome = nomeRelativo(obj, assets);
+        string dir = obj.parent_path().string();
+        bench.run("obj_parse/" + nome, [&]() {
+            ObjData data;
+            parseOBJ(obj.string(), dir, data);
+            benchKeep(data.positions.size());
+        });
+
+        ObjData data;
+        parseOBJ(obj.string(), dir, data);
+        bench.run("obj_assemble/" + nome, [&]() {
+            vector<MeshPart> parts;
+            assembleMeshParts(data, parts);
+            benchKeep(parts.size());
+        });
+    }
+    for (const fs::path& mtl : listarArquivos(assets, ".mtl")) {
+        bench.run("mtl_parse/" + nomeRelativo(mtl, assets), [&]() {
+            ObjData data;
+            parseMTL(mtl.string(), data);
+            benchKeep(data.materials.size());
+        });
+    }
+
+    // ==== TEXTURAS ====
+    for (const fs::path& png : listarArquivos(assets, ".png")) {
+        bench.run("stbi_load/" + nomeRelativo(png, assets), [&]() {
+            int w, h, c;
+            unsigned char* pixels = stbi_load(png.string().c_str(), &w, &h, &c, 0);
+            benchKeep(pixels);
+            stbi_image_free(pixels);
+        });
+    }
+
+    // ==== CÂMERA ====
+    const int LOTE = 1000;
+    Camera camera(glm::vec3(0.0f, 1.5f, 10.0f));
+    bench.run("camera/Rotate", [&]() {
+        for (int i = 0; i < LOTE; i++)
+            camera.Rotate((i & 1) ? 3.0f : -3.0f, (i & 2) ? 1.5f : -1.5f);
+        benchKeep(camera.front);
+    }, LOTE);
+    bench.run("camera/GetViewMatrix", [&]() {
+        glm::vec4 acc(0.0f);
+        for (int i = 0; i < LOTE; i++) {
+            camera.position.x = (float)i;
+            acc += camera.GetViewMatrix()[3];
+        }
+        benchKeep(acc);
+    }, LOTE);
+
+    // ==== CONFIG ====
+    preencherConfig();
+    bench.run("config/getFloat", [&]() {
+        float acc = 0.0f;
+        for (int i = 0; i < LOTE; i++)
+            acc += getFloat((i & 1) ? "alturas.abducao" : "luzes.raio", 0.0f);
+        benchKeep(acc);
+    }, LOTE);
+    bench.run("config/getFloat_ausente", [&]() {
+        float acc = 0.0f;
+        for (int i = 0; i < LOTE; i++)
+            acc += getFloat("sombra.resolucao", 1024.0f);
+        benchKeep(acc);
+    }, LOTE);
+    bench.run("config/getVec3", [&]() {
+        glm::vec3 acc(0.0f);
+        for (int i = 0; i < LOTE; i++)
+            acc += getVec3((i & 1) ? "luz_casa.kd" : "luz_ovni.ka", glm::vec3(0.0f));
+        benchKeep(acc);
+    }, LOTE);
+    bench.run("config/getString", [&]() {
+        size_t acc = 0;
+        for (int i = 0; i < LOTE; i++)
+            acc += getString("window.title", "").size();
+        benchKeep(acc);
+    }, LOTE);
+    bench.run("config/parseSettings", [&]() {
+        Settings s;
+        SettingsReport r = parseSettings(config, s);
+        benchKeep(s.luzCasa.kd);
+        benchKeep(r.unknown.size());
+    });
+    // O que o laço da CenaFinal faz por frame: refresh() + materiais da luz
+    publishSettings(std::make_shared<const Settings>());
+    SettingsSnapshot snapshot;
+    bench.run("config/snapshot_frame", [&]() {
+        glm::vec3 acc(0.0f);
+        for (int i = 0; i < LOTE; i++) {
+            snapshot.refresh();
+            const Settings::LightMaterial& m = (i & 1) ? snapshot->luzCasa : snapshot->luzOvni;
+            acc += m.ka + m.kd + m.ks;
+        }
+        benchKeep(acc);
+    }, LOTE);
+
+    // Clips da abdução: os mesmos da CenaFinal, para o rebanho e anim/*
+    AnimationLibrary animacoes;
+    if (!animacoes.load((assets / ".." / "Animacoes" / "abducao.anim").string()))
+        return 1;
+    AbductionClips clipsAbducao;
+    clipsAbducao.resolve(animacoes);
+
+    // ==== REBANHO ====
+    // Uma operação = uma entidade (vaca ou ovni) atualizada
+    for (int vacas : { 1000, 10000, 100000 }) {
+        Herd herd;
+        herd.init(vacas, vacas / 10, 2.0f, glm::vec3(0.0f), animacoes);
+        int entidades = vacas + vacas / 10;
+        bench.run("herd/step_" + to_string(vacas), [&]() {
+            herd.step(1.0f / 120.0f);
+            benchKeep(herd.stats().steps);
+        }, entidades);
+        bench.run("herd/matrices_" + to_string(vacas), [&]() {
+            herd.buildMatrices(0.5f);
+            benchKeep(herd.cowModels()[0]);
+        }, entidades);
+    }
+
+    // ==== ANIMAÇÃO ====
+    // Uma operação = uma trilha amostrada (advance + evaluate de todas as instâncias)
+    {
+        const int INSTANCIAS = 25000, CHAVES = 256;
+        const float DT = 1.0f / 120.0f;
+        // Dois clips sintéticos em loop com 4 trilhas (float, float, vec3, quat) de CHAVES keyframes
+        string texto;
+        for (int c = 0; c < 2; c++) {
+            texto += "clip ciclo" + to_string(c) + " loop\n";
+            const char* trilhas[] = { "a float", "b float", "c vec3", "d quat" };
+            for (int k = 0; k < 4; k++) {
+                texto += string("trilha ") + trilhas[k] + "\n";
+                for (int j = 0; j < CHAVES; j++) {
+                    string v = to_string(sin(j * 0.37f + k));
+                    texto += to_string(j * (0.05f + 0.01f * c));
+                    if (k < 2)
+                        texto += " " + v + "\n";
+                    else if (k == 2)
+                        texto += " " + v + " 1 -" + v + "\n";
+                    else
+                        texto += " 0 1 0 " + v + "*180\n"; // quat: eixo Y, ângulo em graus
+                }
+            }
+        }
+        AnimationLibrary sintetica;
+        istringstream entrada(texto);
+        sintetica.parse(entrada, {}, "cg_bench");
+
+        // Fases espalhadas pelo ciclo: as instâncias não amostram o mesmo segmento
+        auto iniciar = [&](AnimationBatch& lote, const AnimationLibrary& lib, bool misto) {
+            lote.init(lib, INSTANCIAS);
+            for (int i = 0; i < INSTANCIAS; i++) {
+                int clip = misto ? i % 2 : 0;
+                lote.play(i, clip, (i * 0.618034f - floor(i * 0.618034f)) * lib.clip(clip).duration);
+            }
+            lote.advance(0.0f);
+            lote.evaluate();
+        };
+        AnimationBatch umClip, misto;
+        iniciar(umClip, sintetica, false);
+        iniciar(misto, sintetica, true);
+        bench.run("anim/ciclo_25000x4_cursor", [&]() {
+            umClip.advance(DT);
+            umClip.evaluate();
+            benchKeep(umClip.quats(0)[0]);
+        }, INSTANCIAS * 4);
+        bench.run("anim/ciclo_25000x4_misto", [&]() {
+            misto.advance(DT);
+            misto.evaluate();
+            benchKeep(misto.quats(0)[0]);
+        }, INSTANCIAS * 4);
+
+        // Mesmo trabalho sem cursor guardado: cada amostra busca o segmento desde o início
+        const AnimationClip& ciclo = sintetica.clip(0);
+        vector<float> tempos(INSTANCIAS), saidaA(INSTANCIAS), saidaB(INSTANCIAS);
+        vector<glm::vec3> saidaC(INSTANCIAS);
+        vector<glm::quat> saidaD(INSTANCIAS);
+        for (int i = 0; i < INSTANCIAS; i++)
+            tempos[i] = umClip.clipTime(i);
+        bench.run("anim/ciclo_25000x4_busca", [&]() {
+            for (int i = 0; i < INSTANCIAS; i++) {
+                tempos[i] = fmod(tempos[i] + DT, ciclo.duration);
+                uint32_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+                saidaA[i] = ciclo.floats[0].sample(tempos[i], c0);
+                saidaB[i] = ciclo.floats[1].sample(tempos[i], c1);
+                saidaC[i] = ciclo.vec3s[0].sample(tempos[i], c2);
+                saidaD[i] = ciclo.quats[0].sample(tempos[i], c3);
+            }
+            benchKeep(saidaD[0]);
+        }, INSTANCIAS * 4);
+
+        // Clips da abdução: um terço de cada, trocando de clip como o rebanho
+        AnimationBatch abducao;
+        abducao.init(animacoes, INSTANCIAS);
+        const int clips[] = { clipsAbducao.abduct, clipsAbducao.hover, clipsAbducao.release };
+        size_t trilhas = 0;
+        for (int i = 0; i < INSTANCIAS; i++) {
+            abducao.play(i, clips[i % 3], (i % 97) * 0.03f);
+            trilhas += animacoes.clip(clips[i % 3]).trackCount();
+        }
+        int quadro = 0;
+        bench.run("anim/abducao_25000", [&]() {
+            // A cada 2 s simulados, as instâncias pairando caem e as paradas voltam a subir
+            if (++quadro % 240 == 0) {
+                for (int i = 0; i < INSTANCIAS; i++) {
+                    if (abducao.clip(i) == clipsAbducao.hover)
+                        abducao.play(i, clipsAbducao.release);
+                    else if (abducao.clip(i) == clipsAbducao.release)
+                        abducao.play(i, clipsAbducao.abduct);
+                }
+            }
+            abducao.advance(DT);
+            abducao.evaluate();
+            benchKeep(abducao.floats(clipsAbducao.cowY)[0]);
+        }, (int)trilhas);
+    }
+
+    // ==== TRAJETÓRIAS ====
+    {
+        const int PONTOS = 100000, OBJETOS = 10000;
+        const float DT = 1.0f / 120.0f;
+        // Passeio aleatório com passos de tamanhos bem diferentes (o caso da spline centrípeta)
+        vector<glm::vec3> pontos(PONTOS);
+        uint32_t semente = 7u;
+        auto rnd = [&semente]() {
+            semente = semente * 1664525u + 1013904223u;
+            return (semente >> 8) / 16777216.0f - 0.5f;
+        };
+        for (int i = 1; i < PONTOS; i++)
+            pontos[i] = pontos[i - 1] + glm::vec3(rnd(), rnd() * 0.2f, rnd()) * (i % 7 == 0 ? 8.0f : 1.0f);
+
+        // Uma operação = um ponto de controle
+        SplinePath caminho;
+        bench.run("path/build_100000", [&]() {
+            caminho.build(pontos, true);
+            benchKeep(caminho.length());
+        }, PONTOS);
+
+        // Uma operação = um objeto avançado; espalhados pelo caminho, velocidades diferentes
+        SplineFollowers objetos;
+        objetos.resize(OBJETOS);
+        for (int i = 0; i < OBJETOS; i++) {
+            objetos.distance[i] = caminho.length() * i / OBJETOS;
+            objetos.speed[i] = 1.0f + (i % 5);
+        }
+        objetos.update(caminho, 0.0f);
+        bench.run("path/follow_10000_cursor", [&]() {
+            objetos.update(caminho, DT);
+            benchKeep(objetos.position[0]);
+        }, OBJETOS);
+        vector<float> distancias = objetos.distance;
+        bench.run("path/follow_10000_busca", [&]() {
+            for (int i = 0; i < OBJETOS; i++) {
+                distancias[i] = caminho.wrap(distancias[i] + objetos.speed[i] * DT);
+                objetos.position[i] = caminho.position(distancias[i]);
+            }
+            benchKeep(objetos.position[0]);
+        }, OBJETOS);
+
+        // Velocidade constante: arco percorrido (20 subpassos) em passos iguais, nos primeiros 1000 pontos
+        if (bench.selected("path/arco")) {
+            vector<glm::vec3> trecho(pontos.begin(), pontos.begin() + 1000);
+            SplinePath curto;
+            curto.build(trecho, true);
+            uint32_t cursor = SplinePath::NO_CURSOR;
+            const float PASSO = 0.01f;
+            glm::vec3 anterior = curto.position(0.0f, cursor);
+            int passos = 0, fora = 0;
+            for (float s = PASSO; s < curto.length(); s += PASSO) {
+                float arco = 0.0f;
+                for (int k = 1; k <= 20; k++) {
+                    glm::vec3 p = curto.position(s - PASSO + PASSO * k / 20, cursor);
+                    arco += glm::length(p - anterior);
+                    anterior = p;
+                }
+                fora += fabs(arco / PASSO - 1.0f) > 0.05f;
+                passos++;
+            }
+            printf("    %-36s %.2f%% dos passos fora de ±5%% da velocidade\n", "path/arco", 100.0 * fora / passos);
+        }
+    }
+
+    // ==== PARTÍCULAS ====
+    // Uma operação = uma partícula integrada (vivas e mortas: o laço SIMD passa por todas);
+    // antes, 3 s simulados para a emissão encher o raio até o regime
+    {
+        const int PARTICULAS = 1000000;
+        const float DT = 1.0f / 120.0f;
+        BeamEmitter raio;
+        raio.height = 5.5f;
+        raio.rate = PARTICULAS / (0.5f * (raio.minLife + raio.maxLife));
+        int maxThreads = max(1, JobSystem::global().threadCount());
+        vector<int> contagens = { 1 };
+        if (maxThreads > 1)
+            contagens.push_back(maxThreads);
+        for (int threads : contagens) {
+            string nome = "particles/cpu_1000000_" + to_string(threads) + "t";
+            if (!bench.selected(nome))
+                continue;
+            CpuParticles particulas;
+            particulas.init(PARTICULAS, threads);
+            for (int i = 0; i < 360; i++)
+                particulas.update(raio, DT);
+            bench.run(nome, [&]() {
+                particulas.update(raio, DT);
+                benchKeep(particulas.data()[0]);
+            }, (int)particulas.capacity());
+            printf("    %-36s %zu vivas em regime\n", nome.c_str(), particulas.aliveCount());
+        }
+    }
+
+    // ==== TRANSFORMAÇÕES EM LOTE ====
+    // Objetos com posição, eixo/ângulo e escala (não uniforme) pseudoaleatórios; referência pelo glm
+    const int OBJETOS = 10000;
+    TransformSoA transformacoes;
+    transformacoes.resize(OBJETOS);
+    vector<glm::mat4> refModel(OBJETOS), refMvp(OBJETOS), escalaMvp(OBJETOS);
+    vector<glm::mat3> refNormal(OBJETOS);
+    glm::mat4 viewProj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 200.0f) *
+                          glm::lookAt(glm::vec3(3.0f, 8.0f, 15.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    uint32_t semente = 7u;
+    auto aleatorio = [&semente](float a, float b) {
+        semente = semente * 1664525u + 1013904223u;
+        return a + (b - a) * ((semente >> 8) / 16777216.0f);
+    };
+    for (int i = 0; i < OBJETOS; i++) {
+        glm::vec3 pos(aleatorio(-50, 50), aleatorio(0, 20), aleatorio(-50, 50));
+        glm::vec3 eixo = glm::normalize(glm::vec3(aleatorio(-1, 1), aleatorio(-1, 1), aleatorio(-1, 1)) + glm::vec3(0.0f, 0.01f, 0.0f));
+        float angulo = aleatorio(-3.14159f, 3.14159f);
+        glm::vec3 escala(aleatorio(0.5f, 2.0f), aleatorio(0.5f, 2.0f), aleatorio(0.5f, 2.0f));
+        transformacoes.setPosition(i, pos);
+        transformacoes.setRotation(i, axisAngleQuat(angulo, eixo));
+        transformacoes.setScale(i, escala);
+        refModel[i] = glm::translate(glm::mat4(1.0f), pos) * glm::rotate(glm::mat4(1.0f), angulo, eixo) * glm::scale(glm::mat4(1.0f), escala);
+        refMvp[i] = viewProj * refModel[i];
+        // |VP| * |M|: tamanho dos termos somados em cada componente do mvp
+        for (int c = 0; c < 4; c++)
+            for (int r = 0; r < 4; r++) {
+                float soma = 0.0f;
+                for (int k = 0; k < 4; k++)
+                    soma += fabs(viewProj[k][r]) * fabs(refModel[i][c][k]);
+                escalaMvp[i][c][r] = soma;
+            }
+        refNormal[i] = glm::transpose(glm::inverse(glm::mat3(refModel[i])));
+    }
+    // Diferença em ulps da maior componente da coluna de 'escala' (as somas cancelam: ulp do próprio valor
+    // não serve); no mvp a escala é |VP| * |M|
+    auto erroUlps = [](const float* a, const float* b, const float* escala, int colunas, int linhas) {
+        double pior = 0.0;
+        for (int c = 0; c < colunas; c++) {
+            float maior = 0.0f;
+            for (int r = 0; r < linhas; r++)
+                maior = max(maior, fabs(escala[c * linhas + r]));
+            double ulp = max((double)maior, 1e-30) * FLT_EPSILON;
+            for (int r = 0; r < linhas; r++)
+                pior = max(pior, fabs((double)a[c * linhas + r] - b[c * linhas + r]) / ulp);
+        }
+        return pior;
+    };
+    vector<glm::mat4> saidaModel(OBJETOS), saidaMvp(OBJETOS), escalarModel(OBJETOS), escalarMvp(OBJETOS);
+    vector<glm::mat3> saidaNormal(OBJETOS), escalarNormal(OBJETOS);
+    // Contra o glm a diferença vem da fórmula (meio ângulo do quaternion, inversa genérica); entre kernels não há
+    // diferença: fazem as mesmas contas na mesma ordem, sem FMA
+    const double TOLERANCIA_GLM = 16.0, TOLERANCIA_KERNEL = 0.0;
+    bool transformOk = true;
+    for (TransformKernel k : { TransformKernel::Scalar, TransformKernel::Sse, TransformKernel::Avx2 }) {
+        string prefixo = string("transform/") + transformKernelName(k);
+        if (!transformKernelSupported(k)) {
+            if (bench.selected(prefixo))
+                printf("    %-36s sem suporte nesta CPU\n", prefixo.c_str());
+            continue;
+        }
+        TransformOutputs todas;
+        todas.model = saidaModel.data();
+        todas.mvp = saidaMvp.data();
+        todas.normal = saidaNormal.data();
+        todas.viewProj = viewProj;
+        if (bench.selected(prefixo)) {
+            transformBatch(transformacoes, 0, OBJETOS, todas, k);
+            if (k == TransformKernel::Scalar) {
+                escalarModel = saidaModel;
+                escalarMvp = saidaMvp;
+                escalarNormal = saidaNormal;
+            }
+            double eModel = 0.0, eMvp = 0.0, eNormal = 0.0, eKernel = 0.0;
+            for (int i = 0; i < OBJETOS; i++) {
+                const float *model = &refModel[i][0][0], *mvp = &escalaMvp[i][0][0], *normal = &refNormal[i][0][0];
+                eModel = max(eModel, erroUlps(&saidaModel[i][0][0], model, model, 4, 4));
+                eMvp = max(eMvp, erroUlps(&saidaMvp[i][0][0], &refMvp[i][0][0], mvp, 4, 4));
+                eNormal = max(eNormal, erroUlps(&saidaNormal[i][0][0], normal, normal, 3, 3));
+                eKernel = max({ eKernel, erroUlps(&saidaModel[i][0][0], &escalarModel[i][0][0], model, 4, 4),
+                                erroUlps(&saidaMvp[i][0][0], &escalarMvp[i][0][0], mvp, 4, 4),
+                                erroUlps(&saidaNormal[i][0][0], &escalarNormal[i][0][0], normal, 3, 3) });
+            }
+            bool ok = max({ eModel, eMvp, eNormal }) <= TOLERANCIA_GLM && eKernel <= TOLERANCIA_KERNEL;
+            transformOk = transformOk && ok;
+            printf("    %-36s erro máx vs glm: model %.1f, mvp %.1f, normal %.1f ulps; vs escalar %.1f ulps%s\n",
+                   prefixo.c_str(), eModel, eMvp, eNormal, eKernel, ok ? "" : "  << FALHOU");
+        }
+        TransformOutputs soModel;
+        soModel.model = saidaModel.data();
+        // Uma operação = um objeto
+        for (int caso = 0; caso < 2; caso++) {
+            string nome = prefixo + (caso == 0 ? "_model" : "_model_mvp_normal");
+            const TransformOutputs& saidas = caso == 0 ? soModel : todas;
+            bench.run(nome, [&]() {
+                transformBatch(transformacoes, 0, OBJETOS, saidas, k);
+                benchKeep(saidaModel[0]);
+            }, OBJETOS);
+            int matrizes = caso == 0 ? 1 : 3;
+            if (bench.selected(nome))
+                printf("    %-36s %.1f M matrizes/s\n", nome.c_str(), matrizes * 1e3 / bench.all().back().medianNs);
+        }
+    }
+
+    // ==== GRAFO DE CENA ====
+    // Uma operação = um nó recalculado (a contagem vem do próprio update)
+    {
+        const int NOS = 10000;
+        glm::mat4 passo = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.1f, 0.0f)) *
+                          glm::rotate(glm::mat4(1.0f), 0.01f, glm::vec3(0.0f, 1.0f, 0.0f));
+        SceneGraph profundo, largo;
+        profundo.addNode("raiz");
+        largo.addNode("raiz");
+        for (int i = 1; i < NOS; i++) {
+            profundo.addNode("no", i - 1, passo);
+            largo.addNode("no", 0, passo);
+        }
+        profundo.update();
+        largo.update();
+        float angulo = 0.0f;
+        auto sujarEAtualizar = [&](SceneGraph& g, const vector<int>& nos) {
+            angulo += 0.001f;
+            for (int no : nos)
+                g.setLocal(no, glm::rotate(passo, angulo, glm::vec3(0.0f, 0.0f, 1.0f)));
+            g.update();
+            benchKeep(g.world(g.size() - 1));
+        };
+        vector<int> pct;
+        for (int i = 1; i < NOS; i += 100)
+            pct.push_back(i);
+        struct Caso {
+            string nome;
+            SceneGraph* grafo;
+            vector<int> nos;
+        };
+        vector<Caso> casos = {
+            { "scene/deep_10000_root", &profundo, { 0 } },
+            { "scene/deep_10000_leaf", &profundo, { NOS - 1 } },
+            { "scene/wide_10000_root", &largo, { 0 } },
+            { "scene/wide_10000_leaf", &largo, { NOS - 1 } },
+            { "scene/wide_10000_1pct", &largo, pct },
+        };
+        for (Caso& c : casos) {
+            sujarEAtualizar(*c.grafo, c.nos);
+            bench.run(c.nome, [&]() { sujarEAtualizar(*c.grafo, c.nos); }, max(1, c.grafo->lastUpdated()));
+        }
+    }
+
+    // ==== JOBS ====
+    // Estatísticas do pool acumuladas no caso (aquecimento incluído), por chamada de 'body'
+    auto imprimirJobs = [&](const string& nome, const JobSystem& js, size_t chamadas) {
+        JobStats s = js.stats();
+        double n = (double)max<size_t>(chamadas, 1);
+        printf("    %-32s jobs %.1f, roubados %.1f, contenção %.2f, ajudados %.1f, sonecas %.2f (por chamada)\n",
+               nome.c_str(), s.executed / n, s.stolen / n, s.contention / n, s.helped / n, s.sleeps / n);
+    };
+
+    // Uma operação = um job: run() na deque da thread dona + wait() que executa ele mesmo
+    {
+        JobSystem js(1);
+        size_t chamadas = 0;
+        bench.run("jobs/run_wait_empty", [&]() {
+            JobCounter grupo;
+            for (int i = 0; i < LOTE; i++)
+                js.run([] {}, &grupo);
+            js.wait(grupo);
+            chamadas++;
+        }, LOTE);
+        if (bench.selected("jobs/run_wait_empty"))
+            imprimirJobs("jobs/run_wait_empty", js, chamadas);
+    }
+
+    // Uma operação = um elemento; grão grosso (poucos jobs) e fino (muitos, mais disputa)
+    vector<float> dados(1 << 20);
+    for (size_t i = 0; i < dados.size(); i++)
+        dados[i] = (float)i;
+    int maxThreads = max(1, (int)thread::hardware_concurrency());
+    vector<int> contagens;
+    for (int t = 1; t < maxThreads; t *= 2)
+        contagens.push_back(t);
+    contagens.push_back(maxThreads);
+    for (int threads : contagens) {
+        JobSystem js(threads - 1);
+        for (int grao : { 16384, 256 }) {
+            string nome = "jobs/parallel_for_" + to_string(threads) + "t_grain" + to_string(grao);
+            js.resetStats();
+            size_t chamadas = 0;
+            bench.run(nome, [&]() {
+                js.parallelFor((int)dados.size(), grao, [&](int inicio, int fim) {
+                    for (int i = inicio; i < fim; i++)
+                        dados[i] = sqrt(dados[i] * 1.0001f + 1.0f);
+                }, (int)dados.size() / grao);
+                benchKeep(dados[0]);
+                chamadas++;
+            }, (int)dados.size());
+            if (bench.selected(nome))
+                imprimirJobs(nome, js, chamadas);
+        }
+    }
+
+    return bench.finish() && transformOk ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// ============== CG_RAYTRACE ==============
+// Renderiza na CPU (RayTracer.h) as cenas da CenaFinal e do Phong por ray
+// tracing, com raios de sombra até a luz, e mede:
+//   - construção da BVH (ms, nós, folhas, profundidade);
+//   - raios por segundo (primários + sombra) com N threads;
+//   - escalonamento com 1, 2, 4, ... threads, conferindo que a imagem é
+//     idêntica em todas (hash do framebuffer);
+//   - diferença contra uma imagem de referência gerada pelo GL (llvmpipe).
+//
+// As sombras do ray tracer são duras (um raio por ponto); a CenaFinal em GL
+// usa shadow map com PCF. Para comparar pixel a pixel, gere a referência com
+// [sombra] ativa=false e rode com --sem-sombra:
+//   ./CenaFinal --headless --frames 1 --dt 0.000001 --dump ref     (de build/)
+//   ./cg_raytrace --sem-sombra --referencia ref/frame_00001.png --diff diff.png
+// Stills: --spp 16 usa uma grade de 4x4 amostras por pixel.
+//
+// Uso: cg_raytrace [--cena cenafinal|phong] [--assets DIR] [--largura W] [--altura H]
+//                  [--threads N] [--spp N] [--sem-sombra] [--frames N] [--tempo T]
+//                  [--escala] [--saida PNG] [--referencia PNG] [--diff PNG]
+// Compile com -mavx (ou -march=native) para os pacotes de 8 raios em AVX.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <RayTracer.h>
+#include "CenaCpu.h"
+
+using namespace std;
+
+// Mediana de 'frames' renderizações, em ms
+double medir(RayTracer& rt, int largura, int altura, int threads, int frames, vector<uint32_t>& pixels) {
+    vector<double> tempos;
+    for (int i = 0; i < frames; i++) {
+        rt.render(largura, altura, threads, pixels);
+        tempos.push_back(rt.stats().renderMs);
+    }
+    sort(tempos.begin(), tempos.end());
+    return tempos[tempos.size() / 2];
+}
+
+int main(int argc, char** argv) {
+    string cenaNome = "cenafinal", assets = "../assets", saida, referencia, diffPath;
+    int largura = 800, altura = 600, threads = 0, frames = 3, spp = 1;
+    float tempo = 0.0f;
+    bool escala = false, sombras = true;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool temValor = i + 1 < argc;
+        if (arg == "--cena" && temValor) cenaNome = argv[++i];
+        else if (arg == "--assets" && temValor) assets = argv[++i];
+        else if (arg == "--largura" && temValor) largura = atoi(argv[++i]);
+        else if (arg == "--altura" && temValor) altura = atoi(argv[++i]);
+        else if (arg == "--threads" && temValor) threads = atoi(argv[++i]);
+        else if (arg == "--spp" && temValor) spp = max(1, atoi(argv[++i]));
+        else if (arg == "--frames" && temValor) frames = max(1, atoi(argv[++i]));
+        else if (arg == "--tempo" && temValor) tempo = (float)atof(argv[++i]);
+        else if (arg == "--saida" && temValor) saida = argv[++i];
+        else if (arg == "--referencia" && temValor) referencia = argv[++i];
+        else if (arg == "--diff" && temValor) diffPath = argv[++i];
+        else if (arg == "--sem-sombra") sombras = false;
+        else if (arg == "--escala") escala = true;
+    }
+#ifndef NDEBUG
+    cout << "[raytrace] aviso: build sem otimização (NDEBUG não definido)" << endl;
+#endif
+
+    loadConfig("config.ini");
+    Cena cena;
+    if (!montarCena(cenaNome, assets, tempo, largura, altura, cena))
+        return 1;
+
+    // Amostras em grade N x N: arredonda --spp para o quadrado mais próximo
+    int porEixo = max(1, (int)lround(sqrt((double)spp)));
+    int maximo = (int)max(1u, thread::hardware_concurrency());
+    int nThreads = threads > 0 ? threads : maximo;
+
+    RayTracer rt;
+    for (const Objeto& o : cena.objetos)
+        for (const Parte& p : o.partes)
+            rt.addMesh(p.vertices, o.model, p.material);
+    rt.build(nThreads);
+    rt.setCamera(cena.view, cena.proj, cena.viewPos);
+    rt.setLight(cena.luz);
+    rt.setBackground(cena.corFundo, cena.fundo);
+    rt.setShadows(sombras);
+    rt.setSamplesPerAxis(porEixo);
+#if defined(RAYTRACER_AVX)
+    const char* simd = "AVX";
+#elif defined(RAYTRACER_SSE)
+    const char* simd = "2x SSE";
+#else
+    const char* simd = "escalar";
+#endif
+
+    const RayTracerStats& st = rt.stats();
+    printf("[raytrace] %s %dx%d, %d threads, pacotes de 8 raios (%s), %d spp, sombras %s\n", cenaNome.c_str(), largura,
+           altura, nThreads, simd, porEixo * porEixo, sombras ? "sim" : "não");
+    printf("[raytrace] BVH: %d triângulos, %d nós, %d folhas, profundidade %d, %d tarefas, %.2f ms\n", st.triangles,
+           st.nodes, st.leaves, st.maxDepth, st.buildTasks, st.buildMs);
+
+    vector<uint32_t> pixels;
+    double ms = medir(rt, largura, altura, nThreads, frames, pixels);
+    uint64_t hash = hashImagem(pixels);
+    uint64_t raios = st.primaryRays + st.shadowRays;
+    printf("[raytrace] mediana de %d frames: %.2f ms, %llu primários + %llu de sombra = %.2f Mraios/s, hash %016llx\n",
+           frames, ms, (unsigned long long)st.primaryRays, (unsigned long long)st.shadowRays, raios / (ms * 1000.0),
+           (unsigned long long)hash);
+
+    // ==== ESCALONAMENTO ====
+    if (escala) {
+        double base = 0.0;
+        bool deterministico = true;
+        vector<uint32_t> outros;
+        printf("%8s %12s %12s %10s  %s\n", "threads", "ms", "Mraios/s", "speedup", "hash");
+        for (int n : contagensDeThreads(maximo)) {
+            double tn = medir(rt, largura, altura, n, frames, outros);
+            uint64_t hn = hashImagem(outros);
+            if (n == 1)
+                base = tn;
+            deterministico = deterministico && hn == hash;
+            printf("%8d %12.2f %12.2f %9.2fx  %016llx%s\n", n, tn, raios / (tn * 1000.0), base / tn,
+                   (unsigned long long)hn, hn == hash ? "" : "  (DIFERENTE)");
+        }
+        printf("[raytrace] imagem %s entre as contagens de threads\n", deterministico ? "idêntica" : "DIFERENTE");
+        if (!deterministico)
+            return 1;
+    }
+
+    vector<unsigned char> rgb = paraRGB(pixels, largura, altura);
+    if (!saida.empty() && !gravarPNG(saida, rgb, largura, altura, "[raytrace]"))
+        return 1;
+    if (!referencia.empty() && !compararImagem(rgb, largura, altura, referencia, diffPath, "[raytrace]"))
+        return 1;
+    return 0;
+}
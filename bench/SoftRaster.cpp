@@ -0,0 +1,149 @@
+// ============== CG_SOFTRASTER ==============
+// Desenha na CPU (SoftwareRasterizer.h) as cenas da CenaFinal e do Phong, sem
+// janela nem driver GL, e mede:
+//   - tempo por frame (setup + rasterização) com N threads;
+//   - escalonamento com 1, 2, 4, ... threads, conferindo que a imagem é
+//     idêntica em todas (hash do framebuffer);
+//   - diferença contra uma imagem de referência gerada pelo GL (llvmpipe).
+//
+// Cenas (CenaCpu.h): cenafinal (sem shadow map: gere a referência com
+// [sombra] ativa=false) e phong (Cube.obj girado pelo ângulo --tempo).
+//
+// Referência da CenaFinal (de build/):
+//   ./CenaFinal --headless --frames 1 --dt 0.000001 --dump ref     (com sombra.ativa=false)
+//   ./cg_softraster --referencia ref/frame_00001.png --saida soft.png --diff diff.png
+//
+// Uso: cg_softraster [--cena cenafinal|phong] [--assets DIR] [--largura W] [--altura H]
+//                    [--threads N] [--frames N] [--tempo T] [--escala]
+//                    [--saida PNG] [--referencia PNG] [--diff PNG]
+// Compile com -mavx (ou -march=native) para o caminho AVX das funções de aresta.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <SoftwareRasterizer.h>
+#include "CenaCpu.h"
+
+using namespace std;
+
+void desenhar(SoftRasterizer& raster, const Cena& cena) {
+    raster.begin(cena.corFundo, cena.fundo);
+    raster.setCamera(cena.view, cena.proj, cena.viewPos);
+    raster.setLight(cena.luz);
+    for (const Objeto& o : cena.objetos)
+        for (const Parte& p : o.partes)
+            raster.draw(p.vertices, o.model, p.material);
+    raster.finish();
+}
+
+// Mediana de 'frames' execuções (setup, rasterização, total) em ms
+struct Tempo {
+    double setup, raster, total;
+};
+
+Tempo medir(SoftRasterizer& raster, const Cena& cena, int frames) {
+    desenhar(raster, cena); // aquecimento (bins, vetores)
+    vector<double> setup, rast, total;
+    for (int i = 0; i < frames; i++) {
+        auto t0 = chrono::steady_clock::now();
+        desenhar(raster, cena);
+        total.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+        setup.push_back(raster.stats().setupMs);
+        rast.push_back(raster.stats().rasterMs);
+    }
+    auto mediana = [](vector<double>& v) {
+        sort(v.begin(), v.end());
+        return v[v.size() / 2];
+    };
+    return { mediana(setup), mediana(rast), mediana(total) };
+}
+
+int main(int argc, char** argv) {
+    string cenaNome = "cenafinal", assets = "../assets", saida, referencia, diffPath;
+    int largura = 800, altura = 600, threads = 0, frames = 10;
+    float tempo = 0.0f;
+    bool escala = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool temValor = i + 1 < argc;
+        if (arg == "--cena" && temValor) cenaNome = argv[++i];
+        else if (arg == "--assets" && temValor) assets = argv[++i];
+        else if (arg == "--largura" && temValor) largura = atoi(argv[++i]);
+        else if (arg == "--altura" && temValor) altura = atoi(argv[++i]);
+        else if (arg == "--threads" && temValor) threads = atoi(argv[++i]);
+        else if (arg == "--frames" && temValor) frames = max(1, atoi(argv[++i]));
+        else if (arg == "--tempo" && temValor) tempo = (float)atof(argv[++i]);
+        else if (arg == "--saida" && temValor) saida = argv[++i];
+        else if (arg == "--referencia" && temValor) referencia = argv[++i];
+        else if (arg == "--diff" && temValor) diffPath = argv[++i];
+        else if (arg == "--escala") escala = true;
+    }
+#ifndef NDEBUG
+    cout << "[softraster] aviso: build sem otimização (NDEBUG não definido)" << endl;
+#endif
+
+    loadConfig("config.ini");
+    Cena cena;
+    if (!montarCena(cenaNome, assets, tempo, largura, altura, cena))
+        return 1;
+
+    SoftRasterizer raster;
+    raster.resize(largura, altura);
+    raster.setThreads(threads);
+#if defined(SOFTRAST_AVX)
+    const char* simd = "AVX";
+#elif defined(SOFTRAST_SSE)
+    const char* simd = "SSE";
+#else
+    const char* simd = "escalar";
+#endif
+
+    Tempo t = medir(raster, cena, frames);
+    const SoftRasterStats& st = raster.stats();
+    uint64_t hash = hashImagem(raster.pixels());
+    printf("[softraster] %s %dx%d, %d threads, %s, tiles de %d px\n", cenaNome.c_str(), largura, altura, raster.threads(),
+           simd, SoftRasterizer::TILE);
+    printf("[softraster] %d draws, %d triângulos (%d após recorte), %d entradas nos bins\n", st.drawCalls, st.triangles,
+           st.setupTriangles, st.binEntries);
+    printf("[softraster] mediana de %d frames: setup %.2f ms, rasterização %.2f ms, total %.2f ms (%.1f fps), hash %016llx\n",
+           frames, t.setup, t.raster, t.total, 1000.0 / t.total, (unsigned long long)hash);
+
+    // ==== ESCALONAMENTO ====
+    if (escala) {
+        int maximo = (int)max(1u, thread::hardware_concurrency());
+        double base = 0.0;
+        bool deterministico = true;
+        printf("%8s %12s %12s %10s  %s\n", "threads", "raster ms", "total ms", "speedup", "hash");
+        for (int n : contagensDeThreads(maximo)) {
+            raster.setThreads(n);
+            Tempo tn = medir(raster, cena, frames);
+            uint64_t hn = hashImagem(raster.pixels());
+            if (n == 1)
+                base = tn.raster;
+            deterministico = deterministico && hn == hash;
+            printf("%8d %12.2f %12.2f %9.2fx  %016llx%s\n", n, tn.raster, tn.total, base / tn.raster,
+                   (unsigned long long)hn, hn == hash ? "" : "  (DIFERENTE)");
+        }
+        printf("[softraster] imagem %s entre as contagens de threads\n", deterministico ? "idêntica" : "DIFERENTE");
+        if (!deterministico)
+            return 1;
+    }
+
+    vector<unsigned char> rgb = paraRGB(raster.pixels(), largura, altura);
+    if (!saida.empty() && !gravarPNG(saida, rgb, largura, altura, "[softraster]"))
+        return 1;
+    if (!referencia.empty() && !compararImagem(rgb, largura, altura, referencia, diffPath, "[softraster]"))
+        return 1;
+    return 0;
+}
@@ -0,0 +1,618 @@
+#pragma once
+
+// ============== ANIMAÇÃO POR KEYFRAMES ==============
+// Clips de trilhas tipadas (float, vec3, quat) lidos de um arquivo de dados,
+// no lugar de ifs com velocidades e limites no laço principal:
+//   - cada trilha anima um canal com nome ("ovni.y", "vaca.rot"...); os
+//     canais são comuns a todos os clips, e a pose é um array por tipo;
+//   - amostrar guarda um cursor (keyframe à esquerda do último tempo): com
+//     o tempo andando para frente, achar o segmento custa O(1) amortizado;
+//     saltos longos e voltas (loop, troca de clip) usam busca binária;
+//   - um clip termina parado, em loop ou passando para o 'proximo';
+//   - 'sincronia CANAL': ao entrar no clip, o tempo inicial é o ponto em que
+//     a trilha daquele canal vale o mesmo que a pose atual (a vaca continua
+//     da altura em que estava, em vez de voltar ao começo);
+//   - AnimationPlayer toca uma instância e mistura a pose anterior durante
+//     'mistura' segundos depois de uma troca; AnimationBatch toca N
+//     instâncias em SoA (tempos, clips e cursores em arrays, uma trilha por
+//     vez sobre todas as instâncias que estão no clip dela).
+//
+// Formato do arquivo (um comando por linha, # comenta):
+//   param NOME EXPR             valor padrão de um parâmetro (quem carrega pode sobrescrever)
+//   clip NOME [loop]
+//   proximo CLIP                clip seguinte ao terminar (sem loop)
+//   sincronia CANAL             canal float que define o tempo de entrada
+//   mistura EXPR                segundos de transição vinda de outro clip
+//   trilha CANAL float|vec3|quat [linear|degrau]
+//   T V...                      keyframe: tempo e 1 valor (float), 3 (vec3) ou
+//                               eixo x y z + ângulo em graus (quat)
+// EXPR: números, parâmetros e + - * / ( ), sem espaços (ex.: abducao/vel).
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+enum class Interp { Step, Linear };
+enum class ChannelType { Float, Vec3, Quat };
+
+inline float interpolateKey(float a, float b, float t) { return a + (b - a) * t; }
+inline glm::vec3 interpolateKey(const glm::vec3& a, const glm::vec3& b, float t) { return glm::mix(a, b, t); }
+inline glm::quat interpolateKey(const glm::quat& a, const glm::quat& b, float t) { return glm::slerp(a, b, t); }
+
+template <typename T>
+struct Track {
+    int channel = -1; // índice do canal dentro do tipo
+    Interp interp = Interp::Linear;
+    std::vector<float> times; // não decrescentes
+    std::vector<T> values;
+
+    float duration() const { return times.empty() ? 0.0f : times.back(); }
+
+    // k com times[k] <= t < times[k+1] (0 antes do primeiro keyframe, n-1 depois do último)
+    uint32_t locate(float t, uint32_t cursor) const
+    {
+        uint32_t n = (uint32_t)times.size();
+        if (cursor >= n)
+            cursor = 0;
+        if (t < times[cursor]) {
+            auto it = std::upper_bound(times.begin(), times.begin() + cursor, t);
+            return it == times.begin() ? 0 : (uint32_t)(it - times.begin()) - 1;
+        }
+        // Para frente: poucos passos lineares, depois busca binária
+        for (int s = 0; s < 4; s++) {
+            if (cursor + 1 >= n || t < times[cursor + 1])
+                return cursor;
+            cursor++;
+        }
+        return (uint32_t)(std::upper_bound(times.begin() + cursor, times.end(), t) - times.begin()) - 1;
+    }
+
+    T sample(float t, uint32_t& cursor) const
+    {
+        uint32_t k = cursor = locate(t, cursor);
+        if (interp == Interp::Step || k + 1 >= times.size() || t <= times[k])
+            return values[k];
+        float a = (t - times[k]) / (times[k + 1] - times[k]);
+        return interpolateKey(values[k], values[k + 1], a);
+    }
+};
+
+// Primeiro tempo em que uma trilha float passa por 'value' (ou o keyframe de valor mais próximo)
+inline float trackTimeOf(const Track<float>& track, float value)
+{
+    const std::vector<float>& t = track.times;
+    const std::vector<float>& v = track.values;
+    for (size_t k = 0; k + 1 < t.size(); k++) {
+        float lo = std::min(v[k], v[k + 1]), hi = std::max(v[k], v[k + 1]);
+        if (value >= lo && value <= hi) {
+            if (v[k + 1] == v[k] || track.interp == Interp::Step)
+                return t[k];
+            return t[k] + (t[k + 1] - t[k]) * (value - v[k]) / (v[k + 1] - v[k]);
+        }
+    }
+    size_t best = 0;
+    for (size_t k = 1; k < v.size(); k++)
+        if (std::fabs(v[k] - value) < std::fabs(v[best] - value))
+            best = k;
+    return t.empty() ? 0.0f : t[best];
+}
+
+struct AnimationClip {
+    std::string name;
+    float duration = 0.0f; // maior fim de trilha
+    bool loop = false;
+    int next = -1;         // clip ao terminar
+    int syncChannel = -1;  // canal float da sincronia
+    float blend = 0.0f;    // segundos de mistura ao entrar
+    std::vector<Track<float>> floats;
+    std::vector<Track<glm::vec3>> vec3s;
+    std::vector<Track<glm::quat>> quats;
+
+    size_t trackCount() const { return floats.size() + vec3s.size() + quats.size(); }
+};
+
+// Valor de cada canal; canais sem trilha no clip atual ficam com o último valor
+struct AnimationPose {
+    std::vector<float> floats;
+    std::vector<glm::vec3> vec3s;
+    std::vector<glm::quat> quats;
+};
+
+class AnimationLibrary {
+public:
+    // 'params' sobrescreve os "param" do arquivo; false (com a mensagem em cerr) se algo não fizer sentido
+    bool load(const std::string& path, const std::map<std::string, float>& params = {})
+    {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "[animacao] não abriu " << path << std::endl;
+            return false;
+        }
+        return parse(file, params, path);
+    }
+
+    bool parse(std::istream& in, const std::map<std::string, float>& params, const std::string& source)
+    {
+        *this = AnimationLibrary();
+        std::map<std::string, float> vars;
+        std::vector<std::pair<int, std::string>> nexts; // resolvidos no fim: o clip pode vir depois
+        ChannelType trackType = ChannelType::Float;
+        int trackIndex = -1;
+        std::string line;
+        int lineNo = 0;
+        auto fail = [&](const std::string& msg) {
+            std::cerr << "[animacao] " << source << ":" << lineNo << ": " << msg << std::endl;
+            *this = AnimationLibrary();
+            return false;
+        };
+
+        while (std::getline(in, line)) {
+            lineNo++;
+            line = line.substr(0, line.find('#'));
+            std::istringstream ss(line);
+            std::vector<std::string> f;
+            for (std::string w; ss >> w;)
+                f.push_back(w);
+            if (f.empty())
+                continue;
+
+            if (f[0] == "param") {
+                float v;
+                if (f.size() != 3 || !evaluate(f[2], vars, v))
+                    return fail("param NOME EXPR");
+                auto given = params.find(f[1]);
+                vars[f[1]] = given != params.end() ? given->second : v;
+                continue;
+            }
+            if (f[0] == "clip") {
+                if (f.size() < 2 || clipIndex(f[1]) >= 0)
+                    return fail("clip sem nome ou repetido");
+                clips.emplace_back();
+                clips.back().name = f[1];
+                clips.back().loop = f.size() > 2 && f[2] == "loop";
+                trackIndex = -1;
+                continue;
+            }
+            if (clips.empty())
+                return fail("'" + f[0] + "' antes do primeiro clip");
+            AnimationClip& clip = clips.back();
+
+            if (f[0] == "proximo" && f.size() == 2) {
+                nexts.push_back({ (int)clips.size() - 1, f[1] });
+            } else if (f[0] == "sincronia" && f.size() == 2) {
+                clip.syncChannel = channel(f[1], ChannelType::Float);
+                if (clip.syncChannel < 0)
+                    return fail("canal '" + f[1] + "' não é float");
+            } else if (f[0] == "mistura" && f.size() == 2) {
+                if (!evaluate(f[1], vars, clip.blend))
+                    return fail("mistura EXPR");
+            } else if (f[0] == "trilha" && f.size() >= 3) {
+                ChannelType type;
+                if (f[2] == "float")
+                    type = ChannelType::Float;
+                else if (f[2] == "vec3")
+                    type = ChannelType::Vec3;
+                else if (f[2] == "quat")
+                    type = ChannelType::Quat;
+                else
+                    return fail("tipo '" + f[2] + "' (float, vec3 ou quat)");
+                Interp interp = f.size() > 3 && f[3] == "degrau" ? Interp::Step : Interp::Linear;
+                int ch = channel(f[1], type);
+                if (ch < 0)
+                    return fail("canal '" + f[1] + "' já existe com outro tipo");
+                trackType = type;
+                if (type == ChannelType::Float)
+                    trackIndex = addTrack(clip.floats, ch, interp);
+                else if (type == ChannelType::Vec3)
+                    trackIndex = addTrack(clip.vec3s, ch, interp);
+                else
+                    trackIndex = addTrack(clip.quats, ch, interp);
+            } else {
+                // Keyframe da trilha atual
+                std::vector<float> v(f.size());
+                for (size_t i = 0; i < f.size(); i++)
+                    if (!evaluate(f[i], vars, v[i]))
+                        return fail("expressão inválida '" + f[i] + "'");
+                if (trackIndex < 0)
+                    return fail("keyframe fora de uma trilha");
+                size_t expected = trackType == ChannelType::Float ? 2 : trackType == ChannelType::Vec3 ? 4 : 5;
+                if (v.size() != expected)
+                    return fail("keyframe com " + std::to_string(v.size() - 1) + " valores, esperado " +
+                                std::to_string(expected - 1));
+                bool ok = trackType == ChannelType::Float ? addKey(clip.floats[trackIndex], v[0], v[1])
+                          : trackType == ChannelType::Vec3
+                              ? addKey(clip.vec3s[trackIndex], v[0], glm::vec3(v[1], v[2], v[3]))
+                              : addKey(clip.quats[trackIndex], v[0],
+                                       glm::angleAxis(glm::radians(v[4]), glm::normalize(glm::vec3(v[1], v[2], v[3]))));
+                if (!ok)
+                    return fail("tempo do keyframe menor que o anterior");
+            }
+        }
+
+        for (const auto& n : nexts) {
+            clips[n.first].next = clipIndex(n.second);
+            if (clips[n.first].next < 0) {
+                lineNo = 0;
+                return fail("proximo '" + n.second + "' não existe");
+            }
+        }
+        for (AnimationClip& c : clips) {
+            c.duration = 0.0f;
+            bool empty = false;
+            auto visit = [&](const auto& tracks) {
+                for (const auto& t : tracks) {
+                    c.duration = std::max(c.duration, t.duration());
+                    empty = empty || t.times.empty();
+                }
+            };
+            visit(c.floats);
+            visit(c.vec3s);
+            visit(c.quats);
+            if (empty) {
+                lineNo = 0;
+                return fail("clip '" + c.name + "' tem trilha sem keyframes");
+            }
+            if (c.syncChannel >= 0 && !findTrack(c.floats, c.syncChannel)) {
+                lineNo = 0;
+                return fail("clip '" + c.name + "' sincroniza por um canal sem trilha");
+            }
+        }
+        return true;
+    }
+
+    int clipIndex(const std::string& name) const
+    {
+        for (size_t i = 0; i < clips.size(); i++)
+            if (clips[i].name == name)
+                return (int)i;
+        return -1;
+    }
+    int clipCount() const { return (int)clips.size(); }
+    const AnimationClip& clip(int i) const { return clips[i]; }
+
+    // Índice do canal dentro do tipo, ou -1
+    int findChannel(const std::string& name, ChannelType type) const
+    {
+        for (size_t i = 0; i < channels.size(); i++)
+            if (channels[i].name == name && channels[i].type == type)
+                return channels[i].slot;
+        return -1;
+    }
+    int channelCount(ChannelType type) const
+    {
+        return (int)std::count_if(channels.begin(), channels.end(), [type](const Channel& c) { return c.type == type; });
+    }
+
+    // Pose de repouso: 0, vec3(0) e identidade
+    AnimationPose restPose() const
+    {
+        AnimationPose p;
+        p.floats.assign(channelCount(ChannelType::Float), 0.0f);
+        p.vec3s.assign(channelCount(ChannelType::Vec3), glm::vec3(0.0f));
+        p.quats.assign(channelCount(ChannelType::Quat), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        return p;
+    }
+
+    template <typename T>
+    static const Track<T>* findTrack(const std::vector<Track<T>>& tracks, int channel)
+    {
+        for (const Track<T>& t : tracks)
+            if (t.channel == channel)
+                return &t;
+        return nullptr;
+    }
+
+    // Tempo de entrada no clip com o canal de sincronia valendo 'value' (0 sem sincronia)
+    float syncTime(int clipIdx, float value) const
+    {
+        const AnimationClip& c = clips[clipIdx];
+        const Track<float>* t = c.syncChannel >= 0 ? findTrack(c.floats, c.syncChannel) : nullptr;
+        return t ? trackTimeOf(*t, value) : 0.0f;
+    }
+
+private:
+    struct Channel {
+        std::string name;
+        ChannelType type;
+        int slot;
+    };
+    std::vector<Channel> channels;
+    std::vector<AnimationClip> clips;
+
+    // Canal existente do mesmo tipo, novo, ou -1 se o nome já é de outro tipo
+    int channel(const std::string& name, ChannelType type)
+    {
+        for (const Channel& c : channels)
+            if (c.name == name)
+                return c.type == type ? c.slot : -1;
+        int slot = channelCount(type);
+        channels.push_back({ name, type, slot });
+        return slot;
+    }
+
+    template <typename T>
+    static int addTrack(std::vector<Track<T>>& tracks, int channel, Interp interp)
+    {
+        tracks.emplace_back();
+        tracks.back().channel = channel;
+        tracks.back().interp = interp;
+        return (int)tracks.size() - 1;
+    }
+
+    template <typename T>
+    static bool addKey(Track<T>& track, float time, const T& value)
+    {
+        if (!track.times.empty() && time < track.times.back())
+            return false;
+        track.times.push_back(time);
+        track.values.push_back(value);
+        return true;
+    }
+
+    // ==== EXPRESSÕES ====
+    // soma := termo (('+'|'-') termo)*, termo := fator (('*'|'/') fator)*,
+    // fator := número | parâmetro | '-' fator | '(' soma ')'
+    static bool evaluate(const std::string& text, const std::map<std::string, float>& vars, float& out)
+    {
+        size_t pos = 0;
+        bool ok = true;
+        float v = parseSum(text, pos, vars, ok);
+        if (!ok || pos != text.size())
+            return false;
+        out = v;
+        return true;
+    }
+
+    static float parseSum(const std::string& s, size_t& pos, const std::map<std::string, float>& vars, bool& ok)
+    {
+        float v = parseTerm(s, pos, vars, ok);
+        while (ok && pos < s.size() && (s[pos] == '+' || s[pos] == '-')) {
+            char op = s[pos++];
+            float r = parseTerm(s, pos, vars, ok);
+            v = op == '+' ? v + r : v - r;
+        }
+        return v;
+    }
+
+    static float parseTerm(const std::string& s, size_t& pos, const std::map<std::string, float>& vars, bool& ok)
+    {
+        float v = parseFactor(s, pos, vars, ok);
+        while (ok && pos < s.size() && (s[pos] == '*' || s[pos] == '/')) {
+            char op = s[pos++];
+            float r = parseFactor(s, pos, vars, ok);
+            v = op == '*' ? v * r : v / r;
+        }
+        return v;
+    }
+
+    static float parseFactor(const std::string& s, size_t& pos, const std::map<std::string, float>& vars, bool& ok)
+    {
+        if (pos >= s.size()) {
+            ok = false;
+            return 0.0f;
+        }
+        if (s[pos] == '-') {
+            pos++;
+            return -parseFactor(s, pos, vars, ok);
+        }
+        if (s[pos] == '(') {
+            pos++;
+            float v = parseSum(s, pos, vars, ok);
+            if (pos >= s.size() || s[pos] != ')')
+                ok = false;
+            pos++;
+            return v;
+        }
+        if (std::isdigit((unsigned char)s[pos]) || s[pos] == '.') {
+            char* end = nullptr;
+            float v = std::strtof(s.c_str() + pos, &end);
+            pos = end - s.c_str();
+            return v;
+        }
+        size_t start = pos;
+        while (pos < s.size() && (std::isalnum((unsigned char)s[pos]) || s[pos] == '_'))
+            pos++;
+        auto it = vars.find(s.substr(start, pos - start));
+        if (start == pos || it == vars.end()) {
+            ok = false;
+            return 0.0f;
+        }
+        return it->second;
+    }
+};
+
+// ==== UMA INSTÂNCIA ====
+class AnimationPlayer {
+public:
+    void init(const AnimationLibrary& library)
+    {
+        lib = &library;
+        current = -1;
+        time = 0.0f;
+        currentPose = fromPose = library.restPose();
+    }
+
+    // Troca de clip a partir da pose atual; sem 'blend', entra sem mistura (estado inicial)
+    void play(int clip, bool blend = true)
+    {
+        if (clip < 0 || clip >= lib->clipCount())
+            return;
+        const AnimationClip& c = lib->clip(clip);
+        time = c.syncChannel >= 0 ? lib->syncTime(clip, currentPose.floats[c.syncChannel]) : 0.0f;
+        current = clip;
+        cursors.assign(c.trackCount(), 0);
+        fromPose = currentPose;
+        blendDuration = blend ? c.blend : 0.0f;
+        blendElapsed = 0.0f;
+        evaluate();
+    }
+
+    // Avança o tempo do clip (loop / próximo) e reamostra a pose
+    void advance(float dt)
+    {
+        if (current < 0)
+            return;
+        time += dt;
+        blendElapsed += dt;
+        const AnimationClip& c = lib->clip(current);
+        if (time >= c.duration) {
+            if (c.loop && c.duration > 0.0f)
+                time = std::fmod(time, c.duration);
+            else if (c.next >= 0) {
+                float excess = time - c.duration;
+                play(c.next, false);
+                time += excess;
+            } else
+                time = c.duration;
+        }
+        evaluate();
+    }
+
+    // Pose de partida para a sincronia do próximo play() (canais sem trilha ficam com ela)
+    void setPose(const AnimationPose& pose) { currentPose = fromPose = pose; }
+
+    const AnimationPose& pose() const { return currentPose; }
+    int clip() const { return current; }
+    float clipTime() const { return time; }
+
+private:
+    const AnimationLibrary* lib = nullptr;
+    int current = -1;
+    float time = 0.0f, blendElapsed = 0.0f, blendDuration = 0.0f;
+    std::vector<uint32_t> cursors; // uma por trilha do clip: floats, vec3s, quats
+    AnimationPose currentPose, fromPose;
+
+    void evaluate()
+    {
+        const AnimationClip& c = lib->clip(current);
+        float w = blendDuration > 0.0f ? std::min(1.0f, blendElapsed / blendDuration) : 1.0f;
+        size_t k = 0;
+        for (const Track<float>& t : c.floats)
+            currentPose.floats[t.channel] = interpolateKey(fromPose.floats[t.channel], t.sample(time, cursors[k++]), w);
+        for (const Track<glm::vec3>& t : c.vec3s)
+            currentPose.vec3s[t.channel] = interpolateKey(fromPose.vec3s[t.channel], t.sample(time, cursors[k++]), w);
+        for (const Track<glm::quat>& t : c.quats)
+            currentPose.quats[t.channel] = interpolateKey(fromPose.quats[t.channel], t.sample(time, cursors[k++]), w);
+    }
+};
+
+// ==== N INSTÂNCIAS (SoA) ====
+// Sem mistura: a troca de clip já entra sincronizada pelo canal do clip
+class AnimationBatch {
+public:
+    void init(const AnimationLibrary& library, size_t n)
+    {
+        lib = &library;
+        count = n;
+        clips.assign(n, -1);
+        times.assign(n, 0.0f);
+        AnimationPose rest = library.restPose();
+        floatOut.assign(rest.floats.size(), std::vector<float>(n, 0.0f));
+        vec3Out.assign(rest.vec3s.size(), std::vector<glm::vec3>(n, glm::vec3(0.0f)));
+        quatOut.assign(rest.quats.size(), std::vector<glm::quat>(n, glm::quat(1.0f, 0.0f, 0.0f, 0.0f)));
+        size_t channels = rest.floats.size() + rest.vec3s.size() + rest.quats.size();
+        cursors.assign(channels, std::vector<uint32_t>(n, 0));
+    }
+
+    // 'offset' soma ao tempo de entrada (fases diferentes para instâncias iguais)
+    void play(size_t i, int clip, float offset = 0.0f)
+    {
+        if (clip < 0 || clip >= lib->clipCount())
+            return;
+        const AnimationClip& c = lib->clip(clip);
+        times[i] = (c.syncChannel >= 0 ? lib->syncTime(clip, floatOut[c.syncChannel][i]) : 0.0f) + offset;
+        clips[i] = clip;
+        for (std::vector<uint32_t>& cur : cursors)
+            cur[i] = 0;
+    }
+
+    // Instâncias [begin, end): avança os tempos, resolve loop/próximo
+    void advance(float dt, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++) {
+            if (clips[i] < 0)
+                continue;
+            times[i] += dt;
+            const AnimationClip& c = lib->clip(clips[i]);
+            if (times[i] >= c.duration) {
+                if (c.loop && c.duration > 0.0f)
+                    times[i] = std::fmod(times[i], c.duration);
+                else if (c.next >= 0) {
+                    float excess = times[i] - c.duration;
+                    play(i, c.next, excess);
+                } else
+                    times[i] = c.duration;
+            }
+        }
+    }
+
+    // Amostra as trilhas do clip de cada instância em [begin, end): uma trilha por
+    // vez, percorrendo só as instâncias daquele clip (índices agrupados por clip)
+    void evaluate(size_t begin, size_t end)
+    {
+        int numClips = lib->clipCount();
+        thread_local std::vector<uint32_t> order, start;
+        order.resize(end - begin);
+        start.assign(numClips + 2, 0);
+        for (size_t i = begin; i < end; i++)
+            start[clips[i] + 2]++;
+        for (int c = 0; c <= numClips; c++)
+            start[c + 1] += start[c];
+        for (size_t i = begin; i < end; i++)
+            order[start[clips[i] + 1]++] = (uint32_t)i;
+        // Agora o clip c ocupa order[start[c], start[c + 1]) (as paradas vêm antes)
+        for (int c = 0; c < numClips; c++) {
+            const AnimationClip& clip = lib->clip(c);
+            const uint32_t* first = order.data() + start[c];
+            const uint32_t* last = order.data() + start[c + 1];
+            for (const Track<float>& t : clip.floats)
+                sampleRange(t, first, last, cursors[t.channel], floatOut[t.channel]);
+            size_t base = floatOut.size();
+            for (const Track<glm::vec3>& t : clip.vec3s)
+                sampleRange(t, first, last, cursors[base + t.channel], vec3Out[t.channel]);
+            base += vec3Out.size();
+            for (const Track<glm::quat>& t : clip.quats)
+                sampleRange(t, first, last, cursors[base + t.channel], quatOut[t.channel]);
+        }
+    }
+
+    void advance(float dt) { advance(dt, 0, count); }
+    void evaluate() { evaluate(0, count); }
+
+    size_t size() const { return count; }
+    int clip(size_t i) const { return clips[i]; }
+    float clipTime(size_t i) const { return times[i]; }
+    const std::vector<float>& floats(int channel) const { return floatOut[channel]; }
+    const std::vector<glm::vec3>& vec3s(int channel) const { return vec3Out[channel]; }
+    const std::vector<glm::quat>& quats(int channel) const { return quatOut[channel]; }
+
+private:
+    const AnimationLibrary* lib = nullptr;
+    size_t count = 0;
+    std::vector<int> clips; // -1: sem clip
+    std::vector<float> times;
+    std::vector<std::vector<uint32_t>> cursors; // [canal (floats, vec3s, quats)][instância]
+    std::vector<std::vector<float>> floatOut;
+    std::vector<std::vector<glm::vec3>> vec3Out;
+    std::vector<std::vector<glm::quat>> quatOut;
+
+    template <typename T>
+    void sampleRange(const Track<T>& track, const uint32_t* first, const uint32_t* last, std::vector<uint32_t>& cursor,
+                     std::vector<T>& out)
+    {
+        for (const uint32_t* it = first; it != last; ++it) {
+            uint32_t i = *it;
+            out[i] = track.sample(times[i], cursor[i]);
+        }
+    }
+};
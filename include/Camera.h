@@ -0,0 +1,61 @@
+#pragma once
+
+// ============== CAMERA ==============
+// Câmera em primeira pessoa da CenaFinal (yaw/pitch em graus).
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+enum class CameraMovement { Forward, Backward, Left, Right };
+
+class Camera
+{
+public:
+    glm::vec3 position, front, up, right, worldUp;
+    float yaw, pitch, speed, sensitivity;
+
+    Camera(glm::vec3 pos) : position(pos), worldUp(0.0f, 1.0f, 0.0f), yaw(-90.0f), pitch(0.0f), speed(2.5f), sensitivity(0.1f)
+    {
+        updateCameraVectors();
+    }
+
+    glm::mat4 GetViewMatrix()
+    {
+        return glm::lookAt(position, position + front, up);
+    }
+
+    void Move(CameraMovement dir, float deltaTime)
+    {
+        float velocity = speed * deltaTime;
+        switch (dir) {
+        case CameraMovement::Forward: position += front * velocity; break;
+        case CameraMovement::Backward: position -= front * velocity; break;
+        case CameraMovement::Left: position -= right * velocity; break;
+        case CameraMovement::Right: position += right * velocity; break;
+        }
+    }
+
+    void Rotate(float xoffset, float yoffset)
+    {
+        xoffset *= sensitivity;
+        yoffset *= sensitivity;
+        yaw += xoffset;
+        pitch += yoffset;
+        pitch = glm::clamp(pitch, -89.0f, 89.0f);
+        updateCameraVectors();
+    }
+
+private:
+    void updateCameraVectors()
+    {
+        glm::vec3 f;
+        f.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+        f.y = sin(glm::radians(pitch));
+        f.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+        front = glm::normalize(f);
+        right = glm::normalize(glm::cross(front, worldUp));
+        up = glm::normalize(glm::cross(right, front));
+    }
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+// ============== CLUSTERED FORWARD LIGHTING ==============
+// Divide o frustum da câmera em uma grade 3D (tiles de tela x fatias
+// exponenciais de profundidade) e atribui a cada cluster as luzes pontuais e
+// spot cuja esfera de influência o toca. A atribuição roda na CPU: cada job
+// do JobSystem cuida de um intervalo de fatias e o teste esfera x AABB é feito com SSE,
+// quatro clusters por vez. O resultado vai para três SSBOs:
+//   binding 0: luzes (ClusterLight, std430)
+//   binding 1: por cluster, (offset, quantidade) na lista de índices
+//   binding 2: lista de índices de luzes
+// e o fragment shader avalia só as luzes do cluster do fragmento.
+// Cada cluster guarda no máximo MAX_LIGHTS_PER_CLUSTER luzes; as excedentes
+// são descartadas, contadas em overflow e avisadas no cerr (uma vez).
+// Com a thread de render, assign() roda na simulação, swapLists() entrega as
+// listas ao pacote do frame e upload() as envia na thread do GL.
+
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <iostream>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <Profiler.h>
+#include <JobSystem.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CLUSTER_USE_SSE 1
+#endif
+
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+
+// Layout idêntico ao struct Luz do shader (std430, 64 bytes)
+struct ClusterLight {
+    glm::vec4 positionRadius;  // xyz = posição (mundo), w = raio de influência
+    glm::vec4 colorType;       // rgb = cor, w = 0 pontual / 1 spot
+    glm::vec4 directionCos;    // xyz = direção do spot, w = cos do ângulo externo
+    glm::vec4 params;          // x = cos do ângulo interno
+};
+
+class ClusterGrid {
+public:
+    static const int MAX_LIGHTS_PER_CLUSTER = 128;
+
+    int dimX = 16, dimY = 9, dimZ = 24;
+    float assignMs = 0.0f; // tempo da última atribuição
+    size_t overflow = 0;   // pares luz/cluster descartados na última atribuição (cluster cheio)
+    int fullClusters = 0;  // clusters que descartaram luzes na última atribuição
+
+    void init(int threads = 0)
+    {
+        numThreads = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        glGenBuffers(3, ssbo);
+    }
+
+    // Recalcula as AABBs dos clusters (em espaço de câmera) quando a projeção muda
+    void setProjection(const glm::mat4& proj, float zNear, float zFar, int width, int height)
+    {
+        this->zNear = zNear;
+        this->zFar = zFar;
+        screenW = width;
+        screenH = height;
+
+        int count = dimX * dimY * dimZ;
+        bmin[0].resize(count); bmin[1].resize(count); bmin[2].resize(count);
+        bmax[0].resize(count); bmax[1].resize(count); bmax[2].resize(count);
+        glm::mat4 invProj = glm::inverse(proj);
+
+        for (int k = 0; k < dimZ; k++) {
+            float dn = sliceDepth(k), df = sliceDepth(k + 1);
+            for (int j = 0; j < dimY; j++) {
+                for (int i = 0; i < dimX; i++) {
+                    glm::vec3 lo(1e30f), hi(-1e30f);
+                    for (int c = 0; c < 4; c++) {
+                        float nx = ((i + (c & 1)) / (float)dimX) * 2.0f - 1.0f;
+                        float ny = ((j + (c >> 1)) / (float)dimY) * 2.0f - 1.0f;
+                        glm::vec4 p = invProj * glm::vec4(nx, ny, -1.0f, 1.0f);
+                        glm::vec3 ray = glm::vec3(p) / p.w;
+                        ray /= -ray.z; // raio com z = -1
+                        lo = glm::min(lo, glm::min(ray * dn, ray * df));
+                        hi = glm::max(hi, glm::max(ray * dn, ray * df));
+                    }
+                    int idx = index(i, j, k);
+                    for (int a = 0; a < 3; a++) {
+                        bmin[a][idx] = lo[a];
+                        bmax[a][idx] = hi[a];
+                    }
+                }
+            }
+        }
+    }
+
+    // Atribui as luzes aos clusters e envia tudo para os SSBOs
+    void update(const std::vector<ClusterLight>& lights, const glm::mat4& view)
+    {
+        assign(lights, view);
+        upload(lights, grid, indices);
+    }
+
+    // Só a atribuição, sem GL: listas em grid/indices até o próximo swapLists()
+    void assign(const std::vector<ClusterLight>& lights, const glm::mat4& view)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        int count = dimX * dimY * dimZ;
+        counts.assign(count, 0);
+        slots.resize((size_t)count * MAX_LIGHTS_PER_CLUSTER);
+
+        // Esferas em espaço de câmera e intervalo de fatias de cada luz
+        viewLights.resize(lights.size());
+        for (size_t l = 0; l < lights.size(); l++) {
+            glm::vec4 p = view * glm::vec4(glm::vec3(lights[l].positionRadius), 1.0f);
+            float r = lights[l].positionRadius.w;
+            ViewLight& v = viewLights[l];
+            v.x = p.x; v.y = p.y; v.z = p.z; v.r = r;
+            v.k0 = slice(-p.z - r);
+            v.k1 = slice(-p.z + r);
+            v.visible = (-p.z + r) > zNear && (-p.z - r) < zFar;
+        }
+
+        JobSystem::global().parallelFor(dimZ, 1, [this](int begin, int end) { assignSlices(begin, end); },
+                                        std::min(numThreads, dimZ));
+
+        // Compacta as listas (offset, quantidade) + índices
+        grid.resize((size_t)count * 2);
+        indices.clear();
+        overflow = 0;
+        fullClusters = 0;
+        for (int c = 0; c < count; c++) {
+            int n = std::min(counts[c], MAX_LIGHTS_PER_CLUSTER);
+            if (counts[c] > n) {
+                overflow += (size_t)(counts[c] - n);
+                fullClusters++;
+            }
+            grid[c * 2] = (uint32_t)indices.size();
+            grid[c * 2 + 1] = (uint32_t)n;
+            indices.insert(indices.end(), slots.begin() + (size_t)c * MAX_LIGHTS_PER_CLUSTER,
+                           slots.begin() + (size_t)c * MAX_LIGHTS_PER_CLUSTER + n);
+        }
+        if (overflow > 0 && !warnedOverflow) {
+            std::cerr << "[clustered] " << fullClusters << " clusters com mais de " << MAX_LIGHTS_PER_CLUSTER
+                      << " luzes: " << overflow << " pares luz/cluster descartados (buracos na iluminação); reduza luzes.raio ou luzes.quantidade"
+                      << std::endl;
+            warnedOverflow = true;
+        }
+        if (indices.empty())
+            indices.push_back(0);
+        indexCount = indices.size();
+
+        assignMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // Troca as listas da última atribuição pelas do chamador (o assign() seguinte reescreve tudo)
+    void swapLists(std::vector<uint32_t>& gridOut, std::vector<uint32_t>& indicesOut)
+    {
+        grid.swap(gridOut);
+        indices.swap(indicesOut);
+    }
+
+    // Luzes + listas (offset, quantidade) e índices para os SSBOs
+    void upload(const std::vector<ClusterLight>& lights, const std::vector<uint32_t>& gridIn,
+                const std::vector<uint32_t>& indicesIn)
+    {
+        uploadLights(lights);
+        upload(1, gridIn.data(), gridIn.size() * sizeof(uint32_t));
+        upload(2, indicesIn.data(), indicesIn.size() * sizeof(uint32_t));
+    }
+
+    // Só o buffer de luzes (binding 0), para quem não precisa das listas por cluster
+    void uploadLights(const std::vector<ClusterLight>& lights)
+    {
+        upload(0, lights.empty() ? nullptr : lights.data(), std::max<size_t>(1, lights.size()) * sizeof(ClusterLight));
+    }
+
+    GLuint lightsSSBO() const { return ssbo[0]; }
+
+    // Uniforms da projeção atual; copiados no pacote do frame quando o desenho é em outra thread
+    struct ShaderParams {
+        int dimX, dimY, dimZ;
+        float tileW, tileH, zNear, zFar;
+    };
+
+    ShaderParams shaderParams() const
+    {
+        return { dimX, dimY, dimZ, (float)screenW / dimX, (float)screenH / dimY, zNear, zFar };
+    }
+
+    // Ativa os SSBOs e os uniforms que o shader clusterizado espera
+    void bind(GLuint program) const { bind(program, shaderParams()); }
+
+    void bind(GLuint program, const ShaderParams& p) const
+    {
+        for (int i = 0; i < 3; i++)
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, ssbo[i]);
+        glUniform3i(glGetUniformLocation(program, "clusterDims"), p.dimX, p.dimY, p.dimZ);
+        glUniform2f(glGetUniformLocation(program, "tileSize"), p.tileW, p.tileH);
+        glUniform1f(glGetUniformLocation(program, "zNear"), p.zNear);
+        glUniform1f(glGetUniformLocation(program, "zFar"), p.zFar);
+    }
+
+    size_t totalIndices() const { return indexCount; }
+
+private:
+    struct ViewLight {
+        float x, y, z, r;
+        int k0, k1;
+        bool visible;
+    };
+
+    int numThreads = 1;
+    float zNear = 0.1f, zFar = 100.0f;
+    int screenW = 1, screenH = 1;
+    GLuint ssbo[3] = { 0, 0, 0 };
+
+    std::vector<float> bmin[3], bmax[3]; // AABBs dos clusters em SoA
+    std::vector<ViewLight> viewLights;
+    std::vector<int> counts;
+    std::vector<uint32_t> slots, grid, indices;
+    size_t indexCount = 0;
+    bool warnedOverflow = false;
+
+    int index(int i, int j, int k) const { return (k * dimY + j) * dimX + i; }
+
+    float sliceDepth(int k) const { return zNear * std::pow(zFar / zNear, (float)k / dimZ); }
+
+    int slice(float depth) const
+    {
+        if (depth <= zNear)
+            return 0;
+        int k = (int)std::floor(std::log(depth / zNear) / std::log(zFar / zNear) * dimZ);
+        return std::min(std::max(k, 0), dimZ - 1);
+    }
+
+    void assignSlices(int kBegin, int kEnd)
+    {
+        PROFILE_SCOPE("clusters_atribuicao");
+        int perSlice = dimX * dimY;
+        for (uint32_t l = 0; l < viewLights.size(); l++) {
+            const ViewLight& v = viewLights[l];
+            if (!v.visible || v.k1 < kBegin || v.k0 >= kEnd)
+                continue;
+            int k0 = std::max(v.k0, kBegin), k1 = std::min(v.k1, kEnd - 1);
+            for (int k = k0; k <= k1; k++) {
+                int base = k * perSlice;
+                int c = 0;
+#ifdef CLUSTER_USE_SSE
+                __m128 px = _mm_set1_ps(v.x), py = _mm_set1_ps(v.y), pz = _mm_set1_ps(v.z);
+                __m128 r2 = _mm_set1_ps(v.r * v.r), zero = _mm_setzero_ps();
+                for (; c + 4 <= perSlice; c += 4) {
+                    __m128 d2 = zero;
+                    const __m128 p[3] = { px, py, pz };
+                    for (int a = 0; a < 3; a++) {
+                        __m128 lo = _mm_loadu_ps(&bmin[a][base + c]);
+                        __m128 hi = _mm_loadu_ps(&bmax[a][base + c]);
+                        __m128 d = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(lo, p[a]), _mm_sub_ps(p[a], hi)));
+                        d2 = _mm_add_ps(d2, _mm_mul_ps(d, d));
+                    }
+                    int mask = _mm_movemask_ps(_mm_cmple_ps(d2, r2));
+                    while (mask) {
+                        int bit = __builtin_ctz(mask);
+                        append(base + c + bit, l);
+                        mask &= mask - 1;
+                    }
+                }
+#endif
+                for (; c < perSlice; c++) {
+                    int idx = base + c;
+                    float d2 = 0.0f;
+                    const float p[3] = { v.x, v.y, v.z };
+                    for (int a = 0; a < 3; a++) {
+                        float d = std::max(0.0f, std::max(bmin[a][idx] - p[a], p[a] - bmax[a][idx]));
+                        d2 += d * d;
+                    }
+                    if (d2 <= v.r * v.r)
+                        append(idx, l);
+                }
+            }
+        }
+    }
+
+    // counts passa do limite para a compactação contar as descartadas
+    void append(int cluster, uint32_t light)
+    {
+        int n = counts[cluster]++;
+        if (n < MAX_LIGHTS_PER_CLUSTER)
+            slots[(size_t)cluster * MAX_LIGHTS_PER_CLUSTER + n] = light;
+    }
+
+    void upload(int i, const void* data, size_t bytes)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo[i]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, bytes, NULL, GL_STREAM_DRAW); // orphan
+        if (data)
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bytes, data);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+};
@@ -0,0 +1,594 @@
+#pragma once
+
+// ============== CONFIGURATION LOADER ==============
+// config.ini no formato "[secao]" + "chave=valor"; as chaves ficam como
+// "secao.chave". Compartilhado pela CenaFinal e pelo cg_bench.
+//
+// loadConfig() lê o arquivo uma vez e publica:
+//   - o mapa 'config' (getFloat/getVec3/getString/getBool), para a
+//     inicialização e as ferramentas;
+//   - um snapshot tipado e validado (Settings), para o laço principal.
+// ConfigWatcher observa o arquivo numa thread (inotify no Linux, data de
+// modificação nos outros sistemas), reinterpreta e troca o snapshot de forma
+// atômica. O render thread só lê campos de SettingsSnapshot, atualizado com
+// uma leitura atômica de versão por frame; nenhum parse fica no frame.
+// O watcher não mexe no mapa 'config': os getters valem para a inicialização.
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <glm/glm.hpp>
+
+inline std::map<std::string, std::string> config;
+
+// Lê config.ini para 'out'; false se o arquivo não abrir
+inline bool readConfigFile(const std::string& filename, std::map<std::string, std::string>& out) {
+    std::ifstream file(filename);
+    if (!file)
+        return false;
+    std::string line;
+    std::string section;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back(); // arquivos salvos no Windows
+        if (line.empty() || line[0] == '#') continue;
+
+        if (line[0] == '[') {
+            section = line.substr(1, line.find(']') - 1);
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+
+        std::string fullKey = section.empty() ? key : section + "." + key;
+        out[fullKey] = value;
+    }
+    return true;
+}
+
+inline float getFloat(const std::string& key, float def) {
+    return config.count(key) ? std::stof(config[key]) : def;
+}
+
+inline glm::vec3 getVec3(const std::string& key, glm::vec3 def) {
+    if (!config.count(key)) return def;
+    std::stringstream ss(config[key]);
+    float x, y, z;
+    char sep; // ignora vírgulas
+    ss >> x >> sep >> y >> sep >> z;
+    return glm::vec3(x, y, z);
+}
+
+inline std::string getString(const std::string& key, const std::string& def) {
+    return config.count(key) ? config[key] : def;
+}
+
+inline bool getBool(const std::string& key, bool def) {
+    if (config.count(key) == 0) return def;
+
+    std::string val = config[key];
+    std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+
+    return (val == "true");
+}
+
+// ============== SETTINGS TIPADOS ==============
+// Um campo por chave do config.ini, com os padrões da CenaFinal. Os marcados
+// "ao vivo" são relidos a cada frame; os demais só valem na inicialização.
+struct Settings {
+    struct {
+        int width = 800, height = 600;
+        std::string title = "OVNI vs Vaca"; // ao vivo
+    } window;
+    struct {
+        bool casaLuz = true;
+        float ovniTopo = 20.0f, ovniBaixo = 6.5f; // padrão: fuga + 5, abducao + 1.5
+        float vacaY = 0.0f; // o clip inicial entra na altura da vaca (o resto da pose vem dele)
+    } estadoInicial;
+    struct {
+        float abducao = 5.0f, fuga = 15.0f;
+    } alturas;
+    struct {
+        float amplitude = 1.0f;
+    } curvas;
+    struct {
+        bool ativa = true;
+        int largura = 320, altura = 192, threads = 0;
+    } oclusao;
+    struct {
+        std::string ceu = "../assets/Modelos3D/final/ceu.png";
+        std::string chao = "../assets/Modelos3D/final/grama.png";
+    } texturas;
+    struct {
+        std::string ovni = "../assets/Modelos3D/final/Nave.obj";
+        std::string vaca = "../assets/Modelos3D/final/vaca.obj";
+        std::string casa = "../assets/Modelos3D/final/casa.obj";
+    } modeloPaths;
+    struct {
+        std::string arquivo = "../assets/Animacoes/abducao.anim";
+    } animacao;
+    struct {
+        float raio = 2.5f;
+        bool demo = false, varredura = false;
+        int threads = 0, quantidade = 1000, max = 4096;
+        float intervalo = 2.0f; // ao vivo
+    } luzes;
+    struct {
+        bool ativo = false, varredura = false;
+        int vacas = 1000, ovnis = 100, threads = 0, max = 100000;
+        float espaco = 2.0f;
+        glm::vec3 centro = glm::vec3(0.0f, 0.0f, -40.0f);
+        float intervalo = 2.0f; // ao vivo
+    } rebanho;
+    struct {
+        int threads = 0; // JobSystem, contando a thread principal (0: uma por núcleo)
+    } jobs;
+    struct {
+        bool ativo = true;
+        std::string modo = "auto"; // auto: GPU com compute shaders (4.3+), senão CPU
+        int quantidade = 1000000, threads = 0; // partículas vivas com o raio ligado; threads só na CPU
+        float tamanho = 2.0f;                  // pixels (ao vivo)
+    } particulas;
+    struct {
+        glm::vec3 ka = glm::vec3(0.2f), kd = glm::vec3(0.8f), ks = glm::vec3(0.1f); // ao vivo
+        float shininess = 8.0f;                                                    // ao vivo
+    } chao;
+    struct LightMaterial {
+        glm::vec3 ka, kd, ks;
+    };
+    LightMaterial luzCasa = { glm::vec3(0.2f), glm::vec3(1.5f), glm::vec3(0.3f) }; // ao vivo
+    LightMaterial luzOvni = { glm::vec3(0.05f, 0.2f, 0.05f), glm::vec3(0.2f, 1.0f, 0.2f), glm::vec3(0.1f, 0.8f, 0.1f) }; // ao vivo
+    struct {
+        bool deferred = false;
+        bool temposGpu = false; // ao vivo
+        bool thread = true;     // desenho numa thread própria (false = mesma fila, em série)
+    } renderer;
+    struct {
+        bool ativa = true, cache = true;
+        int resolucao = 1024;
+    } sombra;
+    struct {
+        std::string dir = "shader_cache";
+    } shaderCache;
+    struct {
+        bool ativo = true;
+        std::string arquivo = "trace_cenafinal.json";
+    } profiler;
+    struct {
+        float hz = 120.0f;
+        int maxPassos = 8;
+    } simulacao;
+    // [ovni_partes] nome=rad/s: giro em Y de cada objeto "o" do ovni em volta do próprio centro (ao vivo)
+    std::map<std::string, float> ovniPartes;
+};
+
+// ==== PARSE E VALIDAÇÃO ====
+// Um valor inválido vira um erro e o campo fica com o padrão; chaves que
+// nenhum campo lê viram avisos (provável erro de digitação).
+struct SettingsReport {
+    std::vector<std::string> errors, unknown;
+};
+
+class SettingsParser {
+public:
+    SettingsParser(const std::map<std::string, std::string>& raw, SettingsReport& report)
+        : raw(raw), report(report) {}
+
+    void real(const std::string& key, float& field, float lo, float hi) {
+        const std::string* v = find(key);
+        float x;
+        if (v && !(parseFloat(*v, x) && x >= lo && x <= hi))
+            error(key, *v, "número entre " + num(lo) + " e " + num(hi));
+        else if (v)
+            field = x;
+    }
+
+    void integer(const std::string& key, int& field, int lo, int hi) {
+        const std::string* v = find(key);
+        float x;
+        if (v && !(parseFloat(*v, x) && x == std::floor(x) && x >= lo && x <= hi))
+            error(key, *v, "inteiro entre " + std::to_string(lo) + " e " + std::to_string(hi));
+        else if (v)
+            field = (int)x;
+    }
+
+    // true/false (como getBool) ou 1/0 (como o antigo getFloat("estado_inicial.casa_luz"))
+    void boolean(const std::string& key, bool& field) {
+        const std::string* v = find(key);
+        if (!v)
+            return;
+        std::string s = trim(*v);
+        std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+        if (s == "true" || s == "1")
+            field = true;
+        else if (s == "false" || s == "0")
+            field = false;
+        else
+            error(key, *v, "true/false");
+    }
+
+    // "x,y,z" (vírgulas ou espaços)
+    void vec3(const std::string& key, glm::vec3& field, float lo, float hi) {
+        const std::string* v = find(key);
+        if (!v)
+            return;
+        std::string s = *v;
+        std::replace(s.begin(), s.end(), ',', ' ');
+        std::stringstream ss(s);
+        std::string parts[4];
+        int n = 0;
+        while (n < 4 && ss >> parts[n])
+            n++;
+        glm::vec3 r;
+        bool ok = n == 3;
+        for (int i = 0; ok && i < 3; i++)
+            ok = parseFloat(parts[i], r[i]) && r[i] >= lo && r[i] <= hi;
+        if (ok)
+            field = r;
+        else
+            error(key, *v, "3 números entre " + num(lo) + " e " + num(hi));
+    }
+
+    void text(const std::string& key, std::string& field) {
+        const std::string* v = find(key);
+        if (v && trim(*v).empty())
+            error(key, *v, "texto não vazio");
+        else if (v)
+            field = *v;
+    }
+
+    void choice(const std::string& key, std::string& field, const std::vector<std::string>& options) {
+        const std::string* v = find(key);
+        if (!v)
+            return;
+        if (std::find(options.begin(), options.end(), trim(*v)) != options.end()) {
+            field = trim(*v);
+            return;
+        }
+        std::string list;
+        for (const std::string& o : options)
+            list += (list.empty() ? "" : "|") + o;
+        error(key, *v, list);
+    }
+
+    bool has(const std::string& key) const { return raw.count(key) > 0; }
+
+    void reportUnknown() {
+        for (const auto& kv : raw) {
+            if (!used.count(kv.first))
+                report.unknown.push_back(kv.first);
+        }
+    }
+
+    static bool parseFloat(const std::string& s, float& out) {
+        std::string t = trim(s);
+        if (t.empty())
+            return false;
+        char* end = nullptr;
+        errno = 0;
+        out = std::strtof(t.c_str(), &end);
+        return errno == 0 && end == t.c_str() + t.size() && std::isfinite(out);
+    }
+
+private:
+    const std::map<std::string, std::string>& raw;
+    SettingsReport& report;
+    std::set<std::string> used;
+
+    const std::string* find(const std::string& key) {
+        used.insert(key);
+        auto it = raw.find(key);
+        return it == raw.end() ? nullptr : &it->second;
+    }
+
+    void error(const std::string& key, const std::string& value, const std::string& expected) {
+        report.errors.push_back(key + " = '" + value + "': esperado " + expected);
+    }
+
+    static std::string trim(const std::string& s) {
+        size_t a = s.find_first_not_of(" \t"), b = s.find_last_not_of(" \t");
+        return a == std::string::npos ? std::string() : s.substr(a, b - a + 1);
+    }
+
+    static std::string num(float x) {
+        std::ostringstream ss;
+        ss << x;
+        return ss.str();
+    }
+};
+
+// Preenche 's' (que chega com os padrões) a partir das chaves de 'raw'
+inline SettingsReport parseSettings(const std::map<std::string, std::string>& raw, Settings& s) {
+    SettingsReport report;
+    SettingsParser p(raw, report);
+    const float BIG = 1e6f;
+
+    p.integer("window.width", s.window.width, 1, 16384);
+    p.integer("window.height", s.window.height, 1, 16384);
+    p.text("window.title", s.window.title);
+
+    p.real("alturas.abducao", s.alturas.abducao, 0.0f, BIG);
+    p.real("alturas.fuga", s.alturas.fuga, 0.0f, BIG);
+    p.real("curvas.amplitude", s.curvas.amplitude, 0.0f, BIG);
+
+    // Sem a chave, ovni_topo/ovni_baixo seguem as alturas
+    p.boolean("estado_inicial.casa_luz", s.estadoInicial.casaLuz);
+    if (!p.has("estado_inicial.ovni_topo"))
+        s.estadoInicial.ovniTopo = s.alturas.fuga + 5.0f;
+    p.real("estado_inicial.ovni_topo", s.estadoInicial.ovniTopo, -BIG, BIG);
+    if (!p.has("estado_inicial.ovni_baixo"))
+        s.estadoInicial.ovniBaixo = s.alturas.abducao + 1.5f;
+    p.real("estado_inicial.ovni_baixo", s.estadoInicial.ovniBaixo, -BIG, BIG);
+    p.real("estado_inicial.vacaY", s.estadoInicial.vacaY, -BIG, BIG);
+
+    p.boolean("oclusao.ativa", s.oclusao.ativa);
+    p.integer("oclusao.largura", s.oclusao.largura, 8, 4096);
+    p.integer("oclusao.altura", s.oclusao.altura, 8, 4096);
+    p.integer("oclusao.threads", s.oclusao.threads, 0, 256);
+
+    p.text("texturas.textura_ceu", s.texturas.ceu);
+    p.text("texturas.textura_chao", s.texturas.chao);
+    p.text("modelo_paths.ovni", s.modeloPaths.ovni);
+    p.text("modelo_paths.vaca", s.modeloPaths.vaca);
+    p.text("modelo_paths.casa", s.modeloPaths.casa);
+    p.text("animacao.arquivo", s.animacao.arquivo);
+
+    p.real("luzes.raio", s.luzes.raio, 0.0f, BIG);
+    p.boolean("luzes.demo", s.luzes.demo);
+    p.boolean("luzes.varredura", s.luzes.varredura);
+    p.integer("luzes.threads", s.luzes.threads, 0, 256);
+    p.integer("luzes.quantidade", s.luzes.quantidade, 0, 1 << 20);
+    p.integer("luzes.max", s.luzes.max, 1, 1 << 20);
+    p.real("luzes.intervalo", s.luzes.intervalo, 0.0f, BIG);
+
+    p.boolean("rebanho.ativo", s.rebanho.ativo);
+    p.boolean("rebanho.varredura", s.rebanho.varredura);
+    p.integer("rebanho.vacas", s.rebanho.vacas, 0, 1 << 22);
+    p.integer("rebanho.ovnis", s.rebanho.ovnis, 1, 1 << 22);
+    p.integer("rebanho.threads", s.rebanho.threads, 0, 256);
+    p.integer("rebanho.max", s.rebanho.max, 1, 1 << 22);
+    p.real("rebanho.espaco", s.rebanho.espaco, 0.1f, BIG);
+    p.vec3("rebanho.centro", s.rebanho.centro, -BIG, BIG);
+    p.real("rebanho.intervalo", s.rebanho.intervalo, 0.0f, BIG);
+
+    p.integer("jobs.threads", s.jobs.threads, 0, 256);
+
+    p.boolean("particulas.ativo", s.particulas.ativo);
+    p.choice("particulas.modo", s.particulas.modo, { "auto", "gpu", "cpu" });
+    p.integer("particulas.quantidade", s.particulas.quantidade, 1, 1 << 24);
+    p.integer("particulas.threads", s.particulas.threads, 0, 256);
+    p.real("particulas.tamanho", s.particulas.tamanho, 0.5f, 64.0f);
+
+    p.vec3("chao_ka", s.chao.ka, 0.0f, BIG);
+    p.vec3("chao_kd", s.chao.kd, 0.0f, BIG);
+    p.vec3("chao_ks", s.chao.ks, 0.0f, BIG);
+    p.real("chao_shininess", s.chao.shininess, 0.0f, 4096.0f);
+
+    p.vec3("luz_casa.ka", s.luzCasa.ka, 0.0f, BIG);
+    p.vec3("luz_casa.kd", s.luzCasa.kd, 0.0f, BIG);
+    p.vec3("luz_casa.ks", s.luzCasa.ks, 0.0f, BIG);
+    p.vec3("luz_ovni.ka", s.luzOvni.ka, 0.0f, BIG);
+    p.vec3("luz_ovni.kd", s.luzOvni.kd, 0.0f, BIG);
+    p.vec3("luz_ovni.ks", s.luzOvni.ks, 0.0f, BIG);
+
+    std::string modo = s.renderer.deferred ? "deferred" : "forward";
+    p.choice("renderer.modo", modo, { "forward", "deferred" });
+    s.renderer.deferred = modo == "deferred";
+    p.boolean("renderer.tempos_gpu", s.renderer.temposGpu);
+    p.boolean("renderer.thread", s.renderer.thread);
+
+    p.boolean("sombra.ativa", s.sombra.ativa);
+    p.boolean("sombra.cache", s.sombra.cache);
+    p.integer("sombra.resolucao", s.sombra.resolucao, 16, 16384);
+
+    p.text("shader_cache.dir", s.shaderCache.dir);
+    p.boolean("profiler.ativo", s.profiler.ativo);
+    p.text("profiler.arquivo", s.profiler.arquivo);
+
+    p.real("simulacao.hz", s.simulacao.hz, 1.0f, 10000.0f);
+    p.integer("simulacao.max_passos", s.simulacao.maxPassos, 1, 1000);
+
+    // Chaves livres: o nome do objeto vem do OBJ (pode ter ponto, como "BaseCima.001")
+    const std::string partes = "ovni_partes.";
+    for (const auto& kv : raw)
+        if (kv.first.compare(0, partes.size(), partes) == 0)
+            p.real(kv.first, s.ovniPartes[kv.first.substr(partes.size())], -BIG, BIG);
+
+    p.reportUnknown();
+    return report;
+}
+
+// ==== SNAPSHOT PUBLICADO ====
+// Escrito pelo loadConfig/ConfigWatcher, lido pelo render thread
+inline std::shared_ptr<const Settings> publishedSettings = std::make_shared<const Settings>();
+inline std::atomic<uint32_t> settingsVersion{ 0 };
+
+inline void publishSettings(std::shared_ptr<const Settings> s) {
+    std::atomic_store(&publishedSettings, std::move(s));
+    settingsVersion.fetch_add(1, std::memory_order_release);
+}
+
+inline std::shared_ptr<const Settings> currentSettings() {
+    return std::atomic_load(&publishedSettings);
+}
+
+// Cópia local do snapshot: refresh() depois do loadConfig e uma vez por frame
+// (só troca o ponteiro quando a versão muda); o resto do frame lê campos simples
+class SettingsSnapshot {
+public:
+    // true se um snapshot novo foi publicado desde o último refresh
+    bool refresh() {
+        uint32_t v = settingsVersion.load(std::memory_order_acquire);
+        if (current && v == version)
+            return false;
+        current = currentSettings();
+        version = v;
+        return true;
+    }
+
+    const Settings& get() const { return *current; }
+    const Settings* operator->() const { return current.get(); }
+    // Para guardar junto de dados lidos em outra thread (pacote do frame)
+    std::shared_ptr<const Settings> shared() const { return current; }
+    uint32_t currentVersion() const { return version; }
+
+private:
+    std::shared_ptr<const Settings> current; // vazio até o primeiro refresh()
+    uint32_t version = 0;
+};
+
+inline void printConfigReport(const std::string& filename, const SettingsReport& report, const char* onError) {
+    for (const std::string& e : report.errors)
+        std::cerr << "[config] " << filename << ": " << e << onError << std::endl;
+    for (const std::string& k : report.unknown)
+        std::cerr << "[config] " << filename << ": chave desconhecida '" << k << "'" << std::endl;
+}
+
+inline void loadConfig(const std::string& filename) {
+    std::map<std::string, std::string> raw;
+    readConfigFile(filename, raw);
+    for (const auto& kv : raw)
+        config[kv.first] = kv.second;
+
+    Settings s;
+    printConfigReport(filename, parseSettings(raw, s), ", usando o padrão");
+    publishSettings(std::make_shared<const Settings>(std::move(s)));
+}
+
+// Relê o arquivo; com algum valor inválido a recarga inteira é descartada e o
+// snapshot atual continua valendo (nada de meia configuração aplicada)
+inline bool reloadConfig(const std::string& filename) {
+    std::map<std::string, std::string> raw;
+    if (!readConfigFile(filename, raw)) {
+        std::cerr << "[config] " << filename << " não abriu, mantendo a configuração atual" << std::endl;
+        return false;
+    }
+    std::shared_ptr<Settings> s = std::make_shared<Settings>();
+    SettingsReport report = parseSettings(raw, *s);
+    printConfigReport(filename, report, "");
+    if (!report.errors.empty()) {
+        std::cerr << "[config] " << filename << ": recarga ignorada, mantendo a configuração atual" << std::endl;
+        return false;
+    }
+    publishSettings(std::move(s));
+    return true;
+}
+
+// ============== HOT RELOAD ==============
+// Thread que recarrega o config.ini quando ele muda. Observa o diretório (os
+// editores costumam salvar num temporário e renomear) e espera as escritas
+// assentarem antes de reinterpretar.
+class ConfigWatcher {
+public:
+    ~ConfigWatcher() { stop(); }
+
+    void start(const std::string& filename) {
+        stop();
+        path = filename;
+        running = true;
+        worker = std::thread([this]() { run(); });
+    }
+
+    void stop() {
+        running = false;
+        if (worker.joinable())
+            worker.join();
+    }
+
+    int reloads() const { return reloadCount.load(); }
+
+private:
+    std::string path;
+    std::thread worker;
+    std::atomic<bool> running{ false };
+    std::atomic<int> reloadCount{ 0 };
+
+    static constexpr int POLL_MS = 200;   // também é o tempo máximo para o stop()
+    static constexpr int SETTLE_MS = 50;  // junta as escritas de um mesmo salvamento
+
+    static void settle() { std::this_thread::sleep_for(std::chrono::milliseconds(SETTLE_MS)); }
+
+    void reload() {
+        if (reloadConfig(path)) {
+            int n = ++reloadCount;
+            std::cout << "[config] " << path << " recarregado (" << n << ")" << std::endl;
+        }
+    }
+
+#ifdef __linux__
+    void run() {
+        std::filesystem::path file(path);
+        std::string dir = file.has_parent_path() ? file.parent_path().string() : ".";
+        std::string name = file.filename().string();
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0 || inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+            std::cerr << "[config] inotify indisponível, sem hot reload de " << path << std::endl;
+            if (fd >= 0)
+                close(fd);
+            return;
+        }
+        alignas(inotify_event) char buffer[4096];
+        while (running) {
+            pollfd pfd = { fd, POLLIN, 0 };
+            if (poll(&pfd, 1, POLL_MS) <= 0)
+                continue;
+            bool changed = false;
+            ssize_t len;
+            while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + len;) {
+                    const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                    if (ev->len && name == ev->name)
+                        changed = true;
+                    p += sizeof(inotify_event) + ev->len;
+                }
+            }
+            if (changed) {
+                // Descarta os eventos do mesmo salvamento antes de ler o arquivo: o que
+                // chegar durante a leitura é um salvamento novo e recarrega na próxima volta
+                settle();
+                while (read(fd, buffer, sizeof(buffer)) > 0) {}
+                reload();
+            }
+        }
+        close(fd);
+    }
+#else
+    void run() {
+        std::error_code ec;
+        auto last = std::filesystem::last_write_time(path, ec);
+        while (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MS));
+            auto now = std::filesystem::last_write_time(path, ec);
+            if (!ec && now != last) {
+                settle();
+                last = std::filesystem::last_write_time(path, ec); // o que mudar depois daqui recarrega de novo
+                reload();
+            }
+        }
+    }
+#endif
+};
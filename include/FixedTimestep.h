@@ -0,0 +1,108 @@
+#pragma once
+
+// ============== PASSO FIXO DE SIMULAÇÃO ==============
+// Separa o relógio da simulação do relógio dos frames. O tempo real de cada
+// frame entra num acumulador que é consumido em passos de tamanho fixo; o que
+// sobra (alpha, entre 0 e 1) é usado para interpolar o estado desenhado entre
+// os dois últimos passos. Assim a simulação dá o mesmo resultado com 30 ou
+// 300 fps, e um frame lento só gera mais passos em vez de um passo maior.
+//
+// Com --dt X cada frame avança exatamente X segundos, ignorando o relógio
+// real: junto com --frames N a execução é reproduzível (mesmos passos, mesmo
+// estado e mesmas imagens em qualquer máquina). Nesse modo não há limite de
+// passos por frame: um --dt grande só gera mais passos.
+//
+// Uso:
+//   FixedTimestep relogio(argc, argv, 1.0 / 120.0);
+//   while (...) {
+//       relogio.beginFrame(glfwGetTime());
+//       while (relogio.step()) { anterior = atual; simular(atual, relogio.stepSize()); }
+//       desenhar(interpolar(anterior, atual, relogio.alpha()));
+//   }
+
+#include <string>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+class FixedTimestep {
+public:
+    FixedTimestep(int argc, char** argv, double step = 1.0 / 120.0) : dt(step)
+    {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--dt" && i + 1 < argc)
+                fixedFrame = std::atof(argv[++i]);
+        }
+        if (fixedFrame < 0.0)
+            fixedFrame = 0.0;
+    }
+
+    void setStepSize(double step) { dt = step > 0.0 ? step : dt; }
+    void setMaxSteps(int n) { maxSteps = std::max(1, n); }
+
+    bool isDeterministic() const { return fixedFrame > 0.0; }
+    double stepSize() const { return dt; }
+    double frameDelta() const { return frameDt; }   // tempo do frame (real ou --dt)
+    double time() const { return simTime; }          // tempo simulado até o último passo
+    double alpha() const { return accumulator / dt; }
+    long long steps() const { return totalSteps; }
+    long long droppedSteps() const { return dropped; }
+
+    void printSummary() const
+    {
+        std::cout << "[simulacao] " << (isDeterministic() ? "deterministico" : "tempo real") << ": " << totalSteps
+                  << " passos de " << dt * 1000.0 << " ms (" << simTime << " s simulados";
+        if (isDeterministic())
+            std::cout << ", " << fixedFrame * 1000.0 << " ms por frame)" << std::endl;
+        else
+            std::cout << ", " << dropped << " passos descartados)" << std::endl;
+    }
+
+    // Soma o tempo do frame ao acumulador; 'now' só é usado fora do modo determinístico
+    void beginFrame(double now)
+    {
+        if (isDeterministic()) {
+            frameDt = fixedFrame;
+        } else {
+            frameDt = started ? now - lastTime : 0.0;
+            frameDt = std::min(std::max(frameDt, 0.0), maxFrame); // pausa no depurador, janela arrastada...
+            lastTime = now;
+            started = true;
+        }
+        accumulator += frameDt;
+        stepsThisFrame = 0;
+    }
+
+    // Verdadeiro enquanto houver um passo a simular neste frame
+    bool step()
+    {
+        if (accumulator < dt)
+            return false;
+        // O limite só vale em tempo real: com --dt todo o tempo do frame é simulado
+        if (!isDeterministic() && stepsThisFrame == maxSteps) {
+            // Não alcança o tempo real: descarta o atraso em vez de acumular (espiral da morte)
+            dropped += (long long)(accumulator / dt);
+            accumulator = std::fmod(accumulator, dt);
+            return false;
+        }
+        accumulator -= dt;
+        simTime += dt;
+        stepsThisFrame++;
+        totalSteps++;
+        return true;
+    }
+
+private:
+    double dt;
+    double fixedFrame = 0.0;
+    double maxFrame = 0.25;
+    int maxSteps = 8;
+
+    bool started = false;
+    double lastTime = 0.0, frameDt = 0.0;
+    double accumulator = 0.0, simTime = 0.0;
+    int stepsThisFrame = 0;
+    long long totalSteps = 0, dropped = 0;
+};
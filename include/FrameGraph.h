@@ -0,0 +1,658 @@
+#pragma once
+
+// ============== FRAME GRAPH ==============
+// Grafo de passes de renderização. Cada pass declara os attachments que lê e
+// escreve e o estado de pipeline que espera; a partir disso compile():
+//   - ordena os passes (quem escreve um recurso roda antes de quem o lê;
+//     vários escritores do mesmo recurso mantêm a ordem de declaração);
+//   - descarta passes cujas saídas ninguém usa;
+//   - calcula o tempo de vida de cada textura transiente e reaproveita
+//     (aliasing) texturas físicas compatíveis que já não estão em uso;
+//   - monta os FBOs de cada pass.
+// execute() roda os passes e emite só as mudanças de estado necessárias.
+//
+// Novos passes (shadow map, pós-processamento, overlays) são registrados com
+// addPass() sem mexer no loop principal. Os callbacks não devem alterar o
+// estado descrito em RenderState; se precisarem, chamem invalidateState().
+//
+// Com enableGpuTimings(true) cada pass é envolvido por uma query
+// GL_TIME_ELAPSED; o resultado é lido TIMER_FRAMES frames depois, sem travar
+// a CPU esperando a GPU.
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <iostream>
+#include <algorithm>
+
+#include <glad/glad.h>
+
+#include <Profiler.h>
+
+struct RenderState {
+    bool depthTest = true;
+    bool depthWrite = true;
+    bool polygonOffset = false;
+    float offsetFactor = 0.0f, offsetUnits = 0.0f;
+    bool cullFace = false;
+    bool blend = false;
+    GLenum blendSrc = GL_ONE, blendDst = GL_ZERO;
+    bool stencilTest = false;
+
+    GLbitfield clear = 0; // GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT ...
+    float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    float viewport[4] = { 0.0f, 0.0f, 1.0f, 1.0f }; // fração do alvo (x, y, largura, altura)
+};
+
+struct FrameGraphTextureDesc {
+    int width = 0, height = 0;
+    GLenum internalFormat = GL_RGBA8;
+    GLenum filter = GL_LINEAR;
+
+    bool operator==(const FrameGraphTextureDesc& o) const
+    {
+        return width == o.width && height == o.height && internalFormat == o.internalFormat && filter == o.filter;
+    }
+};
+
+class FrameGraph;
+
+// Passado para o callback de cada pass
+class FrameGraphContext {
+public:
+    GLuint texture(int resource) const;
+    int width() const { return targetWidth; }
+    int height() const { return targetHeight; }
+
+private:
+    friend class FrameGraph;
+    const FrameGraph* graph = nullptr;
+    int targetWidth = 0, targetHeight = 0;
+};
+
+class FrameGraph {
+public:
+    struct Pass;
+
+    // Declaração dos recursos e dependências de um pass
+    class Builder {
+    public:
+        void read(int resource) { pass().reads.push_back(resource); graph->dirty = true; }
+        void write(int resource) { pass().writes.push_back(resource); graph->dirty = true; }
+        void setState(const RenderState& state) { pass().state = state; }
+        void sideEffect() { pass().sideEffect = true; } // nunca é descartado
+
+    private:
+        friend class FrameGraph;
+        FrameGraph* graph;
+        int index;
+        Builder(FrameGraph* g, int i) : graph(g), index(i) {}
+        Pass& pass();
+    };
+
+    // Framebuffer externo (0 = janela); sempre considerado uma saída do frame
+    int importFramebuffer(const std::string& name, GLuint fbo, int width, int height)
+    {
+        Resource r;
+        r.name = name;
+        r.imported = true;
+        r.fbo = fbo;
+        r.desc.width = width;
+        r.desc.height = height;
+        resources.push_back(r);
+        dirty = true;
+        return (int)resources.size() - 1;
+    }
+
+    void resizeImported(int resource, int width, int height)
+    {
+        resources[resource].desc.width = width;
+        resources[resource].desc.height = height;
+    }
+
+    // Textura transiente: só existe enquanto algum pass a usa
+    int createTexture(const std::string& name, const FrameGraphTextureDesc& desc)
+    {
+        Resource r;
+        r.name = name;
+        r.desc = desc;
+        resources.push_back(r);
+        dirty = true;
+        return (int)resources.size() - 1;
+    }
+
+    void setTextureDesc(int resource, const FrameGraphTextureDesc& desc)
+    {
+        if (!(resources[resource].desc == desc)) {
+            resources[resource].desc = desc;
+            dirty = true;
+        }
+    }
+
+    int addPass(const std::string& name, const std::function<void(Builder&)>& setup, const std::function<void(FrameGraphContext&)>& execute)
+    {
+        Pass p;
+        p.name = name;
+        p.execute = execute;
+        passes.push_back(p);
+        Builder b(this, (int)passes.size() - 1);
+        setup(b);
+        dirty = true;
+        return (int)passes.size() - 1;
+    }
+
+    void setEnabled(int pass, bool enabled)
+    {
+        if (passes[pass].enabled != enabled) {
+            passes[pass].enabled = enabled;
+            dirty = true;
+        }
+    }
+
+    bool isCulled(int pass) const { return passes[pass].culled; }
+
+    void enableGpuTimings(bool enabled) { timings = enabled; }
+
+    // Média móvel do tempo de GPU do pass, em ms
+    double gpuTimeMs(int pass) const { return passes[pass].gpuMs; }
+
+    void compile()
+    {
+        dirty = false;
+        computeOrder();
+        cullPasses();
+        allocateResources();
+        buildFramebuffers();
+    }
+
+    void execute()
+    {
+        if (dirty)
+            compile();
+
+        FrameGraphContext ctx;
+        ctx.graph = this;
+        int slot = frameIndex++ % TIMER_FRAMES;
+        for (int p : order) {
+            Pass& pass = passes[p];
+            if (pass.culled)
+                continue;
+            ProfileScope scope(pass.name.c_str());
+            if (timings)
+                beginTimer(pass, slot);
+
+            GLuint fbo = 0;
+            int w = 0, h = 0;
+            targetOf(pass, fbo, w, h);
+            if (fbo != boundFbo) {
+                glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+                boundFbo = fbo;
+                stateCalls++;
+            }
+
+            applyState(pass.state, w, h);
+            if (pass.state.clear) {
+                // glClear respeita a máscara de profundidade
+                bool maskDepth = (pass.state.clear & GL_DEPTH_BUFFER_BIT) && !pass.state.depthWrite;
+                if (maskDepth)
+                    glDepthMask(GL_TRUE);
+                glClear(pass.state.clear);
+                if (maskDepth)
+                    glDepthMask(GL_FALSE);
+                stateCalls++;
+            }
+
+            ctx.targetWidth = w;
+            ctx.targetHeight = h;
+            pass.execute(ctx);
+            if (timings)
+                glEndQuery(GL_TIME_ELAPSED);
+        }
+    }
+
+    // Os callbacks podem mexer no estado do GL por conta própria; isso força reaplicar tudo
+    void invalidateState() { stateKnown = offsetKnown = blendFuncKnown = clearColorKnown = false; boundFbo = ~0u; }
+
+    void printSummary() const
+    {
+        std::cout << "[frame graph] ordem:";
+        for (int p : order)
+            std::cout << " " << passes[p].name << (passes[p].culled ? "(descartado)" : "");
+        std::cout << " | " << physical.size() << " texturas físicas para " << transientCount << " transientes" << std::endl;
+    }
+
+    void printGpuTimings() const
+    {
+        double total = 0.0;
+        std::cout << "[frame graph] GPU:";
+        for (int p : order) {
+            if (passes[p].culled)
+                continue;
+            std::cout << " " << passes[p].name << " " << passes[p].gpuMs << " ms |";
+            total += passes[p].gpuMs;
+        }
+        std::cout << " total " << total << " ms" << std::endl;
+    }
+
+    int stateChangeCount() const { return stateCalls; }
+    int stateSkipCount() const { return stateSkips; }
+
+    // Apaga texturas e FBOs (chamar com o contexto ainda ativo)
+    void release()
+    {
+        for (PhysicalTexture& t : physical)
+            glDeleteTextures(1, &t.id);
+        for (auto& kv : fboCache)
+            glDeleteFramebuffers(1, &kv.second);
+        for (Pass& p : passes) {
+            if (p.queries[0])
+                glDeleteQueries(TIMER_FRAMES, p.queries);
+            std::fill(p.queries, p.queries + TIMER_FRAMES, 0u);
+            std::fill(p.pending, p.pending + TIMER_FRAMES, false);
+        }
+        physical.clear();
+        fboCache.clear();
+        dirty = true;
+    }
+
+private:
+    friend class FrameGraphContext;
+
+    struct Resource {
+        std::string name;
+        FrameGraphTextureDesc desc;
+        bool imported = false;
+        GLuint fbo = 0;     // para recursos importados
+        int physical = -1;  // índice em physical (transientes)
+        int firstUse = -1, lastUse = -1;
+    };
+
+    struct PhysicalTexture {
+        GLuint id = 0;
+        FrameGraphTextureDesc desc;
+        int busyUntil = -1; // posição na ordem de execução do último uso
+    };
+
+public:
+    static const int TIMER_FRAMES = 4; // frames de atraso na leitura das queries
+
+    struct Pass {
+        std::string name;
+        std::vector<int> reads, writes;
+        RenderState state;
+        std::function<void(FrameGraphContext&)> execute;
+        bool enabled = true;
+        bool sideEffect = false;
+        bool culled = false;
+        GLuint fbo = 0;
+
+        GLuint queries[TIMER_FRAMES] = {};
+        bool pending[TIMER_FRAMES] = {};
+        double gpuMs = 0.0;
+    };
+
+private:
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+    std::vector<int> order;
+    std::vector<PhysicalTexture> physical;
+    std::map<std::vector<GLuint>, GLuint> fboCache;
+    int transientCount = 0;
+    bool dirty = true;
+
+    // Estado atual do GL, para emitir só as diferenças
+    RenderState current;
+    bool stateKnown = false;
+    // Offset, blend func e cor de limpeza só são emitidos com o recurso em uso:
+    // valem a partir da primeira emissão
+    bool offsetKnown = false, blendFuncKnown = false, clearColorKnown = false;
+    GLuint boundFbo = ~0u;
+    int currentViewport[4] = { 0, 0, 0, 0 };
+    float clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    int stateCalls = 0, stateSkips = 0;
+
+    bool timings = false;
+    int frameIndex = 0;
+
+    static bool isDepthFormat(GLenum f)
+    {
+        return f == GL_DEPTH_COMPONENT16 || f == GL_DEPTH_COMPONENT24 || f == GL_DEPTH_COMPONENT32 || f == GL_DEPTH_COMPONENT32F ||
+               f == GL_DEPTH24_STENCIL8 || f == GL_DEPTH32F_STENCIL8;
+    }
+
+    static bool hasStencil(GLenum f) { return f == GL_DEPTH24_STENCIL8 || f == GL_DEPTH32F_STENCIL8; }
+
+    // Ordenação topológica (Kahn) com desempate pela ordem de declaração
+    void computeOrder()
+    {
+        int n = (int)passes.size();
+        std::vector<std::vector<int>> edges(n);
+        std::vector<int> indegree(n, 0);
+        auto addEdge = [&](int from, int to) {
+            if (from == to || std::find(edges[from].begin(), edges[from].end(), to) != edges[from].end())
+                return;
+            edges[from].push_back(to);
+            indegree[to]++;
+        };
+
+        for (int r = 0; r < (int)resources.size(); r++) {
+            std::vector<int> writers, readers;
+            for (int p = 0; p < n; p++) {
+                if (!passes[p].enabled)
+                    continue;
+                const Pass& pass = passes[p];
+                bool writes = std::find(pass.writes.begin(), pass.writes.end(), r) != pass.writes.end();
+                bool reads = std::find(pass.reads.begin(), pass.reads.end(), r) != pass.reads.end();
+                if (writes)
+                    writers.push_back(p);
+                else if (reads)
+                    readers.push_back(p);
+            }
+            for (size_t i = 1; i < writers.size(); i++)
+                addEdge(writers[i - 1], writers[i]);
+            for (int w : writers)
+                for (int rd : readers)
+                    addEdge(w, rd);
+        }
+
+        order.clear();
+        std::vector<bool> done(n, false);
+        for (int step = 0; step < n; step++) {
+            int next = -1;
+            for (int p = 0; p < n && next < 0; p++)
+                if (!done[p] && indegree[p] == 0)
+                    next = p;
+            if (next < 0) {
+                std::cerr << "[frame graph] ciclo entre passes, usando a ordem de declaração" << std::endl;
+                order.clear();
+                for (int p = 0; p < n; p++)
+                    order.push_back(p);
+                return;
+            }
+            done[next] = true;
+            order.push_back(next);
+            for (int to : edges[next])
+                indegree[to]--;
+        }
+    }
+
+    // Mantém só os passes que contribuem (direta ou indiretamente) para um recurso importado
+    void cullPasses()
+    {
+        std::vector<bool> needed(resources.size(), false);
+        for (size_t r = 0; r < resources.size(); r++)
+            needed[r] = resources[r].imported;
+
+        for (Pass& p : passes)
+            p.culled = true;
+
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            Pass& p = passes[*it];
+            if (!p.enabled)
+                continue;
+            bool useful = p.sideEffect;
+            for (int w : p.writes)
+                useful = useful || needed[w];
+            if (!useful)
+                continue;
+            p.culled = false;
+            for (int r : p.reads)
+                needed[r] = true;
+        }
+    }
+
+    void allocateResources()
+    {
+        for (Resource& r : resources) {
+            r.firstUse = r.lastUse = -1;
+            r.physical = -1;
+        }
+        for (int i = 0; i < (int)order.size(); i++) {
+            const Pass& p = passes[order[i]];
+            if (p.culled)
+                continue;
+            auto touch = [&](int r) {
+                if (resources[r].firstUse < 0)
+                    resources[r].firstUse = i;
+                resources[r].lastUse = i;
+            };
+            for (int r : p.reads) touch(r);
+            for (int r : p.writes) touch(r);
+        }
+
+        for (PhysicalTexture& t : physical)
+            t.busyUntil = -1;
+
+        transientCount = 0;
+        std::vector<bool> used(physical.size(), false);
+        for (int i = 0; i < (int)order.size(); i++) {
+            for (int r = 0; r < (int)resources.size(); r++) {
+                Resource& res = resources[r];
+                if (res.imported || res.firstUse != i)
+                    continue;
+                transientCount++;
+
+                // Reaproveita uma textura compatível cujo último uso já passou
+                int chosen = -1;
+                for (int t = 0; t < (int)physical.size() && chosen < 0; t++)
+                    if (physical[t].desc == res.desc && physical[t].busyUntil < i)
+                        chosen = t;
+                if (chosen < 0) {
+                    physical.push_back(createPhysical(res.desc));
+                    used.push_back(false);
+                    chosen = (int)physical.size() - 1;
+                }
+                physical[chosen].busyUntil = res.lastUse;
+                used[chosen] = true;
+                res.physical = chosen;
+            }
+        }
+
+        // Libera texturas que não servem mais (ex.: depois de redimensionar a janela)
+        for (int t = (int)physical.size() - 1; t >= 0; t--) {
+            if (used[t])
+                continue;
+            for (auto it = fboCache.begin(); it != fboCache.end();) {
+                if (std::find(it->first.begin(), it->first.end(), physical[t].id) != it->first.end()) {
+                    glDeleteFramebuffers(1, &it->second);
+                    it = fboCache.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            glDeleteTextures(1, &physical[t].id);
+            physical.erase(physical.begin() + t);
+            for (Resource& r : resources)
+                if (r.physical > t)
+                    r.physical--;
+        }
+    }
+
+    static PhysicalTexture createPhysical(const FrameGraphTextureDesc& desc)
+    {
+        PhysicalTexture t;
+        t.desc = desc;
+        glGenTextures(1, &t.id);
+        glBindTexture(GL_TEXTURE_2D, t.id);
+        GLenum format = GL_RGBA, type = GL_UNSIGNED_BYTE;
+        if (isDepthFormat(desc.internalFormat)) {
+            format = hasStencil(desc.internalFormat) ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT;
+            type = hasStencil(desc.internalFormat) ? GL_UNSIGNED_INT_24_8 : GL_FLOAT;
+            if (desc.internalFormat == GL_DEPTH32F_STENCIL8)
+                type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+        }
+        glTexImage2D(GL_TEXTURE_2D, 0, desc.internalFormat, desc.width, desc.height, 0, format, type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, desc.filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, desc.filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return t;
+    }
+
+    void buildFramebuffers()
+    {
+        for (Pass& p : passes) {
+            p.fbo = 0;
+            if (p.culled)
+                continue;
+
+            std::vector<GLuint> key;
+            bool imported = false;
+            for (int w : p.writes) {
+                if (resources[w].imported) {
+                    p.fbo = resources[w].fbo;
+                    imported = true;
+                } else {
+                    key.push_back(physical[resources[w].physical].id);
+                }
+            }
+            if (imported || key.empty())
+                continue;
+
+            auto it = fboCache.find(key);
+            if (it != fboCache.end()) {
+                p.fbo = it->second;
+                continue;
+            }
+
+            GLuint fbo;
+            glGenFramebuffers(1, &fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            std::vector<GLenum> drawBuffers;
+            for (int w : p.writes) {
+                const Resource& r = resources[w];
+                GLuint tex = physical[r.physical].id;
+                if (isDepthFormat(r.desc.internalFormat)) {
+                    GLenum attachment = hasStencil(r.desc.internalFormat) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+                    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, tex, 0);
+                } else {
+                    GLenum attachment = GL_COLOR_ATTACHMENT0 + (GLenum)drawBuffers.size();
+                    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, tex, 0);
+                    drawBuffers.push_back(attachment);
+                }
+            }
+            if (drawBuffers.empty()) {
+                glDrawBuffer(GL_NONE);
+                glReadBuffer(GL_NONE);
+            } else {
+                glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+            }
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+                std::cerr << "[frame graph] FBO incompleto no pass '" << p.name << "'" << std::endl;
+            fboCache[key] = fbo;
+            p.fbo = fbo;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        boundFbo = 0;
+    }
+
+    // Lê o resultado que ocupava este slot (emitido TIMER_FRAMES frames atrás) e reabre a query
+    void beginTimer(Pass& pass, int slot)
+    {
+        if (!pass.queries[0])
+            glGenQueries(TIMER_FRAMES, pass.queries);
+        GLuint q = pass.queries[slot];
+        if (pass.pending[slot]) {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(q, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                GLuint64 ns = 0;
+                glGetQueryObjectui64v(q, GL_QUERY_RESULT, &ns);
+                double ms = ns / 1.0e6;
+                pass.gpuMs = pass.gpuMs == 0.0 ? ms : pass.gpuMs * 0.9 + ms * 0.1;
+            }
+            pass.pending[slot] = false;
+        }
+        glBeginQuery(GL_TIME_ELAPSED, q);
+        pass.pending[slot] = true;
+    }
+
+    void targetOf(const Pass& pass, GLuint& fbo, int& w, int& h) const
+    {
+        fbo = pass.fbo;
+        w = h = 0;
+        if (!pass.writes.empty()) {
+            const Resource& r = resources[pass.writes[0]];
+            w = r.desc.width;
+            h = r.desc.height;
+        }
+    }
+
+    void applyState(const RenderState& s, int w, int h)
+    {
+        auto toggle = [&](bool want, bool have, GLenum cap) {
+            if (stateKnown && want == have) {
+                stateSkips++;
+                return;
+            }
+            if (want)
+                glEnable(cap);
+            else
+                glDisable(cap);
+            stateCalls++;
+        };
+
+        toggle(s.depthTest, current.depthTest, GL_DEPTH_TEST);
+        toggle(s.polygonOffset, current.polygonOffset, GL_POLYGON_OFFSET_FILL);
+        toggle(s.cullFace, current.cullFace, GL_CULL_FACE);
+        toggle(s.blend, current.blend, GL_BLEND);
+        toggle(s.stencilTest, current.stencilTest, GL_STENCIL_TEST);
+
+        if (!stateKnown || s.depthWrite != current.depthWrite) {
+            glDepthMask(s.depthWrite ? GL_TRUE : GL_FALSE);
+            stateCalls++;
+        }
+        if (s.polygonOffset && (!offsetKnown || s.offsetFactor != current.offsetFactor || s.offsetUnits != current.offsetUnits)) {
+            glPolygonOffset(s.offsetFactor, s.offsetUnits);
+            stateCalls++;
+        }
+        if (s.blend && (!blendFuncKnown || s.blendSrc != current.blendSrc || s.blendDst != current.blendDst)) {
+            glBlendFunc(s.blendSrc, s.blendDst);
+            stateCalls++;
+        }
+        if (s.clear & GL_COLOR_BUFFER_BIT) {
+            bool same = clearColorKnown && std::equal(s.clearColor, s.clearColor + 4, clearColor);
+            if (!same) {
+                glClearColor(s.clearColor[0], s.clearColor[1], s.clearColor[2], s.clearColor[3]);
+                std::copy(s.clearColor, s.clearColor + 4, clearColor);
+                clearColorKnown = true;
+                stateCalls++;
+            }
+        }
+
+        int vp[4] = { (int)(s.viewport[0] * w), (int)(s.viewport[1] * h), (int)(s.viewport[2] * w), (int)(s.viewport[3] * h) };
+        if (!stateKnown || !std::equal(vp, vp + 4, currentViewport)) {
+            glViewport(vp[0], vp[1], vp[2], vp[3]);
+            std::copy(vp, vp + 4, currentViewport);
+            stateCalls++;
+        }
+
+        // Com o recurso desligado os parâmetros não foram emitidos: current guarda os do GL
+        RenderState previous = current;
+        current = s;
+        if (s.polygonOffset)
+            offsetKnown = true;
+        else {
+            current.offsetFactor = previous.offsetFactor;
+            current.offsetUnits = previous.offsetUnits;
+        }
+        if (s.blend)
+            blendFuncKnown = true;
+        else {
+            current.blendSrc = previous.blendSrc;
+            current.blendDst = previous.blendDst;
+        }
+        stateKnown = true;
+    }
+
+};
+
+inline FrameGraph::Pass& FrameGraph::Builder::pass() { return graph->passes[index]; }
+
+inline GLuint FrameGraphContext::texture(int resource) const
+{
+    const auto& r = graph->resources[resource];
+    return r.physical >= 0 ? graph->physical[r.physical].id : 0;
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+// ============== FRAME PACING ==============
+// Controla a apresentação dos frames, no lugar de chamar glfwSwapBuffers o
+// mais rápido que o driver deixar:
+//   - modo vsync (glfwSwapInterval(1)), sem limite (intervalo 0) ou FPS alvo
+//     (intervalo 0 + limitador por tempo);
+//   - a CPU fica no máximo N frames à frente da GPU: cada frame termina com
+//     um glFenceSync e, antes de começar o próximo, espera (glClientWaitSync)
+//     a fence de N frames atrás;
+//   - o limitador dorme com sleep_for enquanto o atraso estimado do sleep do
+//     sistema couber no tempo restante e termina em spin, em vez de ocupar um
+//     núcleo o frame inteiro (a estimativa se adapta à granularidade do
+//     sistema, ~1 ms no Linux, até ~15 ms no Windows sem timeBeginPeriod);
+//   - registra o intervalo entre apresentações (anel com os últimos 65536) e
+//     imprime média, desvio, percentis, jitter (variação entre frames
+//     seguidos) e frames atrasados.
+//
+// O Headless cria o FramePacer com os mesmos argumentos e o chama em
+// makeCurrent() e swapBuffers(), então todos os exercícios passam por ele;
+// o resumo sai quando o programa termina.
+// Opções de linha de comando:
+//   --vsync              sincroniza com o monitor (padrão com janela)
+//   --uncapped           sem vsync e sem limite (padrão no headless)
+//   --fps N              sem vsync, limitado a N frames por segundo
+//   --frames-ahead N     frames de CPU à frente da GPU (1 a 4, padrão 2)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define FRAMEPACER_PAUSE() _mm_pause()
+#else
+#define FRAMEPACER_PAUSE() std::this_thread::yield()
+#endif
+
+enum class PacingMode { VSync, Uncapped, TargetFps };
+
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FramePacer() = default;
+    FramePacer(int argc, char** argv, bool headless)
+    {
+        mode = headless ? PacingMode::Uncapped : PacingMode::VSync;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--vsync")
+                mode = PacingMode::VSync;
+            else if (arg == "--uncapped")
+                mode = PacingMode::Uncapped;
+            else if (arg == "--fps" && hasValue) {
+                mode = PacingMode::TargetFps;
+                targetFps = std::atof(argv[++i]);
+            } else if (arg == "--frames-ahead" && hasValue)
+                maxAhead = std::atoi(argv[++i]);
+        }
+        if (targetFps <= 0.0)
+            mode = PacingMode::Uncapped;
+        maxAhead = std::min(std::max(maxAhead, 1), 4);
+        if (headless && mode == PacingMode::VSync)
+            mode = PacingMode::Uncapped; // sem monitor para sincronizar
+    }
+
+    // Com o contexto atual: intervalo de troca de buffers
+    void init(bool hasSwapChain)
+    {
+        if (hasSwapChain)
+            glfwSwapInterval(mode == PacingMode::VSync ? 1 : 0);
+        last = Clock::now();
+        deadline = last;
+        std::printf("[pacing] %s, até %d frames à frente da GPU\n", describe().c_str(), maxAhead);
+    }
+
+    // Depois do swap: fence do frame, espera a GPU alcançar, limitador e estatísticas
+    void frameEnd()
+    {
+        fences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        auto t0 = Clock::now();
+        while ((int)fences.size() > maxAhead) {
+            // GL_SYNC_FLUSH_COMMANDS_BIT: garante que a fence chegou à GPU
+            while (glClientWaitSync(fences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, 100000000) == GL_TIMEOUT_EXPIRED) {
+            }
+            glDeleteSync(fences.front());
+            fences.pop_front();
+        }
+        auto t1 = Clock::now();
+        gpuWaitMs += ms(t1 - t0);
+
+        if (mode == PacingMode::TargetFps) {
+            auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps));
+            deadline += period;
+            if (deadline < t1) {
+                // Atrasou mais de um frame: recomeça a grade em vez de acelerar para compensar
+                if (t1 - deadline > period)
+                    deadline = t1;
+                late++;
+            }
+            sleepUntil(deadline);
+        }
+
+        auto now = Clock::now();
+        double frameMs = ms(now - last);
+        last = now;
+        if (frames++ > 0)
+            add(frameMs);
+    }
+
+    std::string describe() const
+    {
+        char buf[64];
+        if (mode == PacingMode::VSync)
+            return "vsync";
+        if (mode == PacingMode::Uncapped)
+            return "sem limite";
+        std::snprintf(buf, sizeof(buf), "%.1f fps alvo", targetFps);
+        return buf;
+    }
+
+    // Sessões longas: média, desvio, percentis e jitter são dos últimos MAX_SAMPLES frames
+    void printSummary() const
+    {
+        if (times.size() < 2)
+            return;
+        std::vector<double> ordered = frameTimes();
+        std::vector<double> s = ordered;
+        std::sort(s.begin(), s.end());
+        double sum = 0.0, sq = 0.0, jitter = 0.0;
+        for (size_t i = 0; i < ordered.size(); i++) {
+            sum += ordered[i];
+            sq += ordered[i] * ordered[i];
+            if (i > 0)
+                jitter += std::fabs(ordered[i] - ordered[i - 1]);
+        }
+        double n = (double)ordered.size();
+        double mean = sum / n;
+        double stddev = std::sqrt(std::max(0.0, sq / n - mean * mean));
+        auto pct = [&](double p) { return s[std::min(s.size() - 1, (size_t)(p * s.size()))]; };
+        std::printf("[pacing] %s: %zu frames", describe().c_str(), times.size());
+        if (frames - 1 > (long long)times.size())
+            std::printf(" (os últimos de %lld)", frames - 1);
+        std::printf(", média %.2f ms (%.1f fps), desvio %.2f ms, jitter %.2f ms\n", mean, 1000.0 / mean, stddev,
+                    jitter / (n - 1));
+        std::printf("[pacing] p50 %.2f, p90 %.2f, p99 %.2f, máx %.2f ms | por frame: espera da GPU %.3f ms, "
+                    "sleep %.3f ms, spin %.3f ms",
+                    pct(0.5), pct(0.9), pct(0.99), s.back(), gpuWaitMs / frames, sleptMs / frames, spunMs / frames);
+        if (mode == PacingMode::TargetFps)
+            std::printf(", %lld frames atrasados", late);
+        std::printf("\n");
+    }
+
+    PacingMode pacingMode() const { return mode; }
+
+    // Intervalos registrados, do mais antigo ao mais recente
+    std::vector<double> frameTimes() const
+    {
+        std::vector<double> t(times.begin() + next, times.end());
+        t.insert(t.end(), times.begin(), times.begin() + next);
+        return t;
+    }
+
+private:
+    static constexpr size_t MAX_SAMPLES = 1 << 16;
+
+    PacingMode mode = PacingMode::VSync;
+    double targetFps = 60.0;
+    int maxAhead = 2;
+    std::deque<GLsync> fences;
+    Clock::time_point last, deadline;
+    std::vector<double> times; // ms entre apresentações; cheio, vira anel
+    size_t next = 0;           // a mais antiga (e a próxima sobrescrita) com o anel cheio
+    long long frames = 0, late = 0;
+    double gpuWaitMs = 0.0, sleptMs = 0.0, spunMs = 0.0;
+
+    // Atraso real de sleep_for(1 ms), média + desvio (Welford)
+    double sleepMean = 1.0, sleepM2 = 0.0;
+    long long sleepSamples = 1;
+
+    static double ms(Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+
+    void add(double frameMs)
+    {
+        if (times.size() < MAX_SAMPLES) {
+            times.push_back(frameMs);
+        } else {
+            times[next] = frameMs;
+            next = (next + 1) % MAX_SAMPLES;
+        }
+    }
+
+    void sleepUntil(Clock::time_point target)
+    {
+        auto t0 = Clock::now();
+        for (;;) {
+            double remaining = ms(target - Clock::now());
+            double estimate = sleepMean + std::sqrt(sleepM2 / sleepSamples);
+            if (remaining <= estimate)
+                break;
+            auto s0 = Clock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            double observed = ms(Clock::now() - s0);
+            sleepSamples++;
+            double delta = observed - sleepMean;
+            sleepMean += delta / sleepSamples;
+            sleepM2 += delta * (observed - sleepMean);
+        }
+        auto t1 = Clock::now();
+        while (Clock::now() < target)
+            FRAMEPACER_PAUSE();
+        sleptMs += ms(t1 - t0);
+        spunMs += ms(Clock::now() - t1);
+    }
+};
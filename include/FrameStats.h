@@ -0,0 +1,409 @@
+#pragma once
+
+// ============== ESTATÍSTICAS DE FRAME ==============
+// Registra cada frame num anel pré-alocado (sem alocação no frame) e exporta
+// CSV + JSON para comparar builds e achar travadas:
+//   - frame_ms: entre apresentações (o que a tela mostra);
+//   - cpu_ms: da volta do swap anterior (ou de workBegin(), quando a thread
+//     espera o trabalho do frame chegar) até este swap, sem a espera do
+//     FramePacer nem a da fila de quadros (trabalho da thread que desenha);
+//   - gpu_ms: dois glQueryCounter(GL_TIMESTAMP) por frame, no começo e no
+//     fim dos comandos; lidos alguns frames depois, sem travar (timestamps e
+//     não GL_TIME_ELAPSED: convivem com as queries do FrameGraph);
+//   - draw calls e triângulos: os ponteiros do glad para glDraw* passam por
+//     funções que contam e chamam o original (o indireto conta a chamada,
+//     sem triângulos; pontos e linhas não contam triângulos).
+// O relatório tem p50/p90/p99/p99.9 e máximo de cada coluna, os piores
+// frames com o horário e um histograma do frame_ms.
+//
+// O Headless cria o FrameStats com os mesmos argumentos e o chama em
+// swapBuffers(), então todos os exercícios registram; o primeiro frame
+// (carregamento) fica de fora. Para exportar no meio da execução o exercício
+// chama requestExport() (a CenaFinal liga isso ao F12 pelo Input).
+// Opções de linha de comando:
+//   --stats ARQ          grava ARQ.csv e ARQ.json ao sair (e a cada requestExport(), com o número do frame)
+//   --stats-frames N     tamanho do anel (últimos N frames, padrão 65536)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+struct FrameSample {
+    uint32_t frame;
+    double time;   // s desde o início do registro, no fim do frame
+    float frameMs, cpuMs;
+    float gpuMs;   // < 0: resultado ainda não lido (últimos frames antes de sair)
+    uint32_t drawCalls, triangles;
+};
+
+// ==== CONTADORES DE DESENHO ====
+// Só a thread do GL desenha: contadores simples
+struct DrawCounters {
+    static inline uint32_t drawCalls = 0, triangles = 0;
+
+    static inline PFNGLDRAWARRAYSPROC drawArrays = nullptr;
+    static inline PFNGLDRAWELEMENTSPROC drawElements = nullptr;
+    static inline PFNGLDRAWARRAYSINSTANCEDPROC drawArraysInstanced = nullptr;
+    static inline PFNGLDRAWELEMENTSINSTANCEDPROC drawElementsInstanced = nullptr;
+    static inline PFNGLDRAWARRAYSINDIRECTPROC drawArraysIndirect = nullptr;
+
+    // Troca os ponteiros do glad; de novo se um gladLoadGLLoader posterior os restaurou
+    static void install()
+    {
+        if (glad_glDrawArrays && glad_glDrawArrays != &countDrawArrays) {
+            drawArrays = glad_glDrawArrays;
+            glad_glDrawArrays = &countDrawArrays;
+        }
+        if (glad_glDrawElements && glad_glDrawElements != &countDrawElements) {
+            drawElements = glad_glDrawElements;
+            glad_glDrawElements = &countDrawElements;
+        }
+        if (glad_glDrawArraysInstanced && glad_glDrawArraysInstanced != &countDrawArraysInstanced) {
+            drawArraysInstanced = glad_glDrawArraysInstanced;
+            glad_glDrawArraysInstanced = &countDrawArraysInstanced;
+        }
+        if (glad_glDrawElementsInstanced && glad_glDrawElementsInstanced != &countDrawElementsInstanced) {
+            drawElementsInstanced = glad_glDrawElementsInstanced;
+            glad_glDrawElementsInstanced = &countDrawElementsInstanced;
+        }
+        if (glad_glDrawArraysIndirect && glad_glDrawArraysIndirect != &countDrawArraysIndirect) {
+            drawArraysIndirect = glad_glDrawArraysIndirect;
+            glad_glDrawArraysIndirect = &countDrawArraysIndirect;
+        }
+    }
+
+    static uint32_t trianglesOf(GLenum mode, GLsizei count)
+    {
+        if (mode == GL_TRIANGLES)
+            return (uint32_t)count / 3;
+        if (mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN)
+            return count > 2 ? (uint32_t)count - 2 : 0;
+        return 0;
+    }
+
+private:
+    static void APIENTRY countDrawArrays(GLenum mode, GLint first, GLsizei count)
+    {
+        drawCalls++;
+        triangles += trianglesOf(mode, count);
+        drawArrays(mode, first, count);
+    }
+
+    static void APIENTRY countDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+    {
+        drawCalls++;
+        triangles += trianglesOf(mode, count);
+        drawElements(mode, count, type, indices);
+    }
+
+    static void APIENTRY countDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+    {
+        drawCalls++;
+        triangles += trianglesOf(mode, count) * (uint32_t)instances;
+        drawArraysInstanced(mode, first, count, instances);
+    }
+
+    static void APIENTRY countDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+                                                    GLsizei instances)
+    {
+        drawCalls++;
+        triangles += trianglesOf(mode, count) * (uint32_t)instances;
+        drawElementsInstanced(mode, count, type, indices, instances);
+    }
+
+    static void APIENTRY countDrawArraysIndirect(GLenum mode, const void* indirect)
+    {
+        drawCalls++;
+        drawArraysIndirect(mode, indirect);
+    }
+};
+
+class FrameStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int QUERIES = 8; // frames em voo (o FramePacer deixa no máximo 4)
+    static constexpr int WORST = 10;  // piores frames no relatório
+    static constexpr int BINS = 40;   // faixas do histograma
+
+    FrameStats() { std::fill(pending, pending + QUERIES, -1LL); }
+    FrameStats(int argc, char** argv) : FrameStats()
+    {
+        size_t capacity = 1 << 16;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--stats" && hasValue)
+                base = argv[++i];
+            else if (arg == "--stats-frames" && hasValue)
+                capacity = (size_t)std::max(1, std::atoi(argv[++i]));
+        }
+        for (const char* ext : { ".csv", ".json" }) {
+            size_t n = std::char_traits<char>::length(ext);
+            if (base.size() > n && base.compare(base.size() - n, n, ext) == 0)
+                base.resize(base.size() - n);
+        }
+        ring.resize(capacity);
+    }
+
+    // Depois do swap e do FramePacer: começa o próximo frame
+    void frameBegin()
+    {
+        if (!started) {
+            glGenQueries(2 * QUERIES, queries);
+            origin = Clock::now();
+            lastPresent = origin;
+            started = true;
+        }
+        if (exportRequested.exchange(false))
+            write(base.empty() ? "frame_stats" : base, true);
+        DrawCounters::install();
+        DrawCounters::drawCalls = DrawCounters::triangles = 0;
+        begin = Clock::now();
+        // Com o par seguinte ainda em voo o frame fica sem tempo de GPU
+        slot = -1;
+        if (pending[next] < 0) {
+            slot = next;
+            glQueryCounter(queries[2 * slot], GL_TIMESTAMP);
+        }
+    }
+
+    // O trabalho do frame chegou (a thread de render da CenaFinal, depois de pegar o
+    // pacote): o cpu_ms conta daqui, sem a espera na fila
+    void workBegin() { begin = Clock::now(); }
+
+    // Antes do swap (e do dump): fecha o frame que frameBegin() abriu
+    void frameEnd(uint32_t frame)
+    {
+        if (!started)
+            return;
+        auto now = Clock::now();
+        FrameSample& s = ring[count % ring.size()];
+        s.frame = frame;
+        s.time = seconds(origin, now);
+        s.cpuMs = (float)(seconds(begin, now) * 1000.0);
+        s.frameMs = (float)(seconds(lastPresent, now) * 1000.0);
+        s.gpuMs = -1.0f;
+        s.drawCalls = DrawCounters::drawCalls;
+        s.triangles = DrawCounters::triangles;
+        lastPresent = now;
+        if (slot >= 0) {
+            glQueryCounter(queries[2 * slot + 1], GL_TIMESTAMP);
+            pending[slot] = (long long)count;
+            next = (next + 1) % QUERIES;
+        }
+        count++;
+        collect(false);
+    }
+
+    // Lê os tempos de GPU prontos; wait = true espera todos (último frame, com o contexto ainda vivo)
+    void collect(bool wait)
+    {
+        for (int i = 0; i < QUERIES; i++) {
+            int q = (next + i) % QUERIES; // mais antigo primeiro
+            if (pending[q] < 0)
+                continue;
+            GLuint ready = 0;
+            if (!wait) {
+                glGetQueryObjectuiv(queries[2 * q + 1], GL_QUERY_RESULT_AVAILABLE, &ready);
+                if (!ready)
+                    break;
+            }
+            GLuint64 t0 = 0, t1 = 0;
+            glGetQueryObjectui64v(queries[2 * q], GL_QUERY_RESULT, &t0);
+            glGetQueryObjectui64v(queries[2 * q + 1], GL_QUERY_RESULT, &t1);
+            // O anel pode já ter dado a volta sobre esse frame
+            if ((long long)count - pending[q] <= (long long)ring.size())
+                ring[(size_t)pending[q] % ring.size()].gpuMs = (float)((double)(t1 - t0) * 1e-6);
+            pending[q] = -1;
+        }
+    }
+
+    // Exporta no próximo frameBegin(), na thread que desenha (pode vir de outra thread)
+    void requestExport() { exportRequested.store(true); }
+
+    const std::string& outputBase() const { return base; }
+
+    // Ao sair, já sem contexto: resumo no console e, com --stats, os arquivos
+    void finish()
+    {
+        if (!base.empty())
+            write(base, false);
+        else
+            printSummary(samples());
+    }
+
+private:
+    struct Column {
+        double mean = 0.0, p50 = 0.0, p90 = 0.0, p99 = 0.0, p999 = 0.0, max = 0.0;
+        size_t n = 0;
+    };
+
+    std::string base;
+    std::vector<FrameSample> ring;
+    size_t count = 0; // frames registrados desde o início
+    bool started = false;
+    Clock::time_point origin, lastPresent, begin;
+    GLuint queries[2 * QUERIES] = {};
+    long long pending[QUERIES]; // frame de cada par em voo, -1 = livre
+    int next = 0, slot = -1;
+    std::atomic<bool> exportRequested{ false };
+
+    static double seconds(Clock::time_point a, Clock::time_point b) { return std::chrono::duration<double>(b - a).count(); }
+
+    // Anel em ordem cronológica
+    std::vector<FrameSample> samples() const
+    {
+        std::vector<FrameSample> out;
+        size_t n = std::min(count, ring.size());
+        out.reserve(n);
+        for (size_t i = count - n; i < count; i++)
+            out.push_back(ring[i % ring.size()]);
+        return out;
+    }
+
+    // Mesmo critério de percentil do FramePacer; valores negativos (sem GPU) ficam de fora
+    template<typename Get>
+    static Column column(const std::vector<FrameSample>& s, Get get)
+    {
+        Column c;
+        std::vector<double> v;
+        v.reserve(s.size());
+        for (const FrameSample& f : s) {
+            double x = get(f);
+            if (x >= 0.0)
+                v.push_back(x);
+        }
+        if (v.empty())
+            return c;
+        std::sort(v.begin(), v.end());
+        double sum = 0.0;
+        for (double x : v)
+            sum += x;
+        auto pct = [&](double p) { return v[std::min(v.size() - 1, (size_t)(p * v.size()))]; };
+        c.n = v.size();
+        c.mean = sum / v.size();
+        c.p50 = pct(0.5);
+        c.p90 = pct(0.9);
+        c.p99 = pct(0.99);
+        c.p999 = pct(0.999);
+        c.max = v.back();
+        return c;
+    }
+
+    // Largura "redonda" (1, 2 ou 5 x 10^k) para BINS faixas até o máximo
+    static double binWidth(double max)
+    {
+        double raw = std::max(max, 1e-3) / BINS;
+        double p = std::pow(10.0, std::floor(std::log10(raw)));
+        for (double m : { 1.0, 2.0, 5.0 })
+            if (m * p >= raw)
+                return m * p;
+        return 10.0 * p;
+    }
+
+    static std::vector<FrameSample> worst(std::vector<FrameSample> s)
+    {
+        size_t n = std::min<size_t>(WORST, s.size());
+        std::partial_sort(s.begin(), s.begin() + n, s.end(),
+                          [](const FrameSample& a, const FrameSample& b) { return a.frameMs > b.frameMs; });
+        s.resize(n);
+        return s;
+    }
+
+    void printSummary(const std::vector<FrameSample>& s) const
+    {
+        if (s.empty())
+            return;
+        Column f = column(s, [](const FrameSample& x) { return (double)x.frameMs; });
+        Column c = column(s, [](const FrameSample& x) { return (double)x.cpuMs; });
+        Column g = column(s, [](const FrameSample& x) { return (double)x.gpuMs; });
+        Column d = column(s, [](const FrameSample& x) { return (double)x.drawCalls; });
+        Column t = column(s, [](const FrameSample& x) { return (double)x.triangles; });
+        std::printf("[frames] %zu frames: frame p50 %.2f, p90 %.2f, p99 %.2f, p99.9 %.2f, máx %.2f ms | "
+                    "CPU p50 %.2f, p99 %.2f ms | GPU p50 %.2f, p99 %.2f ms | %.0f draw calls, %.0f triângulos/frame\n",
+                    s.size(), f.p50, f.p90, f.p99, f.p999, f.max, c.p50, c.p99, g.p50, g.p99, d.mean, t.mean);
+        std::printf("[frames] piores:");
+        for (const FrameSample& w : worst(s))
+            std::printf(" #%u %.2f ms (%.2f s)", w.frame, w.frameMs, w.time);
+        std::printf("\n");
+    }
+
+    // ARQ.csv (um frame por linha) e ARQ.json (percentis, piores e histograma)
+    void write(const std::string& path, bool snapshot)
+    {
+        if (snapshot)
+            collect(false);
+        std::vector<FrameSample> s = samples();
+        printSummary(s);
+        if (s.empty())
+            return;
+        std::string name = path;
+        if (snapshot) {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), "_%05u", s.back().frame);
+            name += suffix;
+        }
+
+        FILE* csv = std::fopen((name + ".csv").c_str(), "w");
+        if (!csv) {
+            std::fprintf(stderr, "[frames] não foi possível gravar %s.csv\n", name.c_str());
+            return;
+        }
+        std::fprintf(csv, "frame,tempo_s,frame_ms,cpu_ms,gpu_ms,draw_calls,triangulos\n");
+        for (const FrameSample& f : s) {
+            std::fprintf(csv, "%u,%.6f,%.4f,%.4f,", f.frame, f.time, f.frameMs, f.cpuMs);
+            if (f.gpuMs >= 0.0f)
+                std::fprintf(csv, "%.4f", f.gpuMs);
+            std::fprintf(csv, ",%u,%u\n", f.drawCalls, f.triangles);
+        }
+        std::fclose(csv);
+
+        FILE* json = std::fopen((name + ".json").c_str(), "w");
+        if (!json) {
+            std::fprintf(stderr, "[frames] não foi possível gravar %s.json\n", name.c_str());
+            return;
+        }
+        auto writeColumn = [&](const char* key, const Column& c, bool last) {
+            std::fprintf(json,
+                         "  \"%s\": {\"amostras\": %zu, \"media\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, "
+                         "\"p99_9\": %.4f, \"max\": %.4f}%s\n",
+                         key, c.n, c.mean, c.p50, c.p90, c.p99, c.p999, c.max, last ? "" : ",");
+        };
+        Column frameCol = column(s, [](const FrameSample& x) { return (double)x.frameMs; });
+        std::fprintf(json, "{\n  \"frames\": %zu,\n  \"duracao_s\": %.6f,\n", s.size(), s.back().time - s.front().time);
+        writeColumn("frame_ms", frameCol, false);
+        writeColumn("cpu_ms", column(s, [](const FrameSample& x) { return (double)x.cpuMs; }), false);
+        writeColumn("gpu_ms", column(s, [](const FrameSample& x) { return (double)x.gpuMs; }), false);
+        writeColumn("draw_calls", column(s, [](const FrameSample& x) { return (double)x.drawCalls; }), false);
+        writeColumn("triangulos", column(s, [](const FrameSample& x) { return (double)x.triangles; }), false);
+
+        std::fprintf(json, "  \"piores\": [");
+        std::vector<FrameSample> w = worst(s);
+        for (size_t i = 0; i < w.size(); i++)
+            std::fprintf(json, "%s\n    {\"frame\": %u, \"tempo_s\": %.6f, \"frame_ms\": %.4f, \"cpu_ms\": %.4f, \"gpu_ms\": %.4f}",
+                         i ? "," : "", w[i].frame, w[i].time, w[i].frameMs, w[i].cpuMs, w[i].gpuMs);
+        std::fprintf(json, "\n  ],\n");
+
+        double width = binWidth(frameCol.max);
+        std::vector<uint32_t> bins(BINS + 1, 0); // a última pega o que passar do arredondamento
+        for (const FrameSample& f : s)
+            bins[std::min<size_t>(BINS, (size_t)(f.frameMs / width))]++;
+        while (bins.size() > 1 && bins.back() == 0)
+            bins.pop_back();
+        std::fprintf(json, "  \"histograma_frame_ms\": {\"largura_ms\": %.4f, \"contagens\": [", width);
+        for (size_t i = 0; i < bins.size(); i++)
+            std::fprintf(json, "%s%u", i ? ", " : "", bins[i]);
+        std::fprintf(json, "]}\n}\n");
+        std::fclose(json);
+        std::printf("[frames] estatísticas em %s.csv e %s.json\n", name.c_str(), name.c_str());
+    }
+};
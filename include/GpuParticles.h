@@ -0,0 +1,242 @@
+#pragma once
+
+// ============== PARTÍCULAS NA GPU ==============
+// As partículas do raio (regras em ParticleSystem.h) inteiras na GPU. A CPU
+// não lê nem escreve partículas depois do init(); por frame ela só manda a
+// quantidade a emitir e o BeamEmitter em uniforms. Três dispatches, todos
+// sem atomics globais (a ordem não depende do agendamento das invocações):
+//   1. atualizar:  uma invocação por partícula; integra as vivas e grava,
+//                  por grupo de 256, quantas ficaram mortas e vivas;
+//   2. prefixo:    um grupo; prefixo exclusivo das contagens dos grupos,
+//                  totais, nascimentos do frame (min(quantidade, mortas)) e
+//                  a contagem de vértices do draw indireto;
+//   3. compactar:  uma invocação por partícula; com o prefixo do grupo e o
+//                  de dentro do grupo (memória compartilhada) cada viva acha
+//                  o seu lugar na lista de vivas, e a k-ésima morta renasce
+//                  com a semente k se k < nascimentos, no fim da lista.
+// Entre as etapas, glMemoryBarrier; o desenho é um glDrawArraysIndirect de
+// pontos em que o vertex shader busca a partícula pela lista de vivas. Os
+// nascimentos são os mesmos do CpuParticles (k-ésima morta na ordem dos
+// índices, semente k).
+//
+// SSBOs (std430, os mesmos bindings dos shaders da CenaFinal):
+//   binding 0: partículas (GpuParticle)
+//   binding 1: lista de vivas (a ordem do desenho)
+//   binding 2: por grupo (mortas, vivas); o prefixo troca pelas bases
+//   binding 3: contadores (ParticleCounters), também GL_DRAW_INDIRECT_BUFFER
+//
+// Compute é do GL 4.3 e a GLAD do projeto é 4.0: glDispatchCompute e
+// glMemoryBarrier são carregados em init(); sem eles (ou em contexto < 4.3)
+// supported() é false e a cena usa o CpuParticles. Os programas das etapas
+// chegam prontos (ShaderManager::addCompute, com cache e relatório).
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <ParticleSystem.h>
+
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
+
+// Layout idêntico ao struct Particula dos shaders (std430, 32 bytes)
+struct GpuParticle {
+    glm::vec4 positionLife; // xyz = posição relativa à base, w = vida restante
+    glm::vec4 motion;       // x = subida, y = giro, z = vida total
+};
+
+// Layout idêntico ao bloco Contadores dos shaders (std430, 32 bytes)
+struct ParticleCounters {
+    GLuint dead, alive, born, pad0;                               // depois do prefixo
+    GLuint drawCount, drawInstances, drawFirst, drawBaseInstance; // DrawArraysIndirectCommand
+};
+
+class GpuParticles {
+public:
+    static const int GROUP_SIZE = 256; // local_size_x dos compute shaders
+
+    // Contexto >= 4.3 com as funções de compute; não cria nada
+    static bool supported(GLADloadproc load)
+    {
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major * 10 + minor < 43)
+            return false;
+        return load("glDispatchCompute") && load("glMemoryBarrier");
+    }
+
+    // Programas linkados das três etapas (0 = falhou)
+    bool init(GLADloadproc load, size_t capacity, GLuint update, GLuint prefix, GLuint compact)
+    {
+        dispatchCompute = (DispatchComputeFn)load("glDispatchCompute");
+        memoryBarrier = (MemoryBarrierFn)load("glMemoryBarrier");
+        if (!dispatchCompute || !memoryBarrier) {
+            std::cerr << "[particulas] driver sem compute shaders" << std::endl;
+            return false;
+        }
+
+        if (!update || !prefix || !compact) {
+            std::cerr << "[particulas] compute shaders com erro" << std::endl;
+            return false;
+        }
+        updateProgram = update;
+        prefixProgram = prefix;
+        compactProgram = compact;
+        updateLocs.resolve(updateProgram);
+        compactLocs.resolve(compactProgram);
+        prefixCountLoc = glGetUniformLocation(prefixProgram, "quantidade");
+        compactFrameLoc = glGetUniformLocation(compactProgram, "frame");
+        for (GLuint program : { updateProgram, prefixProgram, compactProgram }) {
+            glUseProgram(program);
+            glUniform1ui(glGetUniformLocation(program, "total"), (GLuint)capacity);
+        }
+        glUseProgram(0);
+
+        count = capacity;
+        groups = (GLuint)((count + GROUP_SIZE - 1) / GROUP_SIZE);
+        std::vector<GpuParticle> particles(count, GpuParticle{ glm::vec4(0.0f), glm::vec4(0.0f) }); // vida 0: mortas
+        ParticleCounters counters = {};
+        counters.dead = (GLuint)count;
+        counters.drawInstances = 1;
+
+        glGenBuffers(4, buffers);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[PARTICLES]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(GpuParticle), particles.data(), GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[ALIVE]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[GROUPS]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, groups * 2 * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[COUNTERS]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(ParticleCounters), &counters, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        frame = 0;
+        return true;
+    }
+
+    size_t capacity() const { return count; }
+
+    // Integra, emite e compacta; fica tudo na fila da GPU (sem leitura de volta)
+    void update(const BeamEmitter& e, float dt)
+    {
+        int toEmit = (int)std::min((size_t)emission.take(e.rate, dt), count);
+        bindBuffers();
+
+        glUseProgram(updateProgram);
+        updateLocs.set(e, dt);
+        dispatchCompute(groups, 1, 1);
+        memoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        glUseProgram(prefixProgram);
+        glUniform1i(prefixCountLoc, toEmit);
+        dispatchCompute(1, 1, 1);
+        memoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        glUseProgram(compactProgram);
+        glUniform1ui(compactFrameLoc, frame++);
+        compactLocs.set(e, dt);
+        dispatchCompute(groups, 1, 1);
+        memoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+    }
+
+    // Desenha as vivas como pontos; o programa lê os bindings 0 e 1
+    void draw()
+    {
+        bindBuffers();
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffers[COUNTERS]);
+        glBindVertexArray(emptyVao());
+        glDrawArraysIndirect(GL_POINTS, (const void*)offsetof(ParticleCounters, drawCount));
+        glBindVertexArray(0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // Vivas no fim do último update(); lê de volta e espera a GPU (só para relatório)
+    int aliveCount() const
+    {
+        GLuint alive = 0;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[COUNTERS]);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, offsetof(ParticleCounters, drawCount), sizeof(GLuint), &alive);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        return (int)alive;
+    }
+
+private:
+    typedef void (APIENTRYP DispatchComputeFn)(GLuint, GLuint, GLuint);
+    typedef void (APIENTRYP MemoryBarrierFn)(GLbitfield);
+
+    DispatchComputeFn dispatchCompute = nullptr;
+    MemoryBarrierFn memoryBarrier = nullptr;
+
+    enum { PARTICLES, ALIVE, GROUPS, COUNTERS };
+
+    // Uniforms do BeamEmitter (compactar usa os do nascimento, atualizar os de movimento)
+    struct EmitterUniforms {
+        GLint dt = -1, height = -1, baseRadius = -1, topRadius = -1, minLife = -1, maxLife = -1;
+        GLint riseSpeed = -1, swirl = -1, contraction = -1;
+
+        void resolve(GLuint program)
+        {
+            dt = glGetUniformLocation(program, "dt");
+            height = glGetUniformLocation(program, "altura");
+            baseRadius = glGetUniformLocation(program, "raioBase");
+            topRadius = glGetUniformLocation(program, "raioTopo");
+            minLife = glGetUniformLocation(program, "vidaMin");
+            maxLife = glGetUniformLocation(program, "vidaMax");
+            riseSpeed = glGetUniformLocation(program, "subida");
+            swirl = glGetUniformLocation(program, "giro");
+            contraction = glGetUniformLocation(program, "contracao");
+        }
+
+        void set(const BeamEmitter& e, float step) const
+        {
+            glUniform1f(dt, step);
+            glUniform1f(height, e.height);
+            glUniform1f(baseRadius, e.baseRadius);
+            glUniform1f(topRadius, e.topRadius);
+            glUniform1f(minLife, e.minLife);
+            glUniform1f(maxLife, e.maxLife);
+            glUniform1f(riseSpeed, e.riseSpeed);
+            glUniform1f(swirl, e.swirl);
+            glUniform1f(contraction, e.contraction);
+        }
+    };
+
+    size_t count = 0;
+    GLuint groups = 0;
+    uint32_t frame = 0;
+    ParticleEmission emission;
+    GLuint buffers[4] = {};
+    GLuint vao = 0;
+    GLuint updateProgram = 0, prefixProgram = 0, compactProgram = 0;
+    GLint prefixCountLoc = -1, compactFrameLoc = -1;
+    EmitterUniforms updateLocs, compactLocs;
+
+    void bindBuffers() const
+    {
+        for (int b = PARTICLES; b <= COUNTERS; b++)
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, b, buffers[b]);
+    }
+
+    // Core profile exige um VAO ligado mesmo sem atributos
+    GLuint emptyVao()
+    {
+        if (!vao)
+            glGenVertexArrays(1, &vao);
+        return vao;
+    }
+};
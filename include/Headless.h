@@ -0,0 +1,372 @@
+#pragma once
+
+// ============== MODO HEADLESS (SEM JANELA) ==============
+// Roda as cenas em máquinas sem display (ex.: Mesa llvmpipe em servidores de
+// benchmark). Com --headless a GLFW usa a plataforma nula (só para a janela
+// "virtual" e a entrada, que fica parada) e o contexto GL 4.5 core é criado
+// à parte, via EGL com EGL_MESA_platform_surfaceless ou, se não houver, OSMesa.
+// Tudo é desenhado num FBO próprio: glBindFramebuffer(..., 0) é redirecionado
+// para ele, então o código das cenas não muda.
+//
+// Opções de linha de comando:
+//   --headless           ativa o modo
+//   --osmesa             força OSMesa em vez de EGL
+//   --frames N           encerra depois de N frames (também com janela)
+//   --dump DIR           grava o último frame em DIR/frame_NNNNN.png
+//   --dump-every K       ... e também um a cada K frames
+// e as de ritmo dos frames (--vsync, --uncapped, --fps N, --frames-ahead N),
+// ver FramePacer.h. Sem janela o padrão é sem limite. As estatísticas de
+// frame (--stats ARQ, --stats-frames N) estão em FrameStats.h.
+//
+// Uso no main (STB_IMAGE_WRITE_IMPLEMENTATION definido antes do include):
+//   Headless headless(argc, argv);
+//   headless.initHints();                 // antes de glfwInit()
+//   glfwInit();
+//   headless.windowHints();               // antes de glfwCreateWindow()
+//   GLFWwindow* window = glfwCreateWindow(...);
+//   headless.makeCurrent(window);         // no lugar de glfwMakeContextCurrent
+//   gladLoadGLLoader(headless.loader());
+//   ...
+//   headless.swapBuffers(window);         // no lugar de glfwSwapBuffers
+// Para desenhar em outra thread: releaseContext() na que criou o contexto e
+// bindContext() na nova (com janela, glfwMakeContextCurrent nas duas).
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <filesystem>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <stb_image_write.h>
+
+#include <FramePacer.h>
+#include <FrameStats.h>
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#define HEADLESS_SUPPORTED 1
+#endif
+
+class Headless {
+public:
+    Headless(int argc, char** argv) : stats(argc, argv)
+    {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--headless")
+                enabled = true;
+            else if (arg == "--osmesa")
+                forceOSMesa = true;
+            else if (arg == "--frames" && hasValue)
+                maxFrames = std::atoi(argv[++i]);
+            else if (arg == "--dump" && hasValue)
+                dumpDir = argv[++i];
+            else if (arg == "--dump-every" && hasValue)
+                dumpEvery = std::atoi(argv[++i]);
+        }
+        if (enabled && maxFrames <= 0)
+            maxFrames = 300; // sem janela não há como fechar
+#ifndef HEADLESS_SUPPORTED
+        if (enabled) {
+            std::cerr << "[headless] modo headless só é suportado no Linux, abrindo janela" << std::endl;
+            enabled = false;
+        }
+#endif
+        pacer = FramePacer(argc, argv, enabled);
+    }
+
+    // O contexto (e as fences) já foram destruídos aqui; só imprime e grava
+    ~Headless()
+    {
+        pacer.printSummary();
+        stats.finish();
+    }
+
+    bool isEnabled() const { return enabled; }
+    int frameCount() const { return frame; }
+    int frameLimit() const { return maxFrames; }
+    const FramePacer& framePacer() const { return pacer; }
+    FrameStats& frameStats() { return stats; }
+
+    void initHints()
+    {
+        if (enabled)
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+
+    void windowHints()
+    {
+        if (enabled) {
+            glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API); // o contexto vem do EGL/OSMesa
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        }
+    }
+
+    // Com janela: glfwMakeContextCurrent. Headless: cria o contexto e o FBO do tamanho da janela
+    bool makeCurrent(GLFWwindow* window)
+    {
+        start = std::chrono::steady_clock::now();
+        if (!enabled) {
+            glfwMakeContextCurrent(window);
+            pacer.init(true);
+            return true;
+        }
+        glfwGetWindowSize(window, &width, &height);
+#ifdef HEADLESS_SUPPORTED
+        bool ok = (!forceOSMesa && createEGL()) || createOSMesa();
+        if (!ok) {
+            std::cerr << "[headless] não foi possível criar um contexto GL 4.5 (EGL surfaceless e OSMesa)" << std::endl;
+            std::exit(1);
+        }
+        gladLoadGLLoader(loader());
+        createFramebuffer();
+        std::cout << "[headless] " << backend << ", " << glGetString(GL_RENDERER) << ", " << width << "x" << height
+                  << ", " << maxFrames << " frames" << std::endl;
+        pacer.init(false);
+#endif
+        return true;
+    }
+
+    // Solta o contexto da thread atual (antes de passá-lo para a thread de render)
+    void releaseContext()
+    {
+        if (!enabled) {
+            glfwMakeContextCurrent(nullptr);
+            return;
+        }
+#ifdef HEADLESS_SUPPORTED
+        if (eglMakeCurrent)
+            eglMakeCurrent(eglDisplay, nullptr, nullptr, nullptr);
+        else if (osmesaMakeCurrent)
+            osmesaMakeCurrent(nullptr, nullptr, GL_UNSIGNED_BYTE, 0, 0);
+#endif
+    }
+
+    // Liga na thread chamadora o contexto criado por makeCurrent(); o FBO e o estado GL vão junto
+    void bindContext(GLFWwindow* window)
+    {
+        if (!enabled) {
+            glfwMakeContextCurrent(window);
+            return;
+        }
+#ifdef HEADLESS_SUPPORTED
+        if (eglMakeCurrent)
+            eglMakeCurrent(eglDisplay, nullptr, nullptr, eglContext);
+        else if (osmesaMakeCurrent)
+            osmesaMakeCurrent(osmesaContext, osmesaBuffer.data(), GL_UNSIGNED_BYTE, width, height);
+#endif
+    }
+
+    GLADloadproc loader() const { return enabled ? (GLADloadproc)getProcAddress : (GLADloadproc)glfwGetProcAddress; }
+
+    // Com janela: glfwSwapBuffers. Headless: grava PNGs pedidos e conta frames.
+    // Nos dois modos passa pelo FramePacer e encerra a janela ao atingir --frames.
+    void swapBuffers(GLFWwindow* window)
+    {
+        frame++;
+        stats.frameEnd((uint32_t)frame);
+        if (enabled) {
+            bool last = frame >= maxFrames;
+            if (!dumpDir.empty() && (last || (dumpEvery > 0 && frame % dumpEvery == 0)))
+                dump();
+        } else {
+            glfwSwapBuffers(window);
+        }
+        pacer.frameEnd();
+
+        if (maxFrames > 0 && frame >= maxFrames) {
+            if (enabled)
+                glFinish(); // conta o trabalho pendente do último frame
+            stats.collect(true);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "[headless] " << frame << " frames em " << ms << " ms (" << ms / frame << " ms/frame)" << std::endl;
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+
+        stats.frameBegin();
+    }
+
+private:
+    bool enabled = false, forceOSMesa = false;
+    int maxFrames = 0, dumpEvery = 0;
+    std::string dumpDir;
+    int width = 0, height = 0, frame = 0;
+    std::string backend;
+    std::chrono::steady_clock::time_point start;
+    FramePacer pacer;
+    FrameStats stats;
+
+    typedef void (*ProcFn)(void);
+    typedef ProcFn (*GetProcFn)(const char*);
+    typedef void (APIENTRYP BindFramebufferFn)(GLenum, GLuint);
+
+    // Estado compartilhado com getProcAddress (a GLAD só aceita um ponteiro de função)
+    static inline GetProcFn contextGetProc = nullptr;
+    static inline BindFramebufferFn realBindFramebuffer = nullptr;
+    static inline GLuint offscreenFbo = 0;
+
+    static void APIENTRY bindFramebufferRedirect(GLenum target, GLuint fbo)
+    {
+        realBindFramebuffer(target, fbo ? fbo : offscreenFbo);
+    }
+
+    static void* getProcAddress(const char* name)
+    {
+        if (std::strcmp(name, "glBindFramebuffer") == 0) {
+            if (!realBindFramebuffer)
+                realBindFramebuffer = (BindFramebufferFn)contextGetProc(name);
+            return (void*)bindFramebufferRedirect;
+        }
+        return (void*)contextGetProc(name);
+    }
+
+#ifdef HEADLESS_SUPPORTED
+    // ==== EGL (EGL_MESA_platform_surfaceless) ====
+    // Só o necessário do egl.h/eglext.h, carregado com dlopen para não exigir libEGL no link
+    typedef void* EGLDisplay;
+    typedef void* EGLContext;
+    typedef void* EGLConfig;
+    typedef int EGLint;
+    typedef unsigned int EGLBoolean;
+    typedef EGLBoolean (*EglMakeCurrentFn)(EGLDisplay, void*, void*, EGLContext);
+    typedef unsigned char (*OSMesaMakeCurrentFn)(void*, void*, GLenum, GLsizei, GLsizei);
+
+    // Guardados para releaseContext()/bindContext()
+    EglMakeCurrentFn eglMakeCurrent = nullptr;
+    EGLDisplay eglDisplay = nullptr;
+    EGLContext eglContext = nullptr;
+    OSMesaMakeCurrentFn osmesaMakeCurrent = nullptr;
+    void* osmesaContext = nullptr;
+
+    bool createEGL()
+    {
+        void* lib = dlopen("libEGL.so.1", RTLD_NOW | RTLD_GLOBAL);
+        if (!lib)
+            return false;
+        typedef ProcFn (*EglGetProcFn)(const char*);
+        typedef EGLDisplay (*GetPlatformDisplayFn)(unsigned int, void*, const EGLint*);
+        typedef EGLBoolean (*InitializeFn)(EGLDisplay, EGLint*, EGLint*);
+        typedef EGLBoolean (*BindApiFn)(unsigned int);
+        typedef EGLBoolean (*ChooseConfigFn)(EGLDisplay, const EGLint*, EGLConfig*, EGLint, EGLint*);
+        typedef EGLContext (*CreateContextFn)(EGLDisplay, EGLConfig, EGLContext, const EGLint*);
+        typedef const char* (*QueryStringFn)(EGLDisplay, EGLint);
+
+        const unsigned int EGL_PLATFORM_SURFACELESS_MESA = 0x31DD, EGL_OPENGL_API = 0x30A2;
+        const EGLint EGL_NONE = 0x3038, EGL_EXTENSIONS = 0x3055, EGL_RENDERABLE_TYPE = 0x3040, EGL_OPENGL_BIT = 0x0008;
+        const EGLint EGL_CONTEXT_MAJOR_VERSION = 0x3098, EGL_CONTEXT_MINOR_VERSION = 0x30FB;
+        const EGLint EGL_CONTEXT_OPENGL_PROFILE_MASK = 0x30FD, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT = 0x0001;
+
+        EglGetProcFn getProc = (EglGetProcFn)dlsym(lib, "eglGetProcAddress");
+        QueryStringFn queryString = (QueryStringFn)dlsym(lib, "eglQueryString");
+        if (!getProc || !queryString)
+            return false;
+        const char* clientExts = queryString(nullptr, EGL_EXTENSIONS);
+        if (!clientExts || !std::strstr(clientExts, "EGL_MESA_platform_surfaceless"))
+            return false;
+
+        GetPlatformDisplayFn getPlatformDisplay = (GetPlatformDisplayFn)getProc("eglGetPlatformDisplayEXT");
+        InitializeFn initialize = (InitializeFn)dlsym(lib, "eglInitialize");
+        BindApiFn bindApi = (BindApiFn)dlsym(lib, "eglBindAPI");
+        ChooseConfigFn chooseConfig = (ChooseConfigFn)dlsym(lib, "eglChooseConfig");
+        CreateContextFn createContext = (CreateContextFn)dlsym(lib, "eglCreateContext");
+        EglMakeCurrentFn makeCurrentEGL = (EglMakeCurrentFn)dlsym(lib, "eglMakeCurrent");
+        if (!getPlatformDisplay || !initialize || !bindApi || !chooseConfig || !createContext || !makeCurrentEGL)
+            return false;
+
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr);
+        if (!display || !initialize(display, nullptr, nullptr) || !bindApi(EGL_OPENGL_API))
+            return false;
+
+        EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+        EGLConfig config = nullptr;
+        EGLint count = 0;
+        chooseConfig(display, configAttribs, &config, 1, &count);
+
+        EGLint contextAttribs[] = { EGL_CONTEXT_MAJOR_VERSION, 4, EGL_CONTEXT_MINOR_VERSION, 5,
+                                    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+        EGLContext context = createContext(display, count > 0 ? config : nullptr, nullptr, contextAttribs);
+        if (!context || !makeCurrentEGL(display, nullptr, nullptr, context))
+            return false;
+
+        eglMakeCurrent = makeCurrentEGL;
+        eglDisplay = display;
+        eglContext = context;
+        contextGetProc = (GetProcFn)getProc;
+        backend = "EGL surfaceless";
+        return true;
+    }
+
+    // ==== OSMesa ====
+    bool createOSMesa()
+    {
+        void* lib = dlopen("libOSMesa.so.8", RTLD_NOW | RTLD_GLOBAL);
+        if (!lib)
+            lib = dlopen("libOSMesa.so", RTLD_NOW | RTLD_GLOBAL);
+        if (!lib)
+            return false;
+        typedef void* (*CreateContextAttribsFn)(const int*, void*);
+        CreateContextAttribsFn createContext = (CreateContextAttribsFn)dlsym(lib, "OSMesaCreateContextAttribs");
+        OSMesaMakeCurrentFn makeCurrentOSMesa = (OSMesaMakeCurrentFn)dlsym(lib, "OSMesaMakeCurrent");
+        GetProcFn getProc = (GetProcFn)dlsym(lib, "OSMesaGetProcAddress");
+        if (!createContext || !makeCurrentOSMesa || !getProc)
+            return false;
+
+        const int OSMESA_FORMAT = 0x22, OSMESA_DEPTH_BITS = 0x30, OSMESA_STENCIL_BITS = 0x31, OSMESA_PROFILE = 0x33,
+                  OSMESA_CORE_PROFILE = 0x34, OSMESA_CONTEXT_MAJOR_VERSION = 0x36, OSMESA_CONTEXT_MINOR_VERSION = 0x37;
+        int attribs[] = { OSMESA_FORMAT, GL_RGBA, OSMESA_DEPTH_BITS, 24, OSMESA_STENCIL_BITS, 8, OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+                          OSMESA_CONTEXT_MAJOR_VERSION, 4, OSMESA_CONTEXT_MINOR_VERSION, 5, 0 };
+        void* context = createContext(attribs, nullptr);
+        osmesaBuffer.resize((size_t)width * height * 4);
+        if (!context || !makeCurrentOSMesa(context, osmesaBuffer.data(), GL_UNSIGNED_BYTE, width, height))
+            return false;
+
+        osmesaMakeCurrent = makeCurrentOSMesa;
+        osmesaContext = context;
+        contextGetProc = getProc;
+        backend = "OSMesa";
+        return true;
+    }
+
+    std::vector<unsigned char> osmesaBuffer; // framebuffer padrão do OSMesa (não usado para desenhar)
+#endif
+
+    void createFramebuffer()
+    {
+        GLuint color, depth;
+        glGenFramebuffers(1, &offscreenFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, offscreenFbo);
+        glGenRenderbuffers(1, &color);
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        glGenRenderbuffers(1, &depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cerr << "[headless] FBO incompleto" << std::endl;
+        glViewport(0, 0, width, height); // sem superfície o viewport inicial é 0x0
+    }
+
+    void dump()
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(dumpDir, ec);
+        std::vector<unsigned char> pixels((size_t)width * height * 4);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0); // redirecionado para o FBO
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        char name[32];
+        snprintf(name, sizeof(name), "/frame_%05d.png", frame);
+        std::string path = dumpDir + name;
+        stbi_flip_vertically_on_write(1); // OpenGL começa pela linha de baixo
+        if (!stbi_write_png(path.c_str(), width, height, 4, pixels.data(), width * 4))
+            std::cerr << "[headless] erro ao gravar " << path << std::endl;
+    }
+};
@@ -0,0 +1,368 @@
+#pragma once
+
+// ============== REBANHO (ENTIDADES EM SoA) ==============
+// Modo de estresse da CenaFinal: N vacas e M ovnis tocando os mesmos clips de
+// abdução/queda do par principal (Animation.h). Cada componente é um array
+// contíguo, então a atualização de um passo percorre só os arrays que usa,
+// em faixas repartidas nos jobs do JobSystem (setThreads limita quantas
+// rodam ao mesmo tempo).
+//
+//   - cada ovni tem um estado (abduzindo ou soltando) que alterna num período
+//     próprio, e k vacas numa grade em volta dele (vaca i -> ovni i % M);
+//   - cada vaca é uma instância de um AnimationBatch, com estado próprio em
+//     SoA (posição, velocidade, estado da abdução, rotação): ela segue a
+//     troca do ovni depois de um atraso próprio, tocando "abducao" ou
+//     "queda", e começa o oito numa fase própria, então o passo custa O(N);
+//   - o ovni sobe/desce com o ovni.y da sua primeira vaca (a instância u),
+//     como o ovni principal acompanha a vaca da cena;
+//   - step() avança um passo fixo (guarda o anterior para interpolar) e
+//     buildMatrices() gera as matrizes de modelo interpoladas, prontas para
+//     o desenho instanciado (um glDrawArraysInstanced por submesh): cada
+//     faixa escreve posição e quaternion em SoA e monta as matrizes com os
+//     kernels SIMD do TransformBatch.
+//
+// Sem GL: o upload e o desenho ficam com quem usa (CenaFinal); o cg_bench
+// mede só a CPU.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <Animation.h>
+#include <JobSystem.h>
+#include <TransformBatch.h>
+
+// ==== CLIPS DA ABDUÇÃO ====
+// Clips e canais de assets/Animacoes/abducao.anim usados pelo par principal e
+// pelo rebanho: "abducao" (a vaca sobe e o ovni desce, depois "pairar" em
+// loop no alto) e "queda" (casa acesa: a vaca cai girando, o ovni sobe)
+struct AbductionClips {
+    int abduct = -1, hover = -1, release = -1;
+    int ufoY = -1, cowY = -1, cowOffset = -1, cowRot = -1;
+
+    bool resolve(const AnimationLibrary& lib)
+    {
+        abduct = lib.clipIndex("abducao");
+        hover = lib.clipIndex("pairar");
+        release = lib.clipIndex("queda");
+        ufoY = lib.findChannel("ovni.y", ChannelType::Float);
+        cowY = lib.findChannel("vaca.y", ChannelType::Float);
+        cowOffset = lib.findChannel("vaca.deslocamento", ChannelType::Vec3);
+        cowRot = lib.findChannel("vaca.rot", ChannelType::Quat);
+        if (abduct < 0 || hover < 0 || release < 0) {
+            std::cerr << "[animacao] faltam os clips abducao, pairar ou queda" << std::endl;
+            return false;
+        }
+        if (ufoY < 0 || cowY < 0 || cowOffset < 0 || cowRot < 0) {
+            std::cerr << "[animacao] faltam os canais ovni.y, vaca.y (float), vaca.deslocamento (vec3) ou vaca.rot (quat)"
+                      << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Estado inicial do par principal: o clip de casa_luz (acesa: queda, apagada:
+    // abdução) entra na altura 'cowY' da vaca, sem mistura
+    void start(AnimationPlayer& player, const AnimationLibrary& lib, bool houseLight, float cowY) const
+    {
+        player.init(lib);
+        AnimationPose pose = lib.restPose();
+        pose.floats[this->cowY] = cowY;
+        player.setPose(pose);
+        player.play(houseLight ? release : abduct, false);
+    }
+};
+
+// Vaca na altura 'cowY' deslocada por 'offset' (balanço e oito), girada por 'rot' (queda)
+inline glm::mat4 cowModel(const glm::vec3& home, float cowY, const glm::vec3& offset, const glm::quat& rot)
+{
+    return glm::translate(glm::mat4(1.0f), home + glm::vec3(0.0f, cowY, 0.0f) + offset) * glm::mat4_cast(rot);
+}
+
+inline glm::mat4 ufoModel(const glm::vec3& home, float ufoY, float time)
+{
+    return glm::translate(glm::mat4(1.0f), home + glm::vec3(0, ufoY, 0)) *
+           glm::rotate(glm::mat4(1.0f), time, glm::vec3(0, 1, 0));
+}
+
+struct HerdStats {
+    double stepMs = 0.0;     // último step()
+    double matricesMs = 0.0; // último buildMatrices()
+    long long steps = 0;
+};
+
+class Herd {
+public:
+    // Vacas em grades de k = ceil(N/M) em volta de cada ovni; os ovnis numa grade centrada em 'center'.
+    // 'library' precisa dos clips de AbductionClips e viver enquanto o rebanho existir.
+    bool init(int cows, int ufos, float spacing, const glm::vec3& center, const AnimationLibrary& library)
+    {
+        if (!clips.resolve(library))
+            return false;
+        cows = std::max(cows, 0);
+        ufos = std::max(ufos, 1);
+        numCows = cows;
+        numUfos = ufos;
+        time = prevTime = 0.0f;
+
+        int perUfo = (cows + ufos - 1) / ufos;
+        int q = std::max(1, (int)std::ceil(std::sqrt((double)perUfo))); // lado da grade de vacas
+        int side = (int)std::ceil(std::sqrt((double)ufos));             // lado da grade de ovnis
+        float cell = q * spacing;
+        float origin = -(side - 1) * cell * 0.5f;
+
+        uint32_t seed = 2024u;
+        auto rnd = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return (seed >> 8) / 16777216.0f;
+        };
+
+        ufoHomeX.resize(ufos);
+        ufoHomeZ.resize(ufos);
+        ufoAbducting.resize(ufos);
+        ufoTimer.resize(ufos);
+        ufoPeriod.resize(ufos);
+        ufoPhase.resize(ufos);
+        prevUfoY.resize(ufos);
+        for (int u = 0; u < ufos; u++) {
+            ufoHomeX[u] = center.x + origin + (u % side) * cell;
+            ufoHomeZ[u] = center.z + origin + (u / side) * cell;
+            ufoPeriod[u] = 6.0f + rnd() * 6.0f;
+            ufoTimer[u] = rnd() * ufoPeriod[u]; // fases diferentes: o rebanho não sobe em bloco
+            ufoAbducting[u] = rnd() < 0.5f;
+            ufoPhase[u] = rnd() * 6.2831853f;
+        }
+
+        // Uma instância por vaca; com menos vacas que ovnis, as instâncias além
+        // das vacas só guiam o ovni delas (instância i -> ovni i % M)
+        numInstances = std::max(cows, ufos);
+        anim.init(library, numInstances);
+        cowHomeX.resize(numInstances);
+        cowHomeZ.resize(numInstances);
+        cowUfo.resize(numInstances);
+        cowAbducting.resize(numInstances);
+        cowDelay.resize(numInstances);
+        cowWait.resize(numInstances);
+        cowPos.resize(numInstances);
+        prevCowPos.resize(numInstances);
+        cowVelY.resize(numInstances);
+        cowRot.resize(numInstances);
+        prevCowRot.resize(numInstances);
+        for (int i = 0; i < numInstances; i++) {
+            int u = i % ufos, j = i / ufos;
+            cowUfo[i] = (uint32_t)u;
+            cowHomeX[i] = ufoHomeX[u] + ((j % q) - (q - 1) * 0.5f) * spacing;
+            cowHomeZ[i] = ufoHomeZ[u] + ((j / q) - (q - 1) * 0.5f) * spacing;
+            cowAbducting[i] = ufoAbducting[u];
+            cowDelay[i] = i < ufos ? 0.0f : rnd() * MAX_DELAY; // a primeira vaca guia o ovni sem atraso
+            cowWait[i] = cowDelay[i];
+            cowVelY[i] = 0.0f;
+            // Começa parada: no alto do oito (numa fase própria) ou no fim da queda
+            if (cowAbducting[i])
+                anim.play(i, clips.hover, (ufoPhase[u] + rnd() * 6.2831853f) * 0.5f);
+            else
+                anim.play(i, clips.release);
+        }
+        anim.advance(0.0f);
+        anim.evaluate();
+        storePoses(0, numInstances);
+        prevCowPos = cowPos;
+        prevCowRot = cowRot;
+        prevUfoY = anim.floats(clips.ufoY);
+        prevUfoY.resize(ufos);
+
+        cowMatrices.resize(cows);
+        ufoMatrices.resize(ufos);
+        cowTransforms = TransformSoA();
+        ufoTransforms = TransformSoA();
+        cowTransforms.resize(cows);
+        ufoTransforms.resize(ufos);
+        cowsMoving = false;
+        movingAtBuild = posesChanged = true;
+        return true;
+    }
+
+    void setThreads(int threads) { numThreads = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency()); }
+
+    // Um passo fixo: ovnis primeiro (troca de estado), depois cada vaca segue o
+    // seu ovni, avança e amostra as trilhas da própria instância
+    void step(float dt)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        prevTime = time;
+        time += dt;
+
+        parallelFor(numUfos, [this, dt](int begin, int end) {
+            const std::vector<float>& ufoY = anim.floats(clips.ufoY);
+            for (int u = begin; u < end; u++) {
+                prevUfoY[u] = ufoY[u];
+                ufoTimer[u] -= dt;
+                if (ufoTimer[u] <= 0.0f) {
+                    ufoAbducting[u] = !ufoAbducting[u];
+                    ufoTimer[u] += ufoPeriod[u];
+                }
+            }
+        });
+        std::atomic<bool> moved(false);
+        parallelFor(numInstances, [this, dt, &moved](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                prevCowPos[i] = cowPos[i];
+                prevCowRot[i] = cowRot[i];
+                uint8_t target = ufoAbducting[cowUfo[i]];
+                if (cowAbducting[i] == target) {
+                    cowWait[i] = cowDelay[i];
+                } else if ((cowWait[i] -= dt) <= 0.0f) {
+                    cowAbducting[i] = target;
+                    cowWait[i] = cowDelay[i];
+                    anim.play(i, target ? clips.abduct : clips.release);
+                }
+            }
+            anim.advance(dt, begin, end);
+            anim.evaluate(begin, end);
+            storePoses(begin, end);
+            bool any = false;
+            for (int i = begin; i < end; i++) {
+                cowVelY[i] = (cowPos[i].y - prevCowPos[i].y) / dt;
+                any |= i < numCows && (cowPos[i] != prevCowPos[i] || cowRot[i] != prevCowRot[i]);
+            }
+            if (any)
+                moved.store(true, std::memory_order_relaxed);
+        });
+        cowsMoving = moved.load();
+        posesChanged |= cowsMoving;
+
+        stat.stepMs = elapsedMs(t0);
+        stat.steps++;
+    }
+
+    // Matrizes de modelo entre o passo anterior e o atual (mesma interpolação do par principal)
+    void buildMatrices(float alpha)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        float t = glm::mix(prevTime, time, alpha);
+
+        // Mesmas matrizes de ufoModel/cowModel, montadas em lote
+        parallelFor(numUfos, [this, alpha, t](int begin, int end) {
+            const std::vector<float>& ufoY = anim.floats(clips.ufoY);
+            for (int u = begin; u < end; u++) {
+                float y = glm::mix(prevUfoY[u], ufoY[u], alpha);
+                ufoTransforms.setPosition(u, glm::vec3(ufoHomeX[u], y, ufoHomeZ[u]));
+                ufoTransforms.setRotation(u, axisAngleQuat(t + ufoPhase[u], glm::vec3(0, 1, 0)));
+            }
+            TransformOutputs out;
+            out.model = ufoMatrices.data();
+            transformBatch(ufoTransforms, begin, end, out);
+        });
+        parallelFor(numCows, [this, alpha](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                cowTransforms.setPosition(i, glm::mix(prevCowPos[i], cowPos[i], alpha));
+                glm::quat r = glm::slerp(prevCowRot[i], cowRot[i], alpha);
+                cowTransforms.setRotation(i, glm::vec4(r.x, r.y, r.z, r.w));
+            }
+            TransformOutputs out;
+            out.model = cowMatrices.data();
+            transformBatch(cowTransforms, begin, end, out);
+        });
+        // As matrizes das vacas só repetem as da montagem anterior se nenhuma vaca
+        // se moveu desde ela (nem estava se movendo nela: a interpolação muda com alpha)
+        if (posesChanged || cowsMoving || movingAtBuild)
+            cowGeneration++;
+        movingAtBuild = cowsMoving;
+        posesChanged = false;
+
+        stat.matricesMs = elapsedMs(t0);
+    }
+
+    int cowCount() const { return numCows; }
+    int ufoCount() const { return numUfos; }
+    int threads() const { return numThreads; }
+    const std::vector<glm::mat4>& cowModels() const { return cowMatrices; }
+    const std::vector<glm::mat4>& ufoModels() const { return ufoMatrices; }
+
+    // Muda sempre que buildMatrices() produz matrizes de vacas diferentes das
+    // anteriores (chave de cache: com as vacas paradas fica igual)
+    uint64_t cowMatricesGeneration() const { return cowGeneration; }
+
+    // Entrega as matrizes do último buildMatrices() (pacote do frame) e fica com os vetores
+    // do chamador, sem cópia; o buildMatrices() seguinte reescreve todas
+    void swapModels(std::vector<glm::mat4>& cows, std::vector<glm::mat4>& ufos)
+    {
+        cows.resize(cowMatrices.size());
+        ufos.resize(ufoMatrices.size());
+        cowMatrices.swap(cows);
+        ufoMatrices.swap(ufos);
+    }
+    const HerdStats& stats() const { return stat; }
+
+    // Vacas no alto da abdução (conferência do estado)
+    int abductedCows() const
+    {
+        int n = 0;
+        for (int i = 0; i < numCows; i++)
+            n += anim.clip(i) == clips.hover;
+        return n;
+    }
+
+private:
+    // Faixas abaixo disso não compensam um job
+    static constexpr int MIN_PER_JOB = 2048;
+    // Atraso máximo de uma vaca para seguir a troca de estado do ovni (s)
+    static constexpr float MAX_DELAY = 0.75f;
+
+    AbductionClips clips;
+    int numCows = 0, numUfos = 0, numInstances = 0;
+    int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    float time = 0.0f, prevTime = 0.0f;
+
+    // Componentes dos ovnis; a altura atual é o ovni.y da instância u
+    std::vector<float> ufoHomeX, ufoHomeZ, ufoTimer, ufoPeriod, ufoPhase, prevUfoY;
+    std::vector<uint8_t> ufoAbducting;
+
+    // Componentes das vacas (uma instância do 'anim' cada)
+    AnimationBatch anim;
+    std::vector<float> cowHomeX, cowHomeZ, cowDelay, cowWait, cowVelY;
+    std::vector<uint32_t> cowUfo;
+    std::vector<uint8_t> cowAbducting;
+    std::vector<glm::vec3> cowPos, prevCowPos;
+    std::vector<glm::quat> cowRot, prevCowRot;
+    bool cowsMoving = false, posesChanged = true, movingAtBuild = true; // para cowGeneration
+    uint64_t cowGeneration = 0;
+
+    // Entrada dos kernels de matrizes (escala sempre 1)
+    TransformSoA cowTransforms, ufoTransforms;
+    std::vector<glm::mat4> cowMatrices, ufoMatrices;
+    HerdStats stat;
+
+    // Pose amostrada das instâncias [begin, end) -> posição e rotação de cada vaca
+    void storePoses(int begin, int end)
+    {
+        const std::vector<float>& cowY = anim.floats(clips.cowY);
+        const std::vector<glm::vec3>& cowOffset = anim.vec3s(clips.cowOffset);
+        const std::vector<glm::quat>& rot = anim.quats(clips.cowRot);
+        for (int i = begin; i < end; i++) {
+            cowPos[i] = glm::vec3(cowHomeX[i], cowY[i], cowHomeZ[i]) + cowOffset[i];
+            cowRot[i] = rot[i];
+        }
+    }
+
+    static double elapsedMs(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // Faixas contíguas nos jobs do pool; com 1 thread roda tudo na chamadora
+    template <typename F>
+    void parallelFor(int n, F&& body)
+    {
+        JobSystem::global().parallelFor(n, MIN_PER_JOB, body, numThreads > 1 ? numThreads * 4 : 1);
+    }
+};
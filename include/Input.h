@@ -0,0 +1,238 @@
+#pragma once
+
+// ============== ENTRADA ==============
+// Camada de entrada por eventos, no lugar de glfwGetKey + debounce por tempo:
+//   - glfwSetKeyCallback alimenta, para cada ação ligada a uma tecla, o estado
+//     "segurada" (movimento) e uma fila de bordas de pressionamento (toggles):
+//     cada pressionamento vira exatamente um pressed(), sem esperar nem perder
+//     teclas, e sem travar o frame em glfwWaitEventsTimeout;
+//   - as ações são um enum do programa (com um último valor Count), ligadas a
+//     teclas por bind();
+//   - o mouse usa GLFW_RAW_MOUSE_MOTION quando disponível (sem aceleração do
+//     sistema) e acumula o deslocamento até takeMouseDelta();
+//   - latch() processa os eventos de novo logo antes da submissão, para a
+//     rotação da câmera usar o mouse mais recente (late latching).
+//
+// Cada evento leva o horário (glfwGetTime) em que o callback rodou; o
+// programa consome eventos e, ao submeter o frame, entrega o horário do evento
+// mais antigo usado nele ao InputLatency, que mede até a GPU terminar o frame
+// (timestamp de GPU, sem bloquear). É um limite inferior da latência até o
+// fóton: falta o tempo até o próximo vblank/scanout, que o GL não expõe.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+template <typename Action>
+class InputSystem {
+public:
+    static constexpr int ACTIONS = (int)Action::Count;
+
+    InputSystem() { keyAction.fill(-1); }
+
+    // Instala os callbacks de teclado e mouse (um InputSystem por janela)
+    void attach(GLFWwindow* w, bool rawMouse = true) {
+        instance = this;
+        glfwSetKeyCallback(w, keyCallback);
+        glfwSetCursorPosCallback(w, cursorCallback);
+        rawMotion = rawMouse && glfwRawMouseMotionSupported();
+        if (rawMotion)
+            glfwSetInputMode(w, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+    }
+
+    void bind(int key, Action action) {
+        if (key >= 0 && key <= GLFW_KEY_LAST)
+            keyAction[key] = (int)action;
+    }
+
+    bool rawMouseMotion() const { return rawMotion; }
+
+    // Alguma tecla da ação está segurada
+    bool down(Action a) const { return held[(int)a] > 0; }
+
+    // Consome um pressionamento pendente da ação (borda de descida)
+    bool pressed(Action a) {
+        std::deque<double>& q = presses[(int)a];
+        if (q.empty())
+            return false;
+        useEvent(q.front());
+        q.pop_front();
+        return true;
+    }
+
+    // Deslocamento do mouse acumulado desde a última chamada (y para cima)
+    glm::vec2 takeMouseDelta() {
+        glm::vec2 d = mouseDelta;
+        if (mouseTime >= 0.0)
+            useEvent(mouseTime);
+        mouseDelta = glm::vec2(0.0f);
+        mouseTime = -1.0;
+        return d;
+    }
+
+    // Processa os eventos que chegaram desde o último poll (late latching)
+    void latch() {
+        glfwPollEvents();
+        latchTime = glfwGetTime();
+    }
+
+    // Horário do evento mais antigo consumido desde a última chamada (-1: nenhum)
+    double takeFrameInputTime() {
+        double t = frameInput;
+        frameInput = -1.0;
+        return t;
+    }
+
+    double lastLatchTime() const { return latchTime; }
+
+private:
+    static inline InputSystem* instance = nullptr;
+
+    std::array<int, GLFW_KEY_LAST + 1> keyAction;
+    std::array<bool, GLFW_KEY_LAST + 1> keyDown = {};
+    int held[ACTIONS] = {};
+    std::deque<double> presses[ACTIONS];
+    glm::vec2 mouseDelta = glm::vec2(0.0f);
+    double mouseTime = -1.0;
+    double lastX = 0.0, lastY = 0.0;
+    bool firstMouse = true, rawMotion = false;
+    double frameInput = -1.0, latchTime = 0.0;
+
+    void useEvent(double t) {
+        frameInput = frameInput < 0.0 ? t : std::min(frameInput, t);
+    }
+
+    static void keyCallback(GLFWwindow*, int key, int, int action, int) {
+        InputSystem* self = instance;
+        if (!self || key < 0 || key > GLFW_KEY_LAST || action == GLFW_REPEAT)
+            return;
+        bool isDown = action == GLFW_PRESS;
+        if (self->keyDown[key] == isDown)
+            return;
+        self->keyDown[key] = isDown;
+        int a = self->keyAction[key];
+        if (a < 0)
+            return;
+        self->held[a] += isDown ? 1 : -1;
+        if (isDown)
+            self->presses[a].push_back(glfwGetTime());
+    }
+
+    static void cursorCallback(GLFWwindow*, double x, double y) {
+        InputSystem* self = instance;
+        if (!self)
+            return;
+        if (self->firstMouse) {
+            self->lastX = x;
+            self->lastY = y;
+            self->firstMouse = false;
+            return;
+        }
+        self->mouseDelta += glm::vec2((float)(x - self->lastX), (float)(self->lastY - y));
+        self->lastX = x;
+        self->lastY = y;
+        if (self->mouseTime < 0.0)
+            self->mouseTime = glfwGetTime();
+    }
+};
+
+// ==== LATÊNCIA ENTRADA -> GPU ====
+// submitted() depois da última chamada GL do frame, antes do swap, com o
+// horário da entrada mais antiga usada nele: grava um glQueryCounter
+// (GL_TIMESTAMP), convertido para o relógio do glfwGetTime como no Profiler.
+// poll() a cada frame lê as consultas prontas sem bloquear e guarda
+// evento -> latch e evento -> GPU terminou o frame.
+class InputLatency {
+public:
+    static constexpr int QUERIES = 8;         // frames em voo
+    static constexpr size_t MAX_SAMPLES = 4096;
+
+    void init() {
+        glGenQueries(QUERIES, queries);
+        calibrate();
+        ready = true;
+    }
+
+    void release() {
+        if (ready)
+            glDeleteQueries(QUERIES, queries);
+        ready = false;
+    }
+
+    void submitted(double inputTime, double latchTime) {
+        if (!ready || inputTime < 0.0 || inFlight == QUERIES)
+            return;
+        int slot = (first + inFlight++) % QUERIES;
+        glQueryCounter(queries[slot], GL_TIMESTAMP);
+        frames[slot] = { inputTime, latchTime };
+    }
+
+    void poll() {
+        while (ready && inFlight > 0) {
+            GLint available = 0;
+            glGetQueryObjectiv(queries[first], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+            GLuint64 gpuTime = 0;
+            glGetQueryObjectui64v(queries[first], GL_QUERY_RESULT, &gpuTime);
+            double done = gpuTime * 1e-9 + offset;
+            add(toLatch, (frames[first].latch - frames[first].input) * 1000.0);
+            add(toGpu, (done - frames[first].input) * 1000.0);
+            first = (first + 1) % QUERIES;
+            inFlight--;
+            // O relógio da GPU deriva em relação ao da CPU; recalibra de tempos em tempos
+            if (++samples % 600 == 0)
+                calibrate();
+        }
+    }
+
+    void printSummary() const {
+        if (toGpu.empty()) {
+            std::printf("[entrada] latência: nenhuma amostra (sem eventos de teclado/mouse)\n");
+            return;
+        }
+        print("evento -> latch", toLatch);
+        print("evento -> GPU terminou", toGpu);
+    }
+
+private:
+    struct Frame {
+        double input, latch;
+    };
+    GLuint queries[QUERIES] = {};
+    Frame frames[QUERIES] = {};
+    int first = 0, inFlight = 0;
+    bool ready = false;
+    double offset = 0.0; // glfwGetTime() - tempo da GPU, em segundos
+    uint64_t samples = 0;
+    std::vector<double> toLatch, toGpu; // ms, janela das últimas MAX_SAMPLES
+
+    void calibrate() {
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        offset = glfwGetTime() - gpuNow * 1e-9;
+    }
+
+    static void add(std::vector<double>& v, double ms) {
+        if (v.size() == MAX_SAMPLES)
+            v.erase(v.begin());
+        v.push_back(ms);
+    }
+
+    static void print(const char* name, std::vector<double> v) {
+        std::sort(v.begin(), v.end());
+        double sum = 0.0;
+        for (double x : v)
+            sum += x;
+        auto pct = [&](double p) { return v[std::min(v.size() - 1, (size_t)(p * v.size()))]; };
+        std::printf("[entrada] %-22s média %6.2f ms, p50 %6.2f, p99 %6.2f, máx %6.2f (%zu frames)\n", name,
+                    sum / v.size(), pct(0.5), pct(0.99), v.back(), v.size());
+    }
+};
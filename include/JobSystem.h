@@ -0,0 +1,391 @@
+#pragma once
+
+// ============== JOB SYSTEM (WORK STEALING) ==============
+// Pool fixo de threads compartilhado pelo carregamento (parse de OBJ,
+// decodificação de texturas), pelo culling e pelas atualizações por entidade,
+// no lugar de criar e juntar std::threads a cada chamada.
+//
+//   - cada worker tem uma deque Chase-Lev: o dono empilha e desempilha pelo
+//     fundo sem lock, os outros roubam pelo topo com um CAS;
+//   - a thread que criou o JobSystem (a principal, da simulação) é dona da
+//     deque 0: run() nela só empilha, e wait() executa/rouba jobs enquanto o
+//     contador não zera, em vez de bloquear;
+//   - JobCounter conta os jobs pendentes de um grupo; runAfter() agenda um
+//     job para quando outro contador zerar (dependência);
+//   - parallelFor() divide um intervalo em faixas e espera por elas, com a
+//     thread chamadora pegando a primeira;
+//   - stats() conta jobs executados, roubos e contenção (CAS perdidos no
+//     topo de uma deque), para medir o escalonamento.
+//
+// Threads que não são do pool nem a dona executam run() na hora.
+//
+// Uso:
+//   JobSystem& jobs = JobSystem::global();  // na thread principal, antes dos outros usos
+//   JobCounter grupo;
+//   jobs.run([&] { parse(a); }, &grupo);
+//   jobs.run([&] { parse(b); }, &grupo);
+//   jobs.wait(grupo);
+//   jobs.parallelFor(n, 256, [&](int begin, int end) { ... });
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define JOBSYSTEM_PAUSE() _mm_pause()
+#else
+#define JOBSYSTEM_PAUSE() std::this_thread::yield()
+#endif
+
+class JobSystem;
+struct Job;
+
+// Jobs pendentes de um grupo; wait() volta quando chega a zero
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending{ 0 };
+    std::mutex mutex; // protege o fim do grupo e a lista de continuações
+    std::vector<Job*> continuations;
+};
+
+struct Job {
+    std::function<void()> fn;
+    JobCounter* counter = nullptr;
+};
+
+struct JobStats {
+    uint64_t executed = 0;      // jobs executados
+    uint64_t stolen = 0;        // ... dos quais roubados de outra deque
+    uint64_t contention = 0;    // CAS perdidos no topo (roubo ou último job disputado)
+    uint64_t helped = 0;        // jobs executados dentro de wait()
+    uint64_t ranInline = 0;     // executados na hora (deque cheia ou thread de fora)
+    uint64_t sleeps = 0;        // vezes que um worker dormiu sem trabalho
+};
+
+class JobSystem {
+public:
+    static constexpr int DEQUE_CAPACITY = 4096; // potência de 2; cheia = executa na hora
+
+    // workers < 0: hardware_concurrency - 1 (a thread dona também trabalha)
+    explicit JobSystem(int workers = -1)
+    {
+        if (workers < 0)
+            workers = (int)std::max(1u, std::thread::hardware_concurrency()) - 1;
+        owner = std::this_thread::get_id();
+        queues.reserve(workers + 1);
+        for (int i = 0; i <= workers; i++)
+            queues.emplace_back(new WorkDeque());
+        for (int i = 1; i <= workers; i++)
+            threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    ~JobSystem()
+    {
+        running.store(false);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            sleepCv.notify_all();
+        }
+        for (std::thread& t : threads)
+            t.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Pool da aplicação, criado no primeiro uso (a thread que chama primeiro vira a dona)
+    static JobSystem& global()
+    {
+        static JobSystem system(defaultWorkers);
+        return system;
+    }
+
+    // Antes do primeiro global(): tamanho do pool (< 0: automático)
+    static void configure(int workers) { defaultWorkers = workers; }
+
+    int workerCount() const { return (int)threads.size(); }
+    int threadCount() const { return (int)threads.size() + 1; }
+
+    void run(std::function<void()> fn, JobCounter* counter = nullptr)
+    {
+        Job* job = new Job{ std::move(fn), counter };
+        if (counter)
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        submit(job);
+    }
+
+    // Agenda 'fn' para quando 'dependency' zerar
+    void runAfter(JobCounter& dependency, std::function<void()> fn, JobCounter* counter = nullptr)
+    {
+        Job* job = new Job{ std::move(fn), counter };
+        if (counter)
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(dependency.mutex);
+            if (dependency.pending.load(std::memory_order_acquire) > 0) {
+                dependency.continuations.push_back(job);
+                return;
+            }
+        }
+        submit(job);
+    }
+
+    // Executa jobs (os próprios ou roubados) até o contador zerar
+    void wait(JobCounter& counter)
+    {
+        int idle = 0;
+        while (!counter.done()) {
+            if (Job* job = find(indexOfThisThread())) {
+                execute(job);
+                add(stat.helped);
+                idle = 0;
+            } else if (++idle < 64) {
+                JOBSYSTEM_PAUSE();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        // Quem zerou o contador ainda pode estar com o mutex: espera soltar antes de devolver
+        std::lock_guard<std::mutex> lock(counter.mutex);
+    }
+
+    // Divide [0, n) em até 'maxJobs' faixas (0: 4 por thread) de pelo menos 'grain' itens
+    template <typename F>
+    void parallelFor(int n, int grain, F&& body, int maxJobs = 0)
+    {
+        if (n <= 0)
+            return;
+        int limit = maxJobs > 0 ? maxJobs : threadCount() * 4;
+        int jobs = std::max(1, std::min(limit, n / std::max(grain, 1)));
+        if (jobs == 1) {
+            body(0, n);
+            return;
+        }
+        int perJob = (n + jobs - 1) / jobs;
+        JobCounter counter;
+        for (int j = 1; j < jobs && j * perJob < n; j++)
+            run([&body, j, perJob, n]() { body(j * perJob, std::min(n, (j + 1) * perJob)); }, &counter);
+        body(0, std::min(n, perJob));
+        wait(counter);
+    }
+
+    JobStats stats() const
+    {
+        JobStats s;
+        s.executed = stat.executed.load();
+        s.stolen = stat.stolen.load();
+        s.contention = stat.contention.load();
+        s.helped = stat.helped.load();
+        s.ranInline = stat.ranInline.load();
+        s.sleeps = stat.sleeps.load();
+        return s;
+    }
+
+    void resetStats()
+    {
+        for (std::atomic<uint64_t>* c : { &stat.executed, &stat.stolen, &stat.contention, &stat.helped, &stat.ranInline,
+                                          &stat.sleeps })
+            c->store(0);
+    }
+
+private:
+    // ==== DEQUE CHASE-LEV ====
+    // Capacidade fixa (sem crescer): push() devolve false quando está cheia.
+    // Ordens de memória de "Correct and Efficient Work-Stealing for Weak
+    // Memory Models" (Lê et al., 2013).
+    struct WorkDeque {
+        std::atomic<int64_t> top{ 0 }, bottom{ 0 };
+        std::atomic<Job*> buffer[DEQUE_CAPACITY];
+
+        bool push(Job* job)
+        {
+            int64_t b = bottom.load(std::memory_order_relaxed);
+            int64_t t = top.load(std::memory_order_acquire);
+            if (b - t >= DEQUE_CAPACITY)
+                return false;
+            buffer[b & (DEQUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Só o dono; 'lost' = perdeu o último job para um ladrão
+        Job* pop(bool& lost)
+        {
+            int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+            Job* job = nullptr;
+            if (t <= b) {
+                job = buffer[b & (DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+                if (t == b) {
+                    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        job = nullptr;
+                        lost = true;
+                    }
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                }
+            } else {
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        // Qualquer thread; 'lost' = outro ladrão (ou o dono) levou o job
+        Job* steal(bool& lost)
+        {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = bottom.load(std::memory_order_acquire);
+            if (t >= b)
+                return nullptr;
+            Job* job = buffer[t & (DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                lost = true;
+                return nullptr;
+            }
+            return job;
+        }
+
+        bool maybeHasWork() const { return bottom.load(std::memory_order_acquire) > top.load(std::memory_order_acquire); }
+    };
+
+    struct Counters {
+        std::atomic<uint64_t> executed{ 0 }, stolen{ 0 }, contention{ 0 }, helped{ 0 }, ranInline{ 0 }, sleeps{ 0 };
+    };
+
+    static inline int defaultWorkers = -1;
+    static inline thread_local const JobSystem* currentSystem = nullptr;
+    static inline thread_local int currentIndex = -1;
+
+    std::thread::id owner;
+    std::vector<std::unique_ptr<WorkDeque>> queues; // 0: thread dona; 1..N: workers
+    std::vector<std::thread> threads;
+    std::atomic<bool> running{ true };
+    std::atomic<int> sleeping{ 0 };
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    Counters stat;
+
+    static void add(std::atomic<uint64_t>& c) { c.fetch_add(1, std::memory_order_relaxed); }
+
+    // Deque desta thread (-1: de fora do pool)
+    int indexOfThisThread() const
+    {
+        if (currentSystem == this)
+            return currentIndex;
+        return std::this_thread::get_id() == owner ? 0 : -1;
+    }
+
+    void submit(Job* job)
+    {
+        int index = indexOfThisThread();
+        if (index < 0 || !queues[index]->push(job)) {
+            add(stat.ranInline);
+            execute(job);
+            return;
+        }
+        // Dekker com o worker que vai dormir: ele incrementa 'sleeping' e reconfere as deques
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            sleepCv.notify_one();
+        }
+    }
+
+    // Primeiro a própria deque (LIFO, cache quente), depois rouba das outras a partir de uma vizinha
+    Job* find(int self)
+    {
+        bool lost = false;
+        if (self >= 0) {
+            if (Job* job = queues[self]->pop(lost))
+                return job;
+            if (lost)
+                add(stat.contention);
+        }
+        int n = (int)queues.size();
+        int start = self >= 0 ? self + 1 : 0;
+        for (int k = 0; k < n; k++) {
+            int victim = (start + k) % n;
+            if (victim == self)
+                continue;
+            lost = false;
+            if (Job* job = queues[victim]->steal(lost)) {
+                add(stat.stolen);
+                return job;
+            }
+            if (lost)
+                add(stat.contention);
+        }
+        return nullptr;
+    }
+
+    void execute(Job* job)
+    {
+        job->fn();
+        add(stat.executed);
+        if (JobCounter* counter = job->counter) {
+            std::vector<Job*> ready;
+            {
+                std::lock_guard<std::mutex> lock(counter->mutex);
+                if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    ready.swap(counter->continuations);
+            }
+            for (Job* next : ready)
+                submit(next);
+        }
+        delete job;
+    }
+
+    bool anyWork() const
+    {
+        for (const std::unique_ptr<WorkDeque>& q : queues)
+            if (q->maybeHasWork())
+                return true;
+        return false;
+    }
+
+    void workerLoop(int index)
+    {
+        currentSystem = this;
+        currentIndex = index;
+        int idle = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (Job* job = find(index)) {
+                execute(job);
+                idle = 0;
+                continue;
+            }
+            if (++idle < 256) {
+                JOBSYSTEM_PAUSE();
+                continue;
+            }
+            // Sem trabalho: dorme até um submit() (o timeout cobre um aviso perdido)
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleeping.fetch_add(1, std::memory_order_seq_cst);
+            if (!anyWork() && running.load()) {
+                add(stat.sleeps);
+                sleepCv.wait_for(lock, std::chrono::milliseconds(5));
+            }
+            sleeping.fetch_sub(1, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+};
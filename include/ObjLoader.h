@@ -0,0 +1,186 @@
+#pragma once
+
+// ============== LEITURA DE OBJ/MTL (CPU) ==============
+// Parte do carregamento de modelos que não depende do GL, separada em duas
+// etapas para poder ser medida (cg_bench) e reaproveitada:
+//   parseOBJ/parseMTL: texto -> posições, UVs, normais, índices das faces e materiais
+//   assembleMeshParts: índices -> vértices intercalados (Vertex), um MeshPart por
+//                      usemtl dentro de cada objeto ("o"), com o nome do objeto
+// A criação de texturas e VAOs continua em quem chama.
+
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#include <glm/glm.hpp>
+
+struct Vertex {
+    glm::vec3 position;
+    glm::vec2 texCoord;
+    glm::vec3 normal;
+};
+
+struct Material {
+    glm::vec3 ka = glm::vec3(0.1f);
+    glm::vec3 kd = glm::vec3(1.0f);
+    glm::vec3 ks = glm::vec3(0.5f);
+    float shininess = 32.0f;
+};
+
+// Índices (base 1, como no arquivo) de um canto de face
+struct ObjCorner {
+    int p, t, n;
+};
+
+// Faces entre dois usemtl ou "o"
+struct ObjGroup {
+    std::string object; // último "o" antes das faces (vazio se não houver)
+    std::string material;
+    std::vector<ObjCorner> corners; // 3 por triângulo
+};
+
+struct ObjData {
+    std::string mtlDir;
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<ObjGroup> groups;
+    std::map<std::string, Material> materials;
+    std::map<std::string, std::string> textures; // map_Kd por material
+};
+
+struct MeshPart {
+    std::vector<Vertex> vertices;
+    std::string object;
+    Material material;
+    std::string texture; // caminho completo, vazio se o material não tem map_Kd
+};
+
+// Acrescenta os materiais de um .mtl em 'data'
+inline bool parseMTL(const std::string& path, ObjData& data)
+{
+    std::ifstream mtl(path);
+    if (!mtl.is_open())
+        return false;
+    std::string mline, matName;
+
+    while (std::getline(mtl, mline))
+    {
+        std::istringstream mss(mline);
+        std::string tag;
+        mss >> tag;
+
+        if (tag == "newmtl") {
+            mss >> matName;
+            data.materials[matName] = Material(); // inicia material
+        }
+        else if (tag == "Ka")
+            mss >> data.materials[matName].ka.r >> data.materials[matName].ka.g >> data.materials[matName].ka.b;
+        else if (tag == "Kd")
+            mss >> data.materials[matName].kd.r >> data.materials[matName].kd.g >> data.materials[matName].kd.b;
+        else if (tag == "Ks")
+            mss >> data.materials[matName].ks.r >> data.materials[matName].ks.g >> data.materials[matName].ks.b;
+        else if (tag == "Ns")
+            mss >> data.materials[matName].shininess;
+        else if (tag == "map_Kd")
+            mss >> data.textures[matName];
+    }
+    return true;
+}
+
+inline bool parseOBJ(const std::string& objPath, const std::string& mtlDir, ObjData& data)
+{
+    std::ifstream file(objPath);
+    if (!file.is_open())
+        return false;
+
+    data.mtlDir = mtlDir;
+    data.groups.emplace_back(); // faces antes do primeiro usemtl
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        std::istringstream iss(line);
+        std::string prefix;
+        iss >> prefix;
+
+        if (prefix == "v")
+        {
+            float x, y, z;
+            iss >> x >> y >> z;
+            data.positions.emplace_back(x, y, z);
+        }
+        else if (prefix == "vt")
+        {
+            float u, v;
+            iss >> u >> v;
+            data.texCoords.emplace_back(u, 1.0f - v);
+        }
+        else if (prefix == "vn")
+        {
+            float x, y, z;
+            iss >> x >> y >> z;
+            data.normals.emplace_back(x, y, z);
+        }
+        else if (prefix == "f")
+        {
+            std::string v1, v2, v3;
+            iss >> v1 >> v2 >> v3;
+            std::string vs[] = {v1, v2, v3};
+            for (auto& v : vs)
+            {
+                ObjCorner c = {0, 0, 0};
+                sscanf(v.c_str(), "%d/%d/%d", &c.p, &c.t, &c.n);
+                data.groups.back().corners.push_back(c);
+            }
+        }
+        else if (prefix == "mtllib")
+        {
+            std::string mtlFile;
+            iss >> mtlFile;
+            parseMTL(mtlDir + "/" + mtlFile, data);
+        }
+        else if (prefix == "usemtl")
+        {
+            std::string mtlName;
+            iss >> mtlName;
+            if (!data.groups.back().corners.empty())
+                data.groups.emplace_back(ObjGroup{ data.groups.back().object, "", {} });
+            data.groups.back().material = mtlName;
+        }
+        else if (prefix == "o")
+        {
+            // Objeto novo continua com o material atual até o próximo usemtl
+            std::string objName;
+            iss >> objName;
+            if (!data.groups.back().corners.empty())
+                data.groups.emplace_back(ObjGroup{ "", data.groups.back().material, {} });
+            data.groups.back().object = objName;
+        }
+    }
+    return true;
+}
+
+// Monta os vértices de cada grupo (grupos vazios são ignorados)
+inline void assembleMeshParts(const ObjData& data, std::vector<MeshPart>& parts)
+{
+    for (const ObjGroup& g : data.groups) {
+        if (g.corners.empty())
+            continue;
+        MeshPart part;
+        part.object = g.object;
+        auto mat = data.materials.find(g.material);
+        if (mat != data.materials.end())
+            part.material = mat->second;
+        auto tex = data.textures.find(g.material);
+        if (tex != data.textures.end())
+            part.texture = data.mtlDir + "/" + tex->second;
+
+        part.vertices.reserve(g.corners.size());
+        for (const ObjCorner& c : g.corners)
+            part.vertices.push_back({data.positions[c.p - 1], data.texCoords[c.t - 1], data.normals[c.n - 1]});
+        parts.push_back(std::move(part));
+    }
+}
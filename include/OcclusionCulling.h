@@ -0,0 +1,362 @@
+#pragma once
+
+// ============== OCCLUSION CULLING (MASKED DEPTH BUFFER) ==============
+// Rasterizador de profundidade em CPU, de baixa resolução, no estilo do
+// "masked occlusion culling": a tela é dividida em tiles de 32x8 pixels e cada
+// tile guarda uma máscara de cobertura e duas camadas de profundidade
+// conservadora (zMax0 = camada de referência, zMax1 = camada de trabalho).
+// Os oclusores são desenhados primeiro; depois as AABBs dos demais objetos são
+// testadas contra o buffer antes de seus draws serem submetidos.
+//
+// A profundidade usada é a z da NDC remapeada para [0, 1] (maior = mais longe).
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include <Profiler.h>
+#include <JobSystem.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OCCLUSION_USE_SSE 1
+#endif
+
+struct OcclusionTile {
+    uint32_t mask[8]; // uma palavra por linha do tile (32 pixels)
+    float zMax0;      // tile inteiro coberto com profundidade <= zMax0
+    float zMax1;      // profundidade máxima dos pixels marcados em mask
+};
+
+struct OcclusionStats {
+    int occluderTriangles = 0;
+    int tested = 0;
+    int occluded = 0;
+};
+
+class OcclusionCuller {
+public:
+    static const int TILE_W = 32;
+    static const int TILE_H = 8;
+
+    OcclusionCuller(int width = 320, int height = 192, int threads = 0)
+    {
+        resize(width, height);
+        setThreads(threads);
+    }
+
+    // Arredonda a resolução para múltiplos do tamanho do tile
+    void resize(int width, int height)
+    {
+        tilesX = std::max(1, (width + TILE_W - 1) / TILE_W);
+        tilesY = std::max(1, (height + TILE_H - 1) / TILE_H);
+        tiles.resize(tilesX * tilesY);
+        bins.resize(tilesY);
+    }
+
+    void setThreads(int threads)
+    {
+        if (threads <= 0)
+            threads = (int)std::thread::hardware_concurrency();
+        numThreads = std::max(1, threads);
+    }
+
+    int width() const { return tilesX * TILE_W; }
+    int height() const { return tilesY * TILE_H; }
+    int threads() const { return numThreads; }
+    const OcclusionStats& stats() const { return frameStats; }
+
+    void beginFrame(const glm::mat4& viewProj)
+    {
+        this->viewProj = viewProj;
+        triangles.clear();
+        for (auto& bin : bins)
+            bin.clear();
+        for (OcclusionTile& t : tiles) {
+            for (uint32_t& m : t.mask)
+                m = 0;
+            t.zMax0 = 1.0f;
+            t.zMax1 = 0.0f;
+        }
+        frameStats = OcclusionStats();
+    }
+
+    // Lista de triângulos (3 vértices por triângulo); stride em bytes entre posições
+    void addOccluder(const float* positions, size_t stride, size_t vertexCount, const glm::mat4& model)
+    {
+        glm::mat4 mvp = viewProj * model;
+        const char* base = reinterpret_cast<const char*>(positions);
+
+        for (size_t i = 0; i + 2 < vertexCount; i += 3) {
+            glm::vec4 clip[3];
+            for (int k = 0; k < 3; k++) {
+                const float* p = reinterpret_cast<const float*>(base + (i + k) * stride);
+                clip[k] = mvp * glm::vec4(p[0], p[1], p[2], 1.0f);
+            }
+            clipAndBin(clip);
+        }
+    }
+
+    // Rasteriza os oclusores: cada linha de tiles é um bin e um job do JobSystem
+    // (as linhas mais cheias são equilibradas por roubo); com 1 thread, tudo na chamadora
+    void rasterizeOccluders()
+    {
+        JobSystem::global().parallelFor(tilesY, 1, [&](int begin, int end) {
+            PROFILE_SCOPE("oclusao_rasterizacao");
+            for (int ty = begin; ty < end; ty++) {
+                for (int tri : bins[ty])
+                    rasterizeTriangleInRow(triangles[tri], ty);
+            }
+        }, numThreads > 1 ? tilesY : 1);
+
+        frameStats.occluderTriangles = (int)triangles.size();
+    }
+
+    // Retorna true se alguma parte da AABB (em espaço de objeto) pode estar visível
+    bool testAABB(const glm::vec3& bmin, const glm::vec3& bmax, const glm::mat4& model)
+    {
+        frameStats.tested++;
+        bool visible = isAABBVisible(bmin, bmax, model);
+        if (!visible)
+            frameStats.occluded++;
+        return visible;
+    }
+
+    // Profundidade conservadora por pixel (linha 0 = base da tela), para depuração
+    void resolveDepth(std::vector<float>& out) const
+    {
+        int w = width(), h = height();
+        out.resize((size_t)w * h);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                const OcclusionTile& t = tiles[(y / TILE_H) * tilesX + (x / TILE_W)];
+                bool working = (t.mask[y % TILE_H] >> (x % TILE_W)) & 1u;
+                out[(size_t)y * w + x] = working ? std::min(t.zMax0, t.zMax1) : t.zMax0;
+            }
+        }
+    }
+
+private:
+    struct ScreenTri {
+        float x[3], y[3], z[3];
+    };
+
+    int tilesX = 0, tilesY = 0;
+    int numThreads = 1;
+    glm::mat4 viewProj = glm::mat4(1.0f);
+    std::vector<OcclusionTile> tiles;
+    std::vector<ScreenTri> triangles;
+    std::vector<std::vector<int>> bins;
+    OcclusionStats frameStats;
+
+    bool isAABBVisible(const glm::vec3& bmin, const glm::vec3& bmax, const glm::mat4& model) const
+    {
+        glm::mat4 mvp = viewProj * model;
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, minZ = 1.0f;
+
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner((i & 1) ? bmax.x : bmin.x, (i & 2) ? bmax.y : bmin.y, (i & 4) ? bmax.z : bmin.z);
+            glm::vec4 c = mvp * glm::vec4(corner, 1.0f);
+            if (c.w <= 1e-5f || c.z < -c.w)
+                return true; // cruza o plano near: não dá para decidir, considera visível
+            float invW = 1.0f / c.w;
+            float sx = (c.x * invW * 0.5f + 0.5f) * width();
+            float sy = (c.y * invW * 0.5f + 0.5f) * height();
+            minX = std::min(minX, sx);
+            maxX = std::max(maxX, sx);
+            minY = std::min(minY, sy);
+            maxY = std::max(maxY, sy);
+            minZ = std::min(minZ, c.z * invW * 0.5f + 0.5f);
+        }
+
+        if (maxX < 0.0f || maxY < 0.0f || minX >= width() || minY >= height())
+            return false; // fora da tela
+
+        int tx0 = std::max(0, (int)minX / TILE_W), tx1 = std::min(tilesX - 1, (int)maxX / TILE_W);
+        int ty0 = std::max(0, (int)minY / TILE_H), ty1 = std::min(tilesY - 1, (int)maxY / TILE_H);
+        for (int ty = ty0; ty <= ty1; ty++)
+            for (int tx = tx0; tx <= tx1; tx++)
+                if (minZ < tiles[ty * tilesX + tx].zMax0)
+                    return true;
+        return false;
+    }
+
+    // Recorta contra o plano near (z >= -w) e envia o(s) triângulo(s) resultante(s) aos bins
+    void clipAndBin(const glm::vec4 clip[3])
+    {
+        glm::vec4 poly[4];
+        int n = 0;
+        for (int i = 0; i < 3; i++) {
+            const glm::vec4& a = clip[i];
+            const glm::vec4& b = clip[(i + 1) % 3];
+            float da = a.z + a.w, db = b.z + b.w;
+            if (da >= 0.0f)
+                poly[n++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f))
+                poly[n++] = a + (b - a) * (da / (da - db));
+        }
+        for (int i = 1; i + 1 < n; i++) {
+            glm::vec4 tri[3] = { poly[0], poly[i], poly[i + 1] };
+            binTriangle(tri);
+        }
+    }
+
+    void binTriangle(const glm::vec4 clip[3])
+    {
+        ScreenTri t;
+        for (int k = 0; k < 3; k++) {
+            float invW = 1.0f / std::max(clip[k].w, 1e-6f);
+            t.x[k] = (clip[k].x * invW * 0.5f + 0.5f) * width();
+            t.y[k] = (clip[k].y * invW * 0.5f + 0.5f) * height();
+            t.z[k] = clip[k].z * invW * 0.5f + 0.5f;
+        }
+
+        float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.y[1] - t.y[0]) * (t.x[2] - t.x[0]);
+        if (std::fabs(area) < 1e-8f)
+            return;
+        if (area < 0.0f) { // garante orientação anti-horária
+            std::swap(t.x[1], t.x[2]);
+            std::swap(t.y[1], t.y[2]);
+            std::swap(t.z[1], t.z[2]);
+        }
+
+        float minX = std::min({ t.x[0], t.x[1], t.x[2] }), maxX = std::max({ t.x[0], t.x[1], t.x[2] });
+        float minY = std::min({ t.y[0], t.y[1], t.y[2] }), maxY = std::max({ t.y[0], t.y[1], t.y[2] });
+        if (maxX < 0.0f || maxY < 0.0f || minX >= width() || minY >= height())
+            return;
+
+        int ty0 = std::max(0, (int)minY / TILE_H);
+        int ty1 = std::min(tilesY - 1, (int)maxY / TILE_H);
+        int index = (int)triangles.size();
+        triangles.push_back(t);
+        for (int ty = ty0; ty <= ty1; ty++)
+            bins[ty].push_back(index);
+    }
+
+    void rasterizeTriangleInRow(const ScreenTri& t, int ty)
+    {
+        // Funções de aresta E(x, y) = A*x + B*y + C, positivas no interior
+        float A[3], B[3], C[3];
+        for (int i = 0; i < 3; i++) {
+            int j = (i + 1) % 3;
+            A[i] = -(t.y[j] - t.y[i]);
+            B[i] = t.x[j] - t.x[i];
+            C[i] = -(A[i] * t.x[i] + B[i] * t.y[i]);
+        }
+
+        // Plano de profundidade z(x, y) = z0 + dzdx*(x - x0) + dzdy*(y - y0)
+        float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.y[1] - t.y[0]) * (t.x[2] - t.x[0]);
+        float dzdx = ((t.z[1] - t.z[0]) * (t.y[2] - t.y[0]) - (t.z[2] - t.z[0]) * (t.y[1] - t.y[0])) / area;
+        float dzdy = ((t.z[2] - t.z[0]) * (t.x[1] - t.x[0]) - (t.z[1] - t.z[0]) * (t.x[2] - t.x[0])) / area;
+        float triMinZ = std::min({ t.z[0], t.z[1], t.z[2] });
+        float triMaxZ = std::max({ t.z[0], t.z[1], t.z[2] });
+
+        float minX = std::min({ t.x[0], t.x[1], t.x[2] }), maxX = std::max({ t.x[0], t.x[1], t.x[2] });
+        int tx0 = std::max(0, (int)minX / TILE_W);
+        int tx1 = std::min(tilesX - 1, (int)maxX / TILE_W);
+
+        for (int tx = tx0; tx <= tx1; tx++) {
+            float x0 = (float)(tx * TILE_W), y0 = (float)(ty * TILE_H);
+
+            // Profundidade conservadora do triângulo dentro do tile
+            float zc[4];
+            for (int c = 0; c < 4; c++) {
+                float cx = x0 + ((c & 1) ? TILE_W : 0), cy = y0 + ((c & 2) ? TILE_H : 0);
+                zc[c] = t.z[0] + dzdx * (cx - t.x[0]) + dzdy * (cy - t.y[0]);
+            }
+            float zTileMin = std::max(triMinZ, std::min({ zc[0], zc[1], zc[2], zc[3] }));
+            float zTileMax = std::min(triMaxZ, std::max({ zc[0], zc[1], zc[2], zc[3] }));
+
+            OcclusionTile& tile = tiles[ty * tilesX + tx];
+            if (zTileMin >= tile.zMax0)
+                continue; // triângulo inteiro atrás da camada de referência
+
+            uint32_t coverage[TILE_H];
+            uint32_t any = computeCoverage(A, B, C, x0, y0, coverage);
+            if (!any)
+                continue;
+
+            updateTile(tile, coverage, zTileMax);
+        }
+    }
+
+    static uint32_t computeCoverage(const float A[3], const float B[3], const float C[3], float x0, float y0, uint32_t coverage[TILE_H])
+    {
+        uint32_t any = 0;
+#ifdef OCCLUSION_USE_SSE
+        const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 a[3], step[3];
+        for (int e = 0; e < 3; e++) {
+            a[e] = _mm_set1_ps(A[e]);
+            step[e] = _mm_set1_ps(A[e] * 4.0f);
+        }
+        __m128 px = _mm_add_ps(_mm_set1_ps(x0), offsets);
+
+        for (int r = 0; r < TILE_H; r++) {
+            float py = y0 + r + 0.5f;
+            __m128 e[3];
+            for (int k = 0; k < 3; k++)
+                e[k] = _mm_add_ps(_mm_mul_ps(a[k], px), _mm_set1_ps(B[k] * py + C[k]));
+
+            uint32_t row = 0;
+            for (int g = 0; g < TILE_W / 4; g++) {
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e[0], zero), _mm_cmpge_ps(e[1], zero)), _mm_cmpge_ps(e[2], zero));
+                row |= (uint32_t)_mm_movemask_ps(inside) << (g * 4);
+                for (int k = 0; k < 3; k++)
+                    e[k] = _mm_add_ps(e[k], step[k]);
+            }
+            coverage[r] = row;
+            any |= row;
+        }
+#else
+        for (int r = 0; r < TILE_H; r++) {
+            float py = y0 + r + 0.5f;
+            uint32_t row = 0;
+            for (int c = 0; c < TILE_W; c++) {
+                float px = x0 + c + 0.5f;
+                bool inside = true;
+                for (int k = 0; k < 3; k++)
+                    inside = inside && (A[k] * px + B[k] * py + C[k] >= 0.0f);
+                row |= (uint32_t)inside << c;
+            }
+            coverage[r] = row;
+            any |= row;
+        }
+#endif
+        return any;
+    }
+
+    // Regra de atualização do masked occlusion culling (Hasselgren et al.)
+    static void updateTile(OcclusionTile& tile, const uint32_t coverage[TILE_H], float zTri)
+    {
+        // Se o triângulo está muito mais próximo que a camada de trabalho, ela é descartada
+        float dist1t = tile.zMax1 - zTri;
+        float dist01 = tile.zMax0 - tile.zMax1;
+        if (dist1t > dist01) {
+            tile.zMax1 = 0.0f;
+            for (uint32_t& m : tile.mask)
+                m = 0;
+        }
+
+        tile.zMax1 = std::max(tile.zMax1, zTri);
+        uint32_t full = ~0u;
+        for (int r = 0; r < TILE_H; r++) {
+            tile.mask[r] |= coverage[r];
+            full &= tile.mask[r];
+        }
+
+        // Camada de trabalho cobriu o tile inteiro: vira a nova referência
+        if (full == ~0u) {
+            tile.zMax0 = std::min(tile.zMax0, tile.zMax1);
+            tile.zMax1 = 0.0f;
+            for (uint32_t& m : tile.mask)
+                m = 0;
+        }
+    }
+};
@@ -0,0 +1,269 @@
+#pragma once
+
+// ============== PARTÍCULAS DO RAIO TRATOR ==============
+// O raio entre o ovni e o chão como um conjunto fixo de partículas (até 1M),
+// com as mesmas regras rodando em dois lugares:
+//   - GpuParticles (GpuParticles.h): estado em SSBOs, emissão, atualização e
+//     compactação em compute shaders, desenho indireto; a CPU só manda a
+//     quantidade a emitir e os parâmetros do raio;
+//   - CpuParticles (aqui): o fallback sem compute (contexto < 4.3), em SoA,
+//     quatro partículas por vez com SSE, em faixas no JobSystem.
+// Regras (os compute shaders da CenaFinal fazem a mesma conta):
+//   - nasce num ponto sorteado do cone do raio (baseRadius no chão, topRadius
+//     no ovni), com vida em [minLife, maxLife] e subida/giro próprios;
+//   - a cada passo gira em volta do eixo (rotação de ângulo pequeno), encolhe
+//     o raio e sobe; morre quando a vida acaba ou passa da altura do ovni;
+//   - a emissão é uma taxa (partículas/s) com o resto guardado entre frames;
+//     o k-ésimo nascimento do frame reaproveita a k-ésima morta na ordem dos
+//     índices, com a semente k: sem disputa entre threads ou invocações, o
+//     resultado não depende do agendamento nem do número de threads.
+// Posições relativas à base do raio: o desenho soma BeamEmitter::base.
+//
+// Sem GL: o cg_bench mede o CpuParticles.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <JobSystem.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLES_USE_SSE 1
+#endif
+
+struct BeamEmitter {
+    glm::vec3 base = glm::vec3(0.0f); // centro do raio no chão
+    float height = 5.0f;              // até a parte de baixo do ovni
+    float baseRadius = 1.6f, topRadius = 0.4f;
+    float minLife = 1.0f, maxLife = 2.5f;
+    float riseSpeed = 2.0f;   // m/s (±30% por partícula)
+    float swirl = 1.5f;       // rad/s (0.5x a 1.5x por partícula)
+    float contraction = 0.2f; // fração do raio perdida por segundo
+    float rate = 0.0f;        // partículas/s; 0 = raio desligado
+};
+
+// Taxa * dt em nascimentos inteiros, sem perder a fração entre frames
+struct ParticleEmission {
+    float carry = 0.0f;
+
+    int take(float rate, float dt)
+    {
+        if (rate <= 0.0f) {
+            carry = 0.0f;
+            return 0;
+        }
+        carry += rate * dt;
+        int n = (int)carry;
+        carry -= (float)n;
+        return n;
+    }
+};
+
+// Hash de inteiros (o mesmo 'hash' dos compute shaders) e um float em [0, 1)
+inline uint32_t particleHash(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+inline float particleRandom(uint32_t& state)
+{
+    state = particleHash(state);
+    return (float)(state >> 8) * (1.0f / 16777216.0f);
+}
+
+// Semente do n-ésimo nascimento de um frame
+inline uint32_t particleSeed(uint32_t n, uint32_t frame)
+{
+    return particleHash(n + frame * 0x9e3779b9u);
+}
+
+struct ParticleSpawn {
+    glm::vec3 position; // relativa à base
+    float life, rise, swirl;
+};
+
+inline ParticleSpawn spawnParticle(const BeamEmitter& e, uint32_t seed)
+{
+    ParticleSpawn p;
+    float h = particleRandom(seed);
+    float r = std::sqrt(particleRandom(seed)) * glm::mix(e.baseRadius, e.topRadius, h);
+    float angle = particleRandom(seed) * 6.2831853f;
+    p.position = glm::vec3(std::cos(angle) * r, h * e.height, std::sin(angle) * r);
+    p.life = glm::mix(e.minLife, e.maxLife, particleRandom(seed));
+    p.rise = e.riseSpeed * (0.7f + 0.6f * particleRandom(seed));
+    p.swirl = e.swirl * (0.5f + particleRandom(seed));
+    return p;
+}
+
+class CpuParticles {
+public:
+    float updateMs = 0.0f; // tempo da última atualização
+
+    // Capacidade arredondada para múltiplo de 4 (um registrador SSE); todas começam mortas
+    void init(size_t capacity, int threads = 0)
+    {
+        setThreads(threads);
+        count = (capacity + 3) & ~(size_t)3;
+        x.assign(count, 0.0f);
+        y.assign(count, 0.0f);
+        z.assign(count, 0.0f);
+        life.assign(count, 0.0f);
+        invLife.assign(count, 0.0f);
+        rise.assign(count, 0.0f);
+        swirl.assign(count, 0.0f);
+        packed.assign(count, glm::vec4(0.0f));
+        alive = 0;
+        frame = 0;
+        emission.carry = 0.0f;
+    }
+
+    void setThreads(int threads) { numThreads = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency()); }
+    int threads() const { return numThreads; }
+
+    size_t capacity() const { return count; }
+    size_t aliveCount() const { return alive; }
+
+    // (posição relativa, alpha) por partícula, pronto para o VBO; mortas com alpha 0
+    const glm::vec4* data() const { return packed.data(); }
+
+    // Entrega a saída do último update() (pacote do frame) e fica com o vetor do chamador;
+    // o update() seguinte escreve todas as partículas
+    void swapOutput(std::vector<glm::vec4>& out)
+    {
+        out.resize(count);
+        packed.swap(out);
+    }
+
+    // Um passo: integra as vivas, mata e renasce conforme a taxa. Quem renasce e com que
+    // semente depende só do índice (a k-ésima morta na ordem dos índices recebe o
+    // k-ésimo nascimento do frame), não das threads: com --dt o resultado se repete
+    void update(const BeamEmitter& e, float dt)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        uint32_t budget = (uint32_t)std::min((size_t)emission.take(e.rate, dt), count);
+        uint32_t f = frame++;
+        int ranges = (int)((count + RANGE - 1) / RANGE);
+        int jobs = numThreads > 1 ? numThreads * 4 : 1;
+        rangeDead.resize(ranges);
+        rangeFirst.resize(ranges);
+
+        // 1. integra cada faixa e conta as mortas
+        JobSystem::global().parallelFor(ranges, 1, [&](int begin, int end) {
+            for (int r = begin; r < end; r++)
+                rangeDead[r] = integrate(e, dt, (size_t)r * RANGE, std::min(count, (size_t)(r + 1) * RANGE));
+        }, jobs);
+
+        // 2. prefixo exclusivo das mortas: cada faixa fica com a sua fatia dos nascimentos
+        uint32_t dead = 0;
+        for (int r = 0; r < ranges; r++) {
+            rangeFirst[r] = dead;
+            dead += rangeDead[r];
+        }
+
+        // 3. renasce as primeiras mortas de cada faixa que ainda cabem no orçamento
+        JobSystem::global().parallelFor(ranges, 1, [&](int begin, int end) {
+            for (int r = begin; r < end; r++) {
+                uint32_t first = rangeFirst[r];
+                uint32_t n = first < budget ? std::min(rangeDead[r], budget - first) : 0;
+                if (n > 0)
+                    respawn(e, f, (size_t)r * RANGE, first, n);
+            }
+        }, jobs);
+
+        alive = count - dead + std::min(dead, budget);
+        auto stop = std::chrono::high_resolution_clock::now();
+        updateMs = std::chrono::duration<float, std::milli>(stop - start).count();
+    }
+
+private:
+    static constexpr size_t RANGE = 16384; // partículas por faixa (fixa: não depende das threads)
+
+    size_t count = 0, alive = 0;
+    uint32_t frame = 0;
+    int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    ParticleEmission emission;
+    std::vector<float> x, y, z, life, invLife, rise, swirl;
+    std::vector<glm::vec4> packed;
+    std::vector<uint32_t> rangeDead, rangeFirst;
+
+    // Partículas [begin, end); devolve quantas estão mortas (vida zerada)
+    uint32_t integrate(const BeamEmitter& e, float dt, size_t begin, size_t end)
+    {
+        uint32_t dead = 0;
+        float shrink = std::max(0.0f, 1.0f - e.contraction * dt);
+#ifdef PARTICLES_USE_SSE
+        __m128 vdt = _mm_set1_ps(dt), vshrink = _mm_set1_ps(shrink), vheight = _mm_set1_ps(e.height);
+        __m128 zero = _mm_setzero_ps();
+        for (size_t i = begin; i < end; i += 4) {
+            __m128 px = _mm_loadu_ps(&x[i]), py = _mm_loadu_ps(&y[i]), pz = _mm_loadu_ps(&z[i]);
+            __m128 angle = _mm_mul_ps(_mm_loadu_ps(&swirl[i]), vdt);
+            __m128 nx = _mm_mul_ps(_mm_sub_ps(px, _mm_mul_ps(pz, angle)), vshrink);
+            __m128 nz = _mm_mul_ps(_mm_add_ps(pz, _mm_mul_ps(px, angle)), vshrink);
+            __m128 ny = _mm_add_ps(py, _mm_mul_ps(_mm_loadu_ps(&rise[i]), vdt));
+            __m128 nl = _mm_sub_ps(_mm_loadu_ps(&life[i]), vdt);
+            __m128 died = _mm_or_ps(_mm_cmple_ps(nl, zero), _mm_cmpgt_ps(ny, vheight));
+            nl = _mm_andnot_ps(died, nl);
+            __m128 alpha = _mm_mul_ps(nl, _mm_loadu_ps(&invLife[i]));
+            _mm_storeu_ps(&x[i], nx);
+            _mm_storeu_ps(&y[i], ny);
+            _mm_storeu_ps(&z[i], nz);
+            _mm_storeu_ps(&life[i], nl);
+            // SoA -> (x, y, z, alpha) por partícula
+            __m128 r0 = nx, r1 = ny, r2 = nz, r3 = alpha;
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(&packed[i].x, r0);
+            _mm_storeu_ps(&packed[i + 1].x, r1);
+            _mm_storeu_ps(&packed[i + 2].x, r2);
+            _mm_storeu_ps(&packed[i + 3].x, r3);
+            int mask = _mm_movemask_ps(died);
+            dead += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+        }
+#else
+        for (size_t i = begin; i < end; i++) {
+            float angle = swirl[i] * dt;
+            float nx = (x[i] - z[i] * angle) * shrink, nz = (z[i] + x[i] * angle) * shrink;
+            x[i] = nx;
+            z[i] = nz;
+            y[i] += rise[i] * dt;
+            life[i] -= dt;
+            if (life[i] <= 0.0f || y[i] > e.height) {
+                life[i] = 0.0f;
+                dead++;
+            }
+            packed[i] = glm::vec4(nx, y[i], nz, life[i] * invLife[i]);
+        }
+#endif
+        return dead;
+    }
+
+    // Renasce as 'n' primeiras mortas a partir de 'begin'; 'first' é o índice do
+    // nascimento da primeira delas no frame (a semente)
+    void respawn(const BeamEmitter& e, uint32_t f, size_t begin, uint32_t first, uint32_t n)
+    {
+        for (size_t i = begin; n > 0; i++) {
+            if (life[i] != 0.0f)
+                continue;
+            ParticleSpawn s = spawnParticle(e, particleSeed(first++, f));
+            x[i] = s.position.x;
+            y[i] = s.position.y;
+            z[i] = s.position.z;
+            life[i] = s.life;
+            invLife[i] = 1.0f / s.life;
+            rise[i] = s.rise;
+            swirl[i] = s.swirl;
+            packed[i] = glm::vec4(s.position, 1.0f);
+            n--;
+        }
+    }
+};
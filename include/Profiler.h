@@ -0,0 +1,311 @@
+#pragma once
+
+// ============== PROFILER (CPU + GPU) ==============
+// Escopos RAII medem trechos de CPU e gravam (nome, início, fim) num buffer
+// circular da própria thread: gravar é só escrever no buffer e publicar o
+// índice com um store atômico, sem lock nem alocação. Os buffers ficam num
+// registro global e são reaproveitados quando uma thread termina; os workers
+// do JobSystem (oclusão, clusters, rebanho...) são persistentes e ficam cada
+// um com o seu. Cada buffer vira uma "trilha" no trace.
+//
+// Na GPU, cada escopo grava dois glQueryCounter(GL_TIMESTAMP). As consultas
+// de um frame só são lidas GPU_FRAMES frames depois e, se ainda não ficaram
+// prontas, são descartadas: o profiler nunca espera a GPU. Timestamps (ao
+// contrário de GL_TIME_ELAPSED) podem ser aninhados e convivem com as
+// consultas do frame graph.
+//
+// writeChromeTrace() grava tudo no formato JSON do chrome://tracing / Perfetto.
+// Pode rodar com as outras threads gravando (a CenaFinal exporta na thread de
+// render enquanto a simulação usa o pool): copia cada buffer só até o índice
+// publicado e, depois da cópia, descarta o começo que o anel pode ter
+// sobrescrito enquanto isso.
+//
+//   PROFILE_SCOPE("oclusao");        // até o fim do bloco
+//   GPU_PROFILE_SCOPE("chao");       // precisa de Profiler::initGpu() e beginGpuFrame()
+//
+// Os nomes precisam durar até a exportação (literais ou strings que não mudam).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include <glad/glad.h>
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t start, end; // ns desde Profiler::epoch
+};
+
+class Profiler {
+public:
+    static constexpr size_t EVENTS_PER_THREAD = 1 << 15;
+    static constexpr int GPU_FRAMES = 4;
+    static constexpr int GPU_SCOPES_PER_FRAME = 64;
+    static constexpr size_t GPU_EVENTS = 1 << 15;
+
+    static void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    static uint64_t now()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    // Nome da trilha da thread atual (ex.: "principal")
+    static void setThreadName(const char* name) { localBuffer()->name = name; }
+
+    static void record(const char* name, uint64_t start, uint64_t end)
+    {
+        ThreadBuffer* b = localBuffer();
+        uint64_t h = b->head.load(std::memory_order_relaxed);
+        b->events[h & (EVENTS_PER_THREAD - 1)] = { name, start, end };
+        b->head.store(h + 1, std::memory_order_release);
+    }
+
+    // ==== GPU ====
+    static void initGpu()
+    {
+        glGenQueries(GPU_FRAMES * GPU_SCOPES_PER_FRAME * 2, &gpuQueries[0][0]);
+        gpuEvents.resize(GPU_EVENTS);
+        calibrateGpu();
+        gpuReady = true;
+    }
+
+    static void releaseGpu()
+    {
+        if (gpuReady)
+            glDeleteQueries(GPU_FRAMES * GPU_SCOPES_PER_FRAME * 2, &gpuQueries[0][0]);
+        gpuReady = false;
+    }
+
+    // Chamado uma vez por frame, antes do primeiro escopo de GPU: lê o frame de GPU_FRAMES atrás
+    static void beginGpuFrame()
+    {
+        if (!gpuReady)
+            return;
+        gpuSlot = (int)(gpuFrame++ % GPU_FRAMES);
+        GpuFrame& f = gpuFrames[gpuSlot];
+        if (f.count > 0) {
+            GLint available = 0;
+            glGetQueryObjectiv(gpuQueries[gpuSlot][f.count * 2 - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                for (int i = 0; i < f.count; i++) {
+                    GLuint64 t0 = 0, t1 = 0;
+                    glGetQueryObjectui64v(gpuQueries[gpuSlot][i * 2], GL_QUERY_RESULT, &t0);
+                    glGetQueryObjectui64v(gpuQueries[gpuSlot][i * 2 + 1], GL_QUERY_RESULT, &t1);
+                    gpuEvents[gpuHead++ & (GPU_EVENTS - 1)] = { f.names[i], toCpuTime(t0), toCpuTime(t1) };
+                }
+            } else {
+                gpuDropped++;
+            }
+        }
+        f.count = 0;
+        // O relógio da GPU deriva em relação ao da CPU; recalibra de tempos em tempos
+        if (gpuFrame % 600 == 0)
+            calibrateGpu();
+    }
+
+    static int beginGpu(const char* name)
+    {
+        GpuFrame& f = gpuFrames[gpuSlot];
+        if (!gpuReady || !isEnabled() || f.count == GPU_SCOPES_PER_FRAME)
+            return -1;
+        int i = f.count++;
+        f.names[i] = name;
+        glQueryCounter(gpuQueries[gpuSlot][i * 2], GL_TIMESTAMP);
+        return i;
+    }
+
+    static void endGpu(int i)
+    {
+        if (i >= 0)
+            glQueryCounter(gpuQueries[gpuSlot][i * 2 + 1], GL_TIMESTAMP);
+    }
+
+    static uint64_t gpuFramesDropped() { return gpuDropped; }
+
+    // ==== EXPORTAÇÃO ====
+    // Grava os eventos ainda presentes nos buffers (os mais recentes de cada trilha)
+    static bool writeChromeTrace(const std::string& path)
+    {
+        FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) {
+            std::cerr << "[profiler] erro ao gravar " << path << std::endl;
+            return false;
+        }
+        size_t count = 0;
+        bool first = true;
+        auto sep = [&]() { std::fputs(first ? "\n" : ",\n", f); first = false; };
+        auto event = [&](const ProfileEvent& e, int tid) {
+            sep();
+            std::fputs("{\"name\":\"", f);
+            writeEscaped(f, e.name);
+            std::fprintf(f, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", tid, e.start / 1000.0,
+                         (e.end - e.start) / 1000.0);
+            count++;
+        };
+        auto threadName = [&](int tid, const std::string& name) {
+            sep();
+            std::fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"", tid);
+            writeEscaped(f, name.c_str());
+            std::fputs("\"}}", f);
+        };
+
+        std::fputs("{\"traceEvents\":[", f);
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            std::vector<ProfileEvent> copy;
+            for (const std::unique_ptr<ThreadBuffer>& b : buffers) {
+                threadName(b->tid, b->name.empty() ? "worker " + std::to_string(b->tid) : b->name);
+                // Só até o índice publicado; o que a thread gravar depois fica de fora
+                uint64_t h = b->head.load(std::memory_order_acquire);
+                uint64_t begin = h > EVENTS_PER_THREAD ? h - EVENTS_PER_THREAD : 0;
+                copy.clear();
+                for (uint64_t i = begin; i < h; i++)
+                    copy.push_back(b->events[i & (EVENTS_PER_THREAD - 1)]);
+                // A gravação do índice 'after' (ainda não publicado) reusa a posição de after - N
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint64_t after = b->head.load(std::memory_order_relaxed);
+                uint64_t valid = after >= EVENTS_PER_THREAD ? after - EVENTS_PER_THREAD + 1 : 0;
+                for (uint64_t i = std::max(begin, valid); i < h; i++)
+                    event(copy[(size_t)(i - begin)], b->tid);
+            }
+        }
+        if (gpuReady) {
+            threadName(GPU_TID, "GPU");
+            uint64_t begin = gpuHead > GPU_EVENTS ? gpuHead - GPU_EVENTS : 0;
+            for (uint64_t i = begin; i < gpuHead; i++)
+                event(gpuEvents[i & (GPU_EVENTS - 1)], GPU_TID);
+        }
+        std::fputs("\n],\"displayTimeUnit\":\"ms\"}\n", f);
+        std::fclose(f);
+        std::cout << "[profiler] " << count << " eventos em " << path << " (" << gpuDropped
+                  << " frames de GPU descartados por não estarem prontos)" << std::endl;
+        return true;
+    }
+
+private:
+    struct ThreadBuffer {
+        int tid = 0;
+        std::string name;
+        std::atomic<uint64_t> head{ 0 };
+        std::atomic<bool> inUse{ false };
+        std::vector<ProfileEvent> events;
+    };
+
+    // Devolve o buffer ao registro quando a thread termina
+    struct LocalHandle {
+        ThreadBuffer* buffer = nullptr;
+        ~LocalHandle()
+        {
+            if (buffer)
+                buffer->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    struct GpuFrame {
+        int count; // zerado por ser estático
+        const char* names[GPU_SCOPES_PER_FRAME];
+    };
+
+    static constexpr int GPU_TID = 1000;
+
+    static inline const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    static inline std::atomic<bool> enabled{ true };
+    static inline std::mutex registryMutex;
+    static inline std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    static inline bool gpuReady = false;
+    static inline GLuint gpuQueries[GPU_FRAMES][GPU_SCOPES_PER_FRAME * 2];
+    static inline GpuFrame gpuFrames[GPU_FRAMES];
+    static inline int gpuSlot = 0;
+    static inline uint64_t gpuFrame = 0, gpuHead = 0, gpuDropped = 0;
+    static inline int64_t gpuOffset = 0; // relógio da CPU - relógio da GPU
+    static inline std::vector<ProfileEvent> gpuEvents;
+
+    static ThreadBuffer* localBuffer()
+    {
+        thread_local LocalHandle handle;
+        if (!handle.buffer)
+            handle.buffer = acquireBuffer();
+        return handle.buffer;
+    }
+
+    // Só na primeira gravação de cada thread
+    static ThreadBuffer* acquireBuffer()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (std::unique_ptr<ThreadBuffer>& b : buffers) {
+            bool expected = false;
+            if (b->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return b.get();
+        }
+        buffers.emplace_back(new ThreadBuffer());
+        ThreadBuffer* b = buffers.back().get();
+        b->tid = (int)buffers.size();
+        b->events.resize(EVENTS_PER_THREAD);
+        b->inUse.store(true, std::memory_order_relaxed);
+        return b;
+    }
+
+    static void calibrateGpu()
+    {
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        gpuOffset = (int64_t)now() - (int64_t)gpuNow;
+    }
+
+    static uint64_t toCpuTime(GLuint64 gpuTime)
+    {
+        int64_t t = (int64_t)gpuTime + gpuOffset;
+        return t > 0 ? (uint64_t)t : 0;
+    }
+
+    static void writeEscaped(FILE* f, const char* s)
+    {
+        for (; *s; s++) {
+            if (*s == '"' || *s == '\\')
+                std::fputc('\\', f);
+            std::fputc(*s, f);
+        }
+    }
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name(name), start(Profiler::isEnabled() ? Profiler::now() : 0) {}
+    ~ProfileScope()
+    {
+        if (start && Profiler::isEnabled())
+            Profiler::record(name, start, Profiler::now());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name) : index(Profiler::beginGpu(name)) {}
+    ~GpuProfileScope() { Profiler::endGpu(index); }
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    int index;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define GPU_PROFILE_SCOPE(name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope_, __LINE__)(name)
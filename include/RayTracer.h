@@ -0,0 +1,762 @@
+#pragma once
+
+// ============== RAY TRACER EM CPU (BVH SAH + PACOTES SIMD) ==============
+// Renderização offline das mesmas malhas/materiais das cenas em GL, sem GPU,
+// para imagens de referência e stills com supersampling.
+//
+//   addMesh()  leva os triângulos para o espaço do mundo (posição pelo model,
+//              normal pela transposta da inversa, como no vertex shader);
+//   build()    BVH binária por SAH com 16 bins por eixo. Os níveis de cima são
+//              divididos em série até haver tarefas para todas as threads; cada
+//              subárvore é construída em paralelo num vetor próprio e depois
+//              emendada na ordem das tarefas (a árvore não depende do número de
+//              threads);
+//   render()   tiles de 16x16 distribuídos por um contador atômico; cada tile é
+//              percorrido em pacotes de 4x2 raios. Caixas e triângulos são
+//              testados contra os 8 raios do pacote de uma vez (AVX, 2x SSE ou
+//              escalar). Para cada acerto sai um raio de sombra até a luz
+//              (também em pacote, parando no primeiro acerto), e o pixel é
+//              sombreado com shadeFragment (mesmo modelo do fragment shader).
+//
+// O framebuffer segue a convenção do GL: linha 0 embaixo, RGBA8. Com 1
+// amostra por pixel o raio passa pelo centro do pixel; com N² amostras, por
+// uma grade regular N x N (a imagem não depende do número de threads).
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include <SoftShading.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RAYTRACER_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RAYTRACER_SSE 1
+#endif
+
+// ==== 8 LANES (um raio do pacote por lane) ====
+// Comparações devolvem máscaras no mesmo tipo (lane com todos os bits em 1)
+#if defined(RAYTRACER_AVX)
+struct RtFloat8 {
+    __m256 v;
+    static RtFloat8 set1(float x) { return { _mm256_set1_ps(x) }; }
+    static RtFloat8 load(const float* p) { return { _mm256_loadu_ps(p) }; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+inline RtFloat8 operator+(RtFloat8 a, RtFloat8 b) { return { _mm256_add_ps(a.v, b.v) }; }
+inline RtFloat8 operator-(RtFloat8 a, RtFloat8 b) { return { _mm256_sub_ps(a.v, b.v) }; }
+inline RtFloat8 operator*(RtFloat8 a, RtFloat8 b) { return { _mm256_mul_ps(a.v, b.v) }; }
+inline RtFloat8 operator/(RtFloat8 a, RtFloat8 b) { return { _mm256_div_ps(a.v, b.v) }; }
+inline RtFloat8 operator&(RtFloat8 a, RtFloat8 b) { return { _mm256_and_ps(a.v, b.v) }; }
+inline RtFloat8 operator<(RtFloat8 a, RtFloat8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+inline RtFloat8 operator<=(RtFloat8 a, RtFloat8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+inline RtFloat8 rtMin(RtFloat8 a, RtFloat8 b) { return { _mm256_min_ps(a.v, b.v) }; }
+inline RtFloat8 rtMax(RtFloat8 a, RtFloat8 b) { return { _mm256_max_ps(a.v, b.v) }; }
+inline RtFloat8 rtAbs(RtFloat8 a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+inline RtFloat8 rtSelect(RtFloat8 m, RtFloat8 a, RtFloat8 b) { return { _mm256_blendv_ps(b.v, a.v, m.v) }; }
+inline int rtMask(RtFloat8 m) { return _mm256_movemask_ps(m.v); }
+// Inverso de rtMask: bit i -> lane i com todos os bits em 1
+inline RtFloat8 rtFromMask(int m)
+{
+    __m128i v = _mm_set1_epi32(m), lo = _mm_setr_epi32(1, 2, 4, 8), hi = _mm_setr_epi32(16, 32, 64, 128);
+    __m128 a = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(v, lo), lo));
+    __m128 b = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(v, hi), hi));
+    return { _mm256_insertf128_ps(_mm256_castps128_ps256(a), b, 1) };
+}
+#elif defined(RAYTRACER_SSE)
+struct RtFloat8 {
+    __m128 lo, hi;
+    static RtFloat8 set1(float x) { return { _mm_set1_ps(x), _mm_set1_ps(x) }; }
+    static RtFloat8 load(const float* p) { return { _mm_loadu_ps(p), _mm_loadu_ps(p + 4) }; }
+    void store(float* p) const { _mm_storeu_ps(p, lo); _mm_storeu_ps(p + 4, hi); }
+};
+#define RT_SSE_BINARY(name, intrinsic) \
+    inline RtFloat8 name(RtFloat8 a, RtFloat8 b) { return { intrinsic(a.lo, b.lo), intrinsic(a.hi, b.hi) }; }
+RT_SSE_BINARY(operator+, _mm_add_ps)
+RT_SSE_BINARY(operator-, _mm_sub_ps)
+RT_SSE_BINARY(operator*, _mm_mul_ps)
+RT_SSE_BINARY(operator/, _mm_div_ps)
+RT_SSE_BINARY(operator&, _mm_and_ps)
+RT_SSE_BINARY(operator<, _mm_cmplt_ps)
+RT_SSE_BINARY(operator<=, _mm_cmple_ps)
+RT_SSE_BINARY(rtMin, _mm_min_ps)
+RT_SSE_BINARY(rtMax, _mm_max_ps)
+#undef RT_SSE_BINARY
+inline RtFloat8 rtAbs(RtFloat8 a)
+{
+    __m128 sign = _mm_set1_ps(-0.0f);
+    return { _mm_andnot_ps(sign, a.lo), _mm_andnot_ps(sign, a.hi) };
+}
+inline RtFloat8 rtSelect(RtFloat8 m, RtFloat8 a, RtFloat8 b)
+{
+    return { _mm_or_ps(_mm_and_ps(m.lo, a.lo), _mm_andnot_ps(m.lo, b.lo)),
+             _mm_or_ps(_mm_and_ps(m.hi, a.hi), _mm_andnot_ps(m.hi, b.hi)) };
+}
+inline int rtMask(RtFloat8 m) { return _mm_movemask_ps(m.lo) | (_mm_movemask_ps(m.hi) << 4); }
+inline RtFloat8 rtFromMask(int m)
+{
+    __m128i v = _mm_set1_epi32(m), lo = _mm_setr_epi32(1, 2, 4, 8), hi = _mm_setr_epi32(16, 32, 64, 128);
+    return { _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(v, lo), lo)),
+             _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(v, hi), hi)) };
+}
+#else
+struct RtFloat8 {
+    float v[8];
+    static RtFloat8 set1(float x)
+    {
+        RtFloat8 r;
+        std::fill(r.v, r.v + 8, x);
+        return r;
+    }
+    static RtFloat8 load(const float* p)
+    {
+        RtFloat8 r;
+        std::copy(p, p + 8, r.v);
+        return r;
+    }
+    void store(float* p) const { std::copy(v, v + 8, p); }
+};
+template <typename F>
+inline RtFloat8 rtLanes(RtFloat8 a, RtFloat8 b, F f)
+{
+    RtFloat8 r;
+    for (int i = 0; i < 8; i++)
+        r.v[i] = f(a.v[i], b.v[i]);
+    return r;
+}
+inline float rtBool(bool b)
+{
+    uint32_t bits = b ? 0xffffffffu : 0u;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+inline bool rtIsSet(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(f));
+    return bits != 0;
+}
+inline RtFloat8 operator+(RtFloat8 a, RtFloat8 b) { return rtLanes(a, b, [](float x, float y) { return x + y; }); }
+inline RtFloat8 operator-(RtFloat8 a, RtFloat8 b) { return rtLanes(a, b, [](float x, float y) { return x - y; }); }
+inline RtFloat8 operator*(RtFloat8 a, RtFloat8 b) { return rtLanes(a, b, [](float x, float y) { return x * y; }); }
+inline RtFloat8 operator/(RtFloat8 a, RtFloat8 b) { return rtLanes(a, b, [](float x, float y) { return x / y; }); }
+inline RtFloat8 operator&(RtFloat8 a, RtFloat8 b) { return rtLanes(a, b, [](float x, float y) { return rtBool(rtIsSet(x) && rtIsSet(y)); }); }
+inline RtFloat8 operator<(RtFloat8 a, RtFloat8 b) { return rtLanes(a, b, [](float x, float y) { return rtBool(x < y); }); }
+inline RtFloat8 operator<=(RtFloat8 a, RtFloat8 b) { return rtLanes(a, b, [](float x, float y) { return rtBool(x <= y); }); }
+inline RtFloat8 rtMin(RtFloat8 a, RtFloat8 b) { return rtLanes(a, b, [](float x, float y) { return y < x ? y : x; }); }
+inline RtFloat8 rtMax(RtFloat8 a, RtFloat8 b) { return rtLanes(a, b, [](float x, float y) { return y > x ? y : x; }); }
+inline RtFloat8 rtAbs(RtFloat8 a) { return rtLanes(a, a, [](float x, float) { return std::fabs(x); }); }
+inline RtFloat8 rtSelect(RtFloat8 m, RtFloat8 a, RtFloat8 b)
+{
+    RtFloat8 r;
+    for (int i = 0; i < 8; i++)
+        r.v[i] = rtIsSet(m.v[i]) ? a.v[i] : b.v[i];
+    return r;
+}
+inline int rtMask(RtFloat8 m)
+{
+    int mask = 0;
+    for (int i = 0; i < 8; i++)
+        mask |= rtIsSet(m.v[i]) << i;
+    return mask;
+}
+inline RtFloat8 rtFromMask(int m)
+{
+    RtFloat8 r;
+    for (int i = 0; i < 8; i++)
+        r.v[i] = rtBool((m >> i) & 1);
+    return r;
+}
+#endif
+
+struct RayTracerStats {
+    int triangles = 0;
+    int nodes = 0, leaves = 0, maxDepth = 0, buildTasks = 0;
+    double buildMs = 0.0;
+    uint64_t primaryRays = 0, shadowRays = 0;
+    double renderMs = 0.0;
+};
+
+class RayTracer {
+public:
+    static constexpr int TILE = 16;      // múltiplo de 4 x 2 (pacote)
+    static constexpr int MAX_LEAF = 8;   // triângulos por folha quando o SAH não compensa dividir
+    static constexpr int MAX_DEPTH = 60; // cabe na pilha da travessia
+
+    void clear()
+    {
+        tris.clear();
+        shading.clear();
+        materials.clear();
+        nodes.clear();
+    }
+
+    void addMesh(const std::vector<Vertex>& vertices, const glm::mat4& model, const SoftMaterial& material)
+    {
+        uint32_t matIndex = (uint32_t)materials.size();
+        materials.push_back(material);
+        glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
+        for (size_t i = 0; i + 2 < vertices.size(); i += 3) {
+            glm::vec3 p[3];
+            ShadingTri s;
+            for (int k = 0; k < 3; k++) {
+                p[k] = glm::vec3(model * glm::vec4(vertices[i + k].position, 1.0f));
+                s.normal[k] = normalMatrix * vertices[i + k].normal;
+                s.uv[k] = vertices[i + k].texCoord;
+            }
+            s.material = matIndex;
+            tris.push_back({ p[0], p[1] - p[0], p[2] - p[0] });
+            shading.push_back(s);
+        }
+    }
+
+    // SAH BVH sobre os triângulos adicionados; threads <= 0 = hardware_concurrency
+    void build(int threads = 0)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        threads = threads > 0 ? threads : std::max(1, (int)std::thread::hardware_concurrency());
+        uint32_t n = (uint32_t)tris.size();
+        counters = RayTracerStats();
+        counters.triangles = (int)n;
+        nodes.clear();
+        if (n == 0)
+            return;
+
+        order.resize(n);
+        centroids.resize(n);
+        triMin.resize(n);
+        triMax.resize(n);
+        parallelFor(threads, n, [&](uint32_t i) {
+            const Tri& t = tris[i];
+            glm::vec3 a = t.v0, b = t.v0 + t.e1, c = t.v0 + t.e2;
+            triMin[i] = glm::min(a, glm::min(b, c));
+            triMax[i] = glm::max(a, glm::max(b, c));
+            centroids[i] = (a + b + c) * (1.0f / 3.0f);
+            order[i] = i;
+        });
+
+        // Níveis de cima em série, até haver tarefas suficientes
+        struct Task {
+            uint32_t node, first, count, depth;
+        };
+        std::vector<Task> pending = { { 0, 0, n, 0 } }, tasks;
+        nodes.push_back(Node());
+        const uint32_t GRAIN = 1024;
+        while (!pending.empty()) {
+            Task t = pending.front();
+            pending.erase(pending.begin());
+            if (t.count <= GRAIN || tasks.size() + pending.size() + 1 >= (size_t)threads * 4) {
+                tasks.push_back(t);
+                continue;
+            }
+            uint32_t mid;
+            if (!split(nodes[t.node], t.first, t.count, t.depth, mid)) {
+                counters.leaves++;
+                counters.maxDepth = std::max(counters.maxDepth, (int)t.depth);
+                continue;
+            }
+            uint32_t left = (uint32_t)nodes.size();
+            nodes[t.node].first = left;
+            nodes.push_back(Node());
+            nodes.push_back(Node());
+            pending.push_back({ left, t.first, mid - t.first, t.depth + 1 });
+            pending.push_back({ left + 1, mid, t.first + t.count - mid, t.depth + 1 });
+        }
+
+        // Subárvores em paralelo, cada uma no seu vetor (índice 0 = raiz da tarefa)
+        std::vector<std::vector<Node>> subtrees(tasks.size());
+        std::vector<RayTracerStats> subStats(tasks.size());
+        parallelFor(threads, (uint32_t)tasks.size(), [&](uint32_t i) {
+            subtrees[i].push_back(Node());
+            subdivide(subtrees[i], 0, tasks[i].first, tasks[i].count, tasks[i].depth, subStats[i]);
+        });
+        for (size_t i = 0; i < tasks.size(); i++) {
+            std::vector<Node>& sub = subtrees[i];
+            uint32_t base = (uint32_t)nodes.size() - 1; // local k (k >= 1) -> base + k
+            for (Node& node : sub) {
+                if (node.count == 0)
+                    node.first += base;
+            }
+            nodes[tasks[i].node] = sub[0];
+            nodes.insert(nodes.end(), sub.begin() + 1, sub.end());
+            counters.leaves += subStats[i].leaves;
+            counters.maxDepth = std::max(counters.maxDepth, subStats[i].maxDepth);
+        }
+        counters.buildTasks = (int)tasks.size();
+        counters.nodes = (int)nodes.size();
+
+        // Triângulos na ordem das folhas
+        std::vector<Tri> sortedTris(n);
+        std::vector<ShadingTri> sortedShading(n);
+        for (uint32_t i = 0; i < n; i++) {
+            sortedTris[i] = tris[order[i]];
+            sortedShading[i] = shading[order[i]];
+        }
+        tris.swap(sortedTris);
+        shading.swap(sortedShading);
+        counters.buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    void setCamera(const glm::mat4& view, const glm::mat4& proj, const glm::vec3& viewPos)
+    {
+        invViewProj = glm::inverse(proj * view);
+        cameraPos = viewPos;
+    }
+
+    void setLight(const SoftLight& l) { light = l; }
+    void setBackground(const glm::vec3& color, const SoftTexture* texture = nullptr)
+    {
+        clearColor = color;
+        background = texture;
+    }
+    void setShadows(bool enabled) { shadows = enabled; }
+    void setSamplesPerAxis(int n) { samplesPerAxis = std::max(1, n); }
+
+    // Renderiza w x h em 'pixels' (RGBA8, linha 0 embaixo)
+    void render(int w, int h, int threads, std::vector<uint32_t>& pixels)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        threads = threads > 0 ? threads : std::max(1, (int)std::thread::hardware_concurrency());
+        width = w;
+        height = h;
+        pixels.assign((size_t)w * h, 0);
+        int tilesX = (w + TILE - 1) / TILE, tilesY = (h + TILE - 1) / TILE;
+        std::atomic<uint64_t> primary(0), shadow(0);
+        parallelFor(threads, (uint32_t)(tilesX * tilesY), [&](uint32_t t) {
+            uint64_t rays[2] = { 0, 0 };
+            renderTile((int)t % tilesX * TILE, (int)t / tilesX * TILE, pixels, rays);
+            primary += rays[0];
+            shadow += rays[1];
+        });
+        counters.primaryRays = primary;
+        counters.shadowRays = shadow;
+        counters.renderMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    const RayTracerStats& stats() const { return counters; }
+
+private:
+    struct Tri {
+        glm::vec3 v0, e1, e2;
+    };
+
+    struct ShadingTri {
+        glm::vec3 normal[3];
+        glm::vec2 uv[3];
+        uint32_t material;
+    };
+
+    // count > 0: folha com os triângulos [first, first + count)
+    // count = 0: nó interno com filhos first e first + 1
+    struct Node {
+        glm::vec3 bmin = glm::vec3(0.0f);
+        uint32_t first = 0;
+        glm::vec3 bmax = glm::vec3(0.0f);
+        uint16_t count = 0;
+        uint16_t axis = 0;
+    };
+
+    struct Packet {
+        RtFloat8 ox, oy, oz, dx, dy, dz, ix, iy, iz; // origem, direção, 1/direção
+        RtFloat8 tmin, tmax;
+        int active;          // lanes com raio
+        uint32_t hit[8];     // triângulo mais próximo (anyHit: lanes bloqueadas em 'active')
+    };
+
+    std::vector<Tri> tris;
+    std::vector<ShadingTri> shading;
+    std::vector<SoftMaterial> materials;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> order;
+    std::vector<glm::vec3> centroids, triMin, triMax;
+
+    glm::mat4 invViewProj = glm::mat4(1.0f);
+    glm::vec3 cameraPos = glm::vec3(0.0f);
+    SoftLight light;
+    glm::vec3 clearColor = glm::vec3(0.0f);
+    const SoftTexture* background = nullptr;
+    bool shadows = true;
+    int samplesPerAxis = 1;
+    int width = 0, height = 0;
+    RayTracerStats counters;
+
+    static constexpr uint32_t NO_HIT = 0xffffffffu;
+
+    static int lanes(int mask)
+    {
+        int n = 0;
+        for (; mask; mask &= mask - 1)
+            n++;
+        return n;
+    }
+
+    template <typename F>
+    static void parallelFor(int threads, uint32_t count, F&& body)
+    {
+        std::atomic<uint32_t> next(0);
+        auto worker = [&]() {
+            for (uint32_t i = next++; i < count; i = next++)
+                body(i);
+        };
+        int extra = std::min<int>(threads, (int)count) - 1;
+        std::vector<std::thread> pool;
+        for (int i = 0; i < extra; i++)
+            pool.emplace_back(worker);
+        worker();
+        for (std::thread& t : pool)
+            t.join();
+    }
+
+    // ==== CONSTRUÇÃO ====
+    static float area(const glm::vec3& bmin, const glm::vec3& bmax)
+    {
+        glm::vec3 d = bmax - bmin;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    // Calcula a caixa do nó e, se compensar, particiona 'order' em [first, mid) e [mid, first + count)
+    bool split(Node& node, uint32_t first, uint32_t count, uint32_t depth, uint32_t& mid)
+    {
+        glm::vec3 bmin(INFINITY), bmax(-INFINITY), cmin(INFINITY), cmax(-INFINITY);
+        for (uint32_t i = first; i < first + count; i++) {
+            uint32_t t = order[i];
+            bmin = glm::min(bmin, triMin[t]);
+            bmax = glm::max(bmax, triMax[t]);
+            cmin = glm::min(cmin, centroids[t]);
+            cmax = glm::max(cmax, centroids[t]);
+        }
+        node.bmin = bmin;
+        node.bmax = bmax;
+        node.first = first;
+        node.count = (uint16_t)count;
+        if (count <= 2 || depth >= MAX_DEPTH)
+            return false;
+
+        const int BINS = 16;
+        float bestCost = INFINITY;
+        int bestAxis = -1, bestBin = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            float extent = cmax[axis] - cmin[axis];
+            if (extent <= 1e-9f)
+                continue;
+            float scale = BINS / extent;
+            int binCount[BINS] = {};
+            glm::vec3 binMin[BINS], binMax[BINS];
+            std::fill(binMin, binMin + BINS, glm::vec3(INFINITY));
+            std::fill(binMax, binMax + BINS, glm::vec3(-INFINITY));
+            for (uint32_t i = first; i < first + count; i++) {
+                uint32_t t = order[i];
+                int b = std::min(BINS - 1, (int)((centroids[t][axis] - cmin[axis]) * scale));
+                binCount[b]++;
+                binMin[b] = glm::min(binMin[b], triMin[t]);
+                binMax[b] = glm::max(binMax[b], triMax[t]);
+            }
+            // Custo da divisão depois do bin i: N_esq * A_esq + N_dir * A_dir
+            float leftArea[BINS - 1];
+            int leftCount[BINS - 1];
+            glm::vec3 lmin(INFINITY), lmax(-INFINITY);
+            int lcount = 0;
+            for (int i = 0; i < BINS - 1; i++) {
+                lcount += binCount[i];
+                lmin = glm::min(lmin, binMin[i]);
+                lmax = glm::max(lmax, binMax[i]);
+                leftCount[i] = lcount;
+                leftArea[i] = lcount ? area(lmin, lmax) : 0.0f;
+            }
+            glm::vec3 rmin(INFINITY), rmax(-INFINITY);
+            int rcount = 0;
+            for (int i = BINS - 1; i > 0; i--) {
+                rcount += binCount[i];
+                rmin = glm::min(rmin, binMin[i]);
+                rmax = glm::max(rmax, binMax[i]);
+                if (!rcount || !leftCount[i - 1])
+                    continue;
+                float cost = leftCount[i - 1] * leftArea[i - 1] + rcount * area(rmin, rmax);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = i - 1;
+                }
+            }
+        }
+        // Folha se nenhuma divisão for melhor que testar todos os triângulos (custo de travessia ~ 1 triângulo)
+        float leafCost = count * area(bmin, bmax);
+        if (bestAxis < 0 || (bestCost + area(bmin, bmax) >= leafCost && count <= MAX_LEAF))
+            return false;
+
+        float scale = BINS / (cmax[bestAxis] - cmin[bestAxis]);
+        uint32_t* begin = order.data() + first;
+        uint32_t* middle = std::partition(begin, begin + count, [&](uint32_t t) {
+            return std::min(BINS - 1, (int)((centroids[t][bestAxis] - cmin[bestAxis]) * scale)) <= bestBin;
+        });
+        mid = first + (uint32_t)(middle - begin);
+        node.count = 0;
+        node.axis = (uint16_t)bestAxis;
+        return mid != first && mid != first + count;
+    }
+
+    void subdivide(std::vector<Node>& out, uint32_t index, uint32_t first, uint32_t count, uint32_t depth,
+                   RayTracerStats& st)
+    {
+        uint32_t mid;
+        Node node;
+        if (!split(node, first, count, depth, mid)) {
+            node.first = first;
+            node.count = (uint16_t)count;
+            out[index] = node;
+            st.leaves++;
+            st.maxDepth = std::max(st.maxDepth, (int)depth);
+            return;
+        }
+        uint32_t left = (uint32_t)out.size();
+        node.first = left;
+        out[index] = node;
+        out.push_back(Node());
+        out.push_back(Node());
+        subdivide(out, left, first, mid - first, depth + 1, st);
+        subdivide(out, left + 1, mid, first + count - mid, depth + 1, st);
+    }
+
+    // ==== TRAVESSIA ====
+    // anyHit: raios de sombra, para no primeiro acerto e tira a lane de 'active'
+    void intersect(Packet& p, bool anyHit) const
+    {
+        uint32_t stack[MAX_DEPTH * 2 + 4];
+        int sp = 0;
+        stack[sp++] = 0;
+        int alive = p.active;
+        int blocked = 0;
+        while (sp) {
+            const Node& node = nodes[stack[--sp]];
+            RtFloat8 t1 = (RtFloat8::set1(node.bmin.x) - p.ox) * p.ix, t2 = (RtFloat8::set1(node.bmax.x) - p.ox) * p.ix;
+            RtFloat8 tnear = rtMax(p.tmin, rtMin(t1, t2)), tfar = rtMin(p.tmax, rtMax(t1, t2));
+            t1 = (RtFloat8::set1(node.bmin.y) - p.oy) * p.iy;
+            t2 = (RtFloat8::set1(node.bmax.y) - p.oy) * p.iy;
+            tnear = rtMax(tnear, rtMin(t1, t2));
+            tfar = rtMin(tfar, rtMax(t1, t2));
+            t1 = (RtFloat8::set1(node.bmin.z) - p.oz) * p.iz;
+            t2 = (RtFloat8::set1(node.bmax.z) - p.oz) * p.iz;
+            tnear = rtMax(tnear, rtMin(t1, t2));
+            tfar = rtMin(tfar, rtMax(t1, t2));
+            int mask = rtMask(tnear <= tfar) & alive;
+            if (!mask)
+                continue;
+
+            if (node.count) {
+                for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                    int hits = intersectTriangle(p, i, mask);
+                    if (anyHit && hits) {
+                        blocked |= hits;
+                        alive &= ~hits;
+                        mask &= ~hits;
+                        if (!alive) {
+                            p.active &= ~blocked;
+                            return;
+                        }
+                    }
+                }
+                continue;
+            }
+            // Filho mais próximo primeiro, pelo sinal da direção de uma lane viva
+            float d[8];
+            (node.axis == 0 ? p.dx : node.axis == 1 ? p.dy : p.dz).store(d);
+            int lane = 0;
+            while (!(mask & (1 << lane)))
+                lane++;
+            bool negative = d[lane] < 0.0f;
+            stack[sp++] = node.first + (negative ? 0 : 1);
+            stack[sp++] = node.first + (negative ? 1 : 0);
+        }
+        if (anyHit)
+            p.active &= ~blocked;
+    }
+
+    // Möller-Trumbore do triângulo i contra as lanes de 'mask'; devolve as lanes que acertaram
+    int intersectTriangle(Packet& p, uint32_t i, int mask) const
+    {
+        const Tri& t = tris[i];
+        RtFloat8 e1x = RtFloat8::set1(t.e1.x), e1y = RtFloat8::set1(t.e1.y), e1z = RtFloat8::set1(t.e1.z);
+        RtFloat8 e2x = RtFloat8::set1(t.e2.x), e2y = RtFloat8::set1(t.e2.y), e2z = RtFloat8::set1(t.e2.z);
+        RtFloat8 px = p.dy * e2z - p.dz * e2y, py = p.dz * e2x - p.dx * e2z, pz = p.dx * e2y - p.dy * e2x;
+        RtFloat8 det = e1x * px + e1y * py + e1z * pz;
+        RtFloat8 inv = RtFloat8::set1(1.0f) / det;
+        RtFloat8 tx = p.ox - RtFloat8::set1(t.v0.x), ty = p.oy - RtFloat8::set1(t.v0.y), tz = p.oz - RtFloat8::set1(t.v0.z);
+        RtFloat8 u = (tx * px + ty * py + tz * pz) * inv;
+        RtFloat8 qx = ty * e1z - tz * e1y, qy = tz * e1x - tx * e1z, qz = tx * e1y - ty * e1x;
+        RtFloat8 v = (p.dx * qx + p.dy * qy + p.dz * qz) * inv;
+        RtFloat8 dist = (e2x * qx + e2y * qy + e2z * qz) * inv;
+        RtFloat8 zero = RtFloat8::set1(0.0f);
+        RtFloat8 ok = (RtFloat8::set1(1e-12f) < rtAbs(det)) & (zero <= u) & (zero <= v) & (u + v <= RtFloat8::set1(1.0f)) &
+                      (p.tmin < dist) & (dist < p.tmax);
+        int hits = rtMask(ok) & mask;
+        if (hits) {
+            // Só as lanes de 'mask' encurtam o raio: as outras não registram o acerto
+            p.tmax = rtSelect(rtFromMask(hits), dist, p.tmax);
+            for (int lane = 0; lane < 8; lane++) {
+                if (hits & (1 << lane))
+                    p.hit[lane] = i;
+            }
+        }
+        return hits;
+    }
+
+    // Coordenadas baricêntricas (u, v) de um raio no triângulo i
+    glm::vec2 barycentric(uint32_t i, const glm::vec3& o, const glm::vec3& d) const
+    {
+        const Tri& t = tris[i];
+        glm::vec3 pvec = glm::cross(d, t.e2);
+        float inv = 1.0f / glm::dot(t.e1, pvec);
+        glm::vec3 tvec = o - t.v0;
+        glm::vec3 qvec = glm::cross(tvec, t.e1);
+        return glm::vec2(glm::dot(tvec, pvec) * inv, glm::dot(d, qvec) * inv);
+    }
+
+    static void setLanes(RtFloat8& x, RtFloat8& y, RtFloat8& z, const glm::vec3 v[8])
+    {
+        float a[8], b[8], c[8];
+        for (int i = 0; i < 8; i++) {
+            a[i] = v[i].x;
+            b[i] = v[i].y;
+            c[i] = v[i].z;
+        }
+        x = RtFloat8::load(a);
+        y = RtFloat8::load(b);
+        z = RtFloat8::load(c);
+    }
+
+    // Direções nulas viram quase nulas, para 1/d não gerar NaN no teste de caixa
+    static void setInverse(Packet& p, const glm::vec3 d[8])
+    {
+        glm::vec3 inv[8];
+        for (int i = 0; i < 8; i++) {
+            for (int k = 0; k < 3; k++) {
+                float c = d[i][k];
+                inv[i][k] = 1.0f / (std::fabs(c) > 1e-20f ? c : (c < 0.0f ? -1e-20f : 1e-20f));
+            }
+        }
+        setLanes(p.ix, p.iy, p.iz, inv);
+    }
+
+    // ==== RENDERIZAÇÃO ====
+    void renderTile(int x0, int y0, std::vector<uint32_t>& pixels, uint64_t rays[2]) const
+    {
+        int n = samplesPerAxis;
+        float weight = 1.0f / (n * n);
+        for (int by = y0; by < std::min(height, y0 + TILE); by += 2) {
+            for (int bx = x0; bx < std::min(width, x0 + TILE); bx += 4) {
+                glm::vec3 sum[8];
+                int valid = 0;
+                for (int lane = 0; lane < 8; lane++) {
+                    sum[lane] = glm::vec3(0.0f);
+                    if (bx + lane % 4 < width && by + lane / 4 < height)
+                        valid |= 1 << lane;
+                }
+                for (int s = 0; s < n * n; s++) {
+                    float sx = (s % n + 0.5f) / n, sy = (s / n + 0.5f) / n;
+                    glm::vec3 c[8];
+                    tracePacket(bx, by, sx, sy, valid, c, rays);
+                    for (int lane = 0; lane < 8; lane++)
+                        sum[lane] += c[lane];
+                }
+                for (int lane = 0; lane < 8; lane++) {
+                    if (valid & (1 << lane))
+                        pixels[(size_t)(by + lane / 4) * width + bx + lane % 4] = packColor(sum[lane] * weight);
+                }
+            }
+        }
+    }
+
+    // Pacote 4x2 de raios primários com deslocamento (sx, sy) dentro do pixel
+    void tracePacket(int bx, int by, float sx, float sy, int valid, glm::vec3 color[8], uint64_t rays[2]) const
+    {
+        glm::vec3 origin[8], dir[8];
+        glm::vec2 screen[8];
+        for (int lane = 0; lane < 8; lane++) {
+            screen[lane] = glm::vec2(bx + lane % 4 + sx, by + lane / 4 + sy);
+            glm::vec2 ndc = screen[lane] / glm::vec2((float)width, (float)height) * 2.0f - 1.0f;
+            glm::vec4 nearPoint = invViewProj * glm::vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+            glm::vec4 farPoint = invViewProj * glm::vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+            origin[lane] = glm::vec3(nearPoint) / nearPoint.w; // começa no plano near, como o recorte do GL
+            dir[lane] = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin[lane]);
+        }
+        Packet p;
+        setLanes(p.ox, p.oy, p.oz, origin);
+        setLanes(p.dx, p.dy, p.dz, dir);
+        setInverse(p, dir);
+        p.tmin = RtFloat8::set1(0.0f);
+        p.tmax = RtFloat8::set1(INFINITY);
+        p.active = valid;
+        std::fill(p.hit, p.hit + 8, NO_HIT);
+        intersect(p, false);
+        rays[0] += lanes(valid);
+
+        // Pontos atingidos e raios de sombra até a luz
+        glm::vec3 pos[8], normal[8], shadowOrigin[8], shadowDir[8];
+        glm::vec2 uv[8];
+        float intensity[8];
+        int needShadow = 0;
+        for (int lane = 0; lane < 8; lane++) {
+            intensity[lane] = 0.0f;
+            shadowOrigin[lane] = glm::vec3(0.0f);
+            shadowDir[lane] = glm::vec3(0.0f, 1.0f, 0.0f);
+            if (!(valid & (1 << lane)) || p.hit[lane] == NO_HIT)
+                continue;
+            uint32_t i = p.hit[lane];
+            glm::vec2 b = barycentric(i, origin[lane], dir[lane]);
+            const Tri& t = tris[i];
+            const ShadingTri& s = shading[i];
+            float w0 = 1.0f - b.x - b.y;
+            pos[lane] = t.v0 + b.x * t.e1 + b.y * t.e2;
+            normal[lane] = s.normal[0] * w0 + s.normal[1] * b.x + s.normal[2] * b.y;
+            uv[lane] = s.uv[0] * w0 + s.uv[1] * b.x + s.uv[2] * b.y;
+            intensity[lane] = spotIntensity(light, pos[lane]);
+            if (shadows && intensity[lane] > 0.0f) {
+                // Sai um pouco acima da superfície, do lado da luz
+                glm::vec3 geometric = glm::normalize(glm::cross(t.e1, t.e2));
+                glm::vec3 toLight = light.position - pos[lane];
+                if (glm::dot(geometric, toLight) < 0.0f)
+                    geometric = -geometric;
+                shadowOrigin[lane] = pos[lane] + geometric * 1e-3f;
+                shadowDir[lane] = light.position - shadowOrigin[lane];
+                needShadow |= 1 << lane;
+            }
+        }
+        if (needShadow) {
+            Packet sp;
+            setLanes(sp.ox, sp.oy, sp.oz, shadowOrigin);
+            setLanes(sp.dx, sp.dy, sp.dz, shadowDir);
+            setInverse(sp, shadowDir);
+            sp.tmin = RtFloat8::set1(1e-4f);
+            sp.tmax = RtFloat8::set1(1.0f - 1e-4f); // direção não normalizada: t = 1 na luz
+            sp.active = needShadow;
+            std::fill(sp.hit, sp.hit + 8, NO_HIT);
+            intersect(sp, true);
+            rays[1] += lanes(needShadow);
+            for (int lane = 0; lane < 8; lane++) {
+                if ((needShadow & (1 << lane)) && !(sp.active & (1 << lane)))
+                    intensity[lane] = 0.0f;
+            }
+        }
+
+        for (int lane = 0; lane < 8; lane++) {
+            if (!(valid & (1 << lane))) {
+                color[lane] = glm::vec3(0.0f);
+            } else if (p.hit[lane] == NO_HIT) {
+                color[lane] = background ? background->sample(screen[lane].x / width, screen[lane].y / height) : clearColor;
+            } else {
+                const SoftMaterial& m = materials[shading[p.hit[lane]].material];
+                color[lane] = shadeFragment(m, light, pos[lane], normal[lane], uv[lane], cameraPos, intensity[lane]);
+            }
+        }
+    }
+};
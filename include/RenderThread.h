@@ -0,0 +1,153 @@
+#pragma once
+
+// ============== THREAD DE RENDER ==============
+// Fila de quadros entre a simulação (produtora, thread principal) e o render
+// (consumidora, dona do contexto GL):
+//   - N pacotes (3 por padrão) num anel; a simulação preenche um pacote
+//     inteiro e o publica, o render lê e devolve. Depois de publicado o
+//     pacote não muda mais: o render não lê nada que a simulação esteja
+//     alterando, e os vetores grandes entram no pacote por swap, sem cópia;
+//   - sem lock: dois contadores atômicos (escritos/lidos), cada um só
+//     incrementado por um lado (release/acquire publica o conteúdo);
+//   - contrapressão limitada: com N pacotes prontos a simulação espera
+//     (pause, yield, depois sleep curto), então fica no máximo N quadros à
+//     frente do que está na tela;
+//   - mede o tempo ocupado e esperando de cada lado; o relatório estima a
+//     sobreposição (quanto da simulação e do render rodam ao mesmo tempo).
+//
+// Uso:
+//   FrameQueue<FrameData> fila;
+//   // simulação                          // render
+//   FrameData& q = fila.beginWrite();      while (const FrameData* q = fila.beginRead()) {
+//   ...preenche q...                           desenha(*q);
+//   fila.publish();                            fila.endRead();
+//   ...                                    }
+//   fila.close();                          // beginRead() devolve nullptr depois do último
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FRAMEQUEUE_PAUSE() _mm_pause()
+#else
+#define FRAMEQUEUE_PAUSE() std::this_thread::yield()
+#endif
+
+template<typename T, int N = 3>
+class FrameQueue {
+public:
+    static_assert(N >= 1, "FrameQueue precisa de pelo menos um pacote");
+
+    // ==== PRODUTORA ====
+
+    // Pacote livre para preencher; espera enquanto os N estiverem na fila
+    T& beginWrite()
+    {
+        auto entry = Clock::now();
+        uint64_t w = written.load(std::memory_order_relaxed);
+        for (int spin = 0; w - read.load(std::memory_order_acquire) >= (uint64_t)N; spin++)
+            backoff(spin);
+        auto now = Clock::now();
+        if (w == 0)
+            start = now;
+        else
+            producerWait += seconds(entry, now);
+        writeStart = now;
+        return slots[w % N];
+    }
+
+    void publish()
+    {
+        producerBusy += seconds(writeStart, Clock::now());
+        written.fetch_add(1, std::memory_order_release);
+    }
+
+    // Sem mais pacotes: a consumidora termina os que já estão na fila
+    void close() { closed.store(true, std::memory_order_release); }
+
+    // ==== CONSUMIDORA ====
+
+    // Próximo pacote publicado, ou nullptr com a fila fechada e vazia
+    const T* beginRead()
+    {
+        auto entry = Clock::now();
+        uint64_t r = read.load(std::memory_order_relaxed);
+        for (int spin = 0; written.load(std::memory_order_acquire) == r; spin++) {
+            if (closed.load(std::memory_order_acquire) && written.load(std::memory_order_acquire) == r)
+                return nullptr;
+            backoff(spin);
+        }
+        auto now = Clock::now();
+        if (r > 0)
+            consumerWait += seconds(entry, now);
+        readStart = now;
+        return &slots[r % N];
+    }
+
+    // Devolve o pacote para a produtora
+    void endRead()
+    {
+        auto now = Clock::now();
+        consumerBusy += seconds(readStart, now);
+        end = now;
+        read.fetch_add(1, std::memory_order_release);
+    }
+
+    // ==== RELATÓRIO ====
+
+    uint64_t consumed() const { return read.load(std::memory_order_acquire); }
+
+    // Depois de juntar as threads. Quadro = tempo de parede / quadros desenhados;
+    // em série ele seria simulação + render, e a sobreposição diz quanto do
+    // menor dos dois ficou escondido atrás do outro
+    void printSummary(const char* mode) const
+    {
+        uint64_t frames = consumed();
+        if (frames == 0)
+            return;
+        double wall = seconds(start, end);
+        double sim = producerBusy / (double)written.load() * 1000.0;
+        double render = consumerBusy / (double)frames * 1000.0;
+        double frame = wall / (double)frames * 1000.0;
+        double hidden = sim + render - frame;
+        double overlap = std::min(sim, render) > 0.0 ? std::max(0.0, std::min(1.0, hidden / std::min(sim, render))) : 0.0;
+        std::cout << "Render (" << mode << ", " << N << " pacotes): " << frames << " quadros, "
+                  << "simulacao " << sim << " ms, render " << render << " ms, quadro " << frame
+                  << " ms (em serie ~" << (sim + render) << " ms), sobreposicao " << (int)(overlap * 100.0 + 0.5) << "%"
+                  << std::endl;
+        std::cout << "  espera: simulacao " << producerWait / (double)written.load() * 1000.0
+                  << " ms/quadro (fila cheia), render " << consumerWait / (double)frames * 1000.0
+                  << " ms/quadro (fila vazia)" << std::endl;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    T slots[N];
+    alignas(64) std::atomic<uint64_t> written{ 0 };
+    alignas(64) std::atomic<uint64_t> read{ 0 };
+    std::atomic<bool> closed{ false };
+
+    // Cada lado só escreve os seus; lidos depois do join
+    alignas(64) Clock::time_point start, writeStart;
+    double producerBusy = 0.0, producerWait = 0.0;
+    alignas(64) Clock::time_point readStart, end;
+    double consumerBusy = 0.0, consumerWait = 0.0;
+
+    static double seconds(Clock::time_point a, Clock::time_point b) { return std::chrono::duration<double>(b - a).count(); }
+
+    static void backoff(int spin)
+    {
+        if (spin < 64)
+            FRAMEQUEUE_PAUSE();
+        else if (spin < 128)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+};
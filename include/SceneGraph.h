@@ -0,0 +1,143 @@
+#pragma once
+
+// ============== GRAFO DE CENA ==============
+// Hierarquia de transformações num array plano: cada nó guarda o índice do
+// pai, a matriz local e a de mundo (world = world do pai * local).
+//
+//   - os nós ficam em pré-ordem: addNode() só aceita como pai o último nó
+//     inserido ou um ancestral dele, então o pai vem sempre antes dos filhos
+//     e a subárvore de i ocupa o intervalo contíguo [i, subtreeEnd(i));
+//   - setLocal() só marca o nó como sujo; update() ordena os sujos e
+//     recalcula cada subárvore suja uma vez, num laço linear sem recursão
+//     (um sujo dentro de uma subárvore já recalculada é pulado);
+//   - nós que não mudam não custam nada no update().
+//
+// Sem GL: a CenaFinal monta um grafo por modelo (um nó por grupo "o" do
+// OBJ) e o cg_bench mede hierarquias profundas e largas.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class SceneGraph {
+public:
+    static constexpr int NONE = -1;
+
+    // Devolve o índice do nó, ou NONE se 'parent' quebra a pré-ordem
+    int addNode(const std::string& name, int parent = NONE, const glm::mat4& local = glm::mat4(1.0f))
+    {
+        int n = (int)parents.size();
+        if (parent != NONE) {
+            int a = n - 1;
+            while (a != NONE && a != parent)
+                a = parents[a];
+            if (a == NONE) {
+                std::cerr << "[grafo] pai " << parent << " de '" << name << "' fora da pré-ordem" << std::endl;
+                return NONE;
+            }
+        }
+        names.push_back(name);
+        parents.push_back(parent);
+        locals.push_back(local);
+        worlds.push_back(local);
+        ends.push_back(n + 1);
+        dirtyFlags.push_back(1);
+        dirty.push_back(n);
+        rangesValid = false;
+        return n;
+    }
+
+    void clear()
+    {
+        names.clear();
+        parents.clear();
+        locals.clear();
+        worlds.clear();
+        ends.clear();
+        dirtyFlags.clear();
+        dirty.clear();
+        rangesValid = true;
+    }
+
+    void setLocal(int node, const glm::mat4& local)
+    {
+        locals[node] = local;
+        if (!dirtyFlags[node]) {
+            dirtyFlags[node] = 1;
+            dirty.push_back(node);
+        }
+    }
+
+    // Recalcula as matrizes de mundo das subárvores sujas
+    void update()
+    {
+        if (!rangesValid)
+            computeRanges();
+        updated = 0;
+        if (dirty.empty())
+            return;
+        std::sort(dirty.begin(), dirty.end());
+        int covered = 0;
+        for (int d : dirty) {
+            if (d < covered)
+                continue;
+            int end = ends[d];
+            for (int i = d; i < end; i++) {
+                int p = parents[i];
+                worlds[i] = p == NONE ? locals[i] : worlds[p] * locals[i];
+                dirtyFlags[i] = 0;
+            }
+            updated += end - d;
+            covered = end;
+        }
+        dirty.clear();
+    }
+
+    // Primeiro nó com o nome, ou NONE
+    int find(const std::string& name) const
+    {
+        auto it = std::find(names.begin(), names.end(), name);
+        return it == names.end() ? NONE : (int)(it - names.begin());
+    }
+
+    int size() const { return (int)parents.size(); }
+    int parent(int node) const { return parents[node]; }
+    const std::string& name(int node) const { return names[node]; }
+    const glm::mat4& local(int node) const { return locals[node]; }
+    // Válida depois do update() que seguiu a última mudança
+    const glm::mat4& world(int node) const { return worlds[node]; }
+    int subtreeEnd(int node)
+    {
+        if (!rangesValid)
+            computeRanges();
+        return ends[node];
+    }
+    // Nós recalculados no último update()
+    int lastUpdated() const { return updated; }
+
+private:
+    std::vector<std::string> names;
+    std::vector<int> parents;
+    std::vector<glm::mat4> locals, worlds;
+    std::vector<int> ends;          // fim (exclusivo) da subárvore
+    std::vector<uint8_t> dirtyFlags; // já está em 'dirty'
+    std::vector<int> dirty;
+    bool rangesValid = true;
+    int updated = 0;
+
+    // De trás para frente: cada filho estende o fim da subárvore do pai
+    void computeRanges()
+    {
+        int n = size();
+        for (int i = 0; i < n; i++)
+            ends[i] = i + 1;
+        for (int i = n - 1; i > 0; i--)
+            if (parents[i] != NONE)
+                ends[parents[i]] = std::max(ends[parents[i]], ends[i]);
+        rangesValid = true;
+    }
+};
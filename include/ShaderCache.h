@@ -0,0 +1,196 @@
+#pragma once
+
+// ============== SHADER PROGRAM BINARY CACHE ==============
+// Guarda programas linkados em disco (glGetProgramBinary) e os recarrega na
+// próxima execução (glProgramBinary), evitando recompilar o GLSL a cada
+// inicialização. A chave é o hash das fontes + GL_RENDERER + GL_VERSION, então
+// trocar de driver ou editar um shader invalida a entrada automaticamente.
+// Quem compila é o ShaderManager: ele consulta o cache com tryLoad() e, se
+// não houver binário (ou o driver rejeitar o que há), compila a partir da
+// fonte e grava o resultado com store().
+//
+// glGetProgramBinary/glProgramBinary são do GL 4.1 e a GLAD do projeto é 4.0,
+// por isso os ponteiros são carregados manualmente em init().
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+
+#include <glad/glad.h>
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+class ShaderCache {
+public:
+    int hits = 0, misses = 0, rejected = 0;
+    double elapsedMs = 0.0; // tempo da thread principal gasto com shaders (somado pelo ShaderManager)
+
+    void init(GLADloadproc load, const std::string& dir)
+    {
+        this->dir = dir;
+        getProgramBinary = (GetProgramBinaryFn)load("glGetProgramBinary");
+        programBinary = (ProgramBinaryFn)load("glProgramBinary");
+        programParameteri = (ProgramParameteriFn)load("glProgramParameteri");
+
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        enabled = getProgramBinary && programBinary && programParameteri && formats > 0;
+        glGetError(); // GL_NUM_PROGRAM_BINARY_FORMATS não existe em contextos < 4.1
+
+        const char* renderer = (const char*)glGetString(GL_RENDERER);
+        const char* version = (const char*)glGetString(GL_VERSION);
+        driverKey = std::string(renderer ? renderer : "") + "|" + (version ? version : "");
+
+        if (enabled) {
+            std::error_code ec;
+            std::filesystem::create_directories(dir, ec);
+        } else {
+            std::cerr << "[shader cache] driver sem suporte a program binaries, cache desativado" << std::endl;
+        }
+    }
+
+    bool isEnabled() const { return enabled; }
+
+    // Só a consulta ao cache: retorna 0 se não houver binário válido
+    GLuint tryLoad(const std::string& name, const char* vertexSource, const char* fragmentSource)
+    {
+        GLuint program = enabled ? loadBinary(entryPath(name, vertexSource, fragmentSource)) : 0;
+        if (program)
+            hits++;
+        else
+            misses++;
+        return program;
+    }
+
+    // Deve ser chamado antes de glLinkProgram para que o binário possa ser lido depois
+    void markRetrievable(GLuint program)
+    {
+        if (enabled)
+            programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // Grava o binário de um programa já linkado (ignora programas com erro)
+    void store(const std::string& name, const char* vertexSource, const char* fragmentSource, GLuint program)
+    {
+        if (enabled)
+            saveBinary(entryPath(name, vertexSource, fragmentSource), program);
+    }
+
+    // Imprime hits/misses e compara a inicialização atual com a última fria
+    void report()
+    {
+        double ms = elapsedMs;
+        bool cold = hits == 0;
+        std::string timingsPath = dir + "/tempos.txt";
+
+        std::cout << "[shader cache] " << (hits + misses) << " programas: " << hits << " hits, " << misses
+                  << " misses, " << rejected << " rejeitados em " << ms << " ms (" << (cold ? "frio" : "quente");
+        if (!cold) {
+            double coldMs = 0.0;
+            std::ifstream in(timingsPath);
+            if (in >> coldMs && coldMs > 0.0)
+                std::cout << "; frio anterior: " << coldMs << " ms, " << coldMs / ms << "x";
+        }
+        std::cout << ")" << std::endl;
+
+        if (cold && enabled) {
+            std::ofstream out(timingsPath);
+            out << ms << std::endl;
+        }
+    }
+
+private:
+    typedef void (APIENTRYP GetProgramBinaryFn)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+    typedef void (APIENTRYP ProgramBinaryFn)(GLuint, GLenum, const void*, GLsizei);
+    typedef void (APIENTRYP ProgramParameteriFn)(GLuint, GLenum, GLint);
+
+    GetProgramBinaryFn getProgramBinary = nullptr;
+    ProgramBinaryFn programBinary = nullptr;
+    ProgramParameteriFn programParameteri = nullptr;
+
+    bool enabled = false;
+    std::string dir;
+    std::string driverKey;
+
+    static const uint32_t MAGIC = 0x43534743; // "CGSC"
+
+    // FNV-1a de 64 bits
+    static uint64_t hash(const std::string& data, uint64_t h = 1469598103934665603ull)
+    {
+        for (unsigned char c : data) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    std::string entryPath(const std::string& name, const char* vs, const char* fs) const
+    {
+        uint64_t h = hash(vs);
+        h = hash(std::string("\0", 1), h);
+        h = hash(fs, h);
+        h = hash(driverKey, h);
+        char hex[17];
+        snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)h);
+        return dir + "/" + name + "-" + hex + ".bin";
+    }
+
+    GLuint loadBinary(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open())
+            return 0;
+
+        uint32_t magic = 0, format = 0, length = 0;
+        in.read((char*)&magic, sizeof(magic));
+        in.read((char*)&format, sizeof(format));
+        in.read((char*)&length, sizeof(length));
+        if (!in || magic != MAGIC || length == 0)
+            return 0;
+        std::vector<char> data(length);
+        if (!in.read(data.data(), length))
+            return 0;
+
+        GLuint program = glCreateProgram();
+        programBinary(program, (GLenum)format, data.data(), (GLsizei)length);
+        GLint ok = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (!ok) {
+            // Binário rejeitado (driver atualizado, formato diferente...): recompila
+            glDeleteProgram(program);
+            rejected++;
+            return 0;
+        }
+        return program;
+    }
+
+    void saveBinary(const std::string& path, GLuint program)
+    {
+        GLint ok = GL_FALSE, length = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (!ok || length <= 0)
+            return;
+
+        std::vector<char> data(length);
+        GLenum format = 0;
+        getProgramBinary(program, length, NULL, &format, data.data());
+
+        std::ofstream out(path, std::ios::binary);
+        uint32_t header[3] = { MAGIC, (uint32_t)format, (uint32_t)length };
+        out.write((const char*)header, sizeof(header));
+        out.write(data.data(), length);
+    }
+};
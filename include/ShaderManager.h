@@ -0,0 +1,263 @@
+#pragma once
+
+// ============== SHADER MANAGER (COMPILAÇÃO ASSÍNCRONA) ==============
+// Emite todas as compilações e links de uma vez e deixa o driver trabalhar
+// enquanto a aplicação carrega modelos e texturas. Com
+// GL_KHR_parallel_shader_compile (ou a versão ARB) o estado é consultado via
+// GL_COMPLETION_STATUS_KHR, sem bloquear; sem a extensão, poll() finaliza os
+// programas na ordem em que foram adicionados. Programas de compute
+// (addCompute) passam pelo mesmo caminho: cache, info logs e relatório.
+//
+// Uso:
+//   int h = shaders.add("phong", vertexSrc, fragmentSrc);
+//   ... carrega assets, chamando shaders.poll() de vez em quando ...
+//   shaders.waitAll();
+//   GLuint programa = shaders.program(h);
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+#include <glad/glad.h>
+
+#include "ShaderCache.h"
+
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+
+class ShaderManager {
+public:
+    void init(GLADloadproc load, ShaderCache* cache = nullptr)
+    {
+        this->cache = cache;
+        start = std::chrono::steady_clock::now();
+
+        if (hasExtension("GL_KHR_parallel_shader_compile"))
+            maxCompilerThreads = (MaxShaderCompilerThreadsFn)load("glMaxShaderCompilerThreadsKHR");
+        else if (hasExtension("GL_ARB_parallel_shader_compile"))
+            maxCompilerThreads = (MaxShaderCompilerThreadsFn)load("glMaxShaderCompilerThreadsARB");
+
+        parallel = maxCompilerThreads != nullptr;
+        if (parallel)
+            maxCompilerThreads(0xFFFFFFFFu); // deixa o driver escolher o número de threads
+    }
+
+    bool isParallel() const { return parallel; }
+
+    // Emite a compilação e o link; retorna um handle para program()
+    int add(const std::string& name, const char* vertexSource, const char* fragmentSource)
+    {
+        Entry e;
+        e.name = name;
+        e.vertexSource = vertexSource;
+        e.fragmentSource = fragmentSource;
+        return submit(e);
+    }
+
+    // Programa só com um compute shader (GL 4.3)
+    int addCompute(const std::string& name, const char* computeSource)
+    {
+        Entry e;
+        e.name = name;
+        e.computeSource = computeSource;
+        return submit(e);
+    }
+
+    // Não bloqueia (com a extensão): finaliza os programas prontos e retorna true quando não há pendentes
+    bool poll()
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        bool allDone = true;
+        for (Entry& e : entries) {
+            if (e.state != PENDING)
+                continue;
+            if (parallel) {
+                GLint done = GL_FALSE;
+                glGetProgramiv(e.program, GL_COMPLETION_STATUS_KHR, &done);
+                if (!done) {
+                    allDone = false;
+                    continue;
+                }
+            }
+            finalize(e);
+        }
+        mainThreadMs += msSince(t0);
+        return allDone;
+    }
+
+    // Bloqueia até todos os programas estarem prontos
+    void waitAll()
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        for (Entry& e : entries)
+            if (e.state == PENDING)
+                finalize(e);
+        double ms = msSince(t0);
+        blockedMs += ms;
+        mainThreadMs += ms;
+    }
+
+    GLuint program(int handle) const { return entries[handle].program; }
+    bool ok(int handle) const { return entries[handle].state == READY; }
+
+    void report()
+    {
+        int fromCache = 0, failed = 0;
+        double lastReady = 0.0;
+        for (const Entry& e : entries) {
+            fromCache += e.fromCache;
+            failed += e.state == FAILED;
+            lastReady = std::max(lastReady, e.readyMs);
+        }
+        std::cout << "[shaders] " << entries.size() << " programas (" << fromCache << " do cache, " << failed << " com erro), "
+                  << (parallel ? "GL_KHR_parallel_shader_compile" : "compilação síncrona") << ": todos prontos em "
+                  << lastReady << " ms, " << blockedMs << " ms bloqueado em waitAll()" << std::endl;
+        if (cache) {
+            cache->elapsedMs += mainThreadMs;
+            cache->report();
+        }
+    }
+
+private:
+    typedef void (APIENTRYP MaxShaderCompilerThreadsFn)(GLuint);
+
+    enum State { PENDING, READY, FAILED };
+
+    struct Entry {
+        std::string name;
+        const char* vertexSource = nullptr;
+        const char* fragmentSource = nullptr;
+        const char* computeSource = nullptr;
+        GLuint program = 0, vertex = 0, fragment = 0, compute = 0;
+        State state = PENDING;
+        bool fromCache = false;
+        double readyMs = 0.0; // desde init()
+
+        // Fontes na chave do cache (compute: a fonte e uma vazia)
+        const char* firstSource() const { return computeSource ? computeSource : vertexSource; }
+        const char* secondSource() const { return computeSource ? "" : fragmentSource; }
+    };
+
+    std::vector<Entry> entries;
+    ShaderCache* cache = nullptr;
+    MaxShaderCompilerThreadsFn maxCompilerThreads = nullptr;
+    bool parallel = false;
+    std::chrono::steady_clock::time_point start;
+    double blockedMs = 0.0;
+    double mainThreadMs = 0.0;
+
+    static double msSince(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    double elapsedMs() const { return msSince(start); }
+
+    int submit(Entry& e)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        if (cache)
+            e.program = cache->tryLoad(e.name, e.firstSource(), e.secondSource());
+        if (e.program) {
+            e.state = READY;
+            e.fromCache = true;
+            e.readyMs = elapsedMs();
+        } else {
+            if (e.computeSource) {
+                e.compute = compileStage(GL_COMPUTE_SHADER, e.computeSource);
+            } else {
+                e.vertex = compileStage(GL_VERTEX_SHADER, e.vertexSource);
+                e.fragment = compileStage(GL_FRAGMENT_SHADER, e.fragmentSource);
+            }
+
+            // O link pode ser pedido logo em seguida: o driver encadeia as etapas
+            e.program = glCreateProgram();
+            if (cache)
+                cache->markRetrievable(e.program);
+            for (GLuint shader : { e.vertex, e.fragment, e.compute })
+                if (shader)
+                    glAttachShader(e.program, shader);
+            glLinkProgram(e.program);
+            e.state = PENDING;
+        }
+
+        entries.push_back(e);
+        mainThreadMs += msSince(t0);
+        return (int)entries.size() - 1;
+    }
+
+    static GLuint compileStage(GLenum stage, const char* source)
+    {
+        GLuint shader = glCreateShader(stage);
+        glShaderSource(shader, 1, &source, NULL);
+        glCompileShader(shader);
+        return shader;
+    }
+
+    static bool hasExtension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            if (ext && strcmp(ext, name) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Confere compilação e link, imprime os info logs e grava no cache
+    void finalize(Entry& e)
+    {
+        bool vsOk = !e.vertex || checkShader(e.name, "vertex", e.vertex);
+        bool fsOk = !e.fragment || checkShader(e.name, "fragment", e.fragment);
+        bool csOk = !e.compute || checkShader(e.name, "compute", e.compute);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(e.program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            GLint length = 0;
+            glGetProgramiv(e.program, GL_INFO_LOG_LENGTH, &length);
+            std::string log(length > 1 ? length : 1, '\0');
+            glGetProgramInfoLog(e.program, (GLsizei)log.size(), NULL, &log[0]);
+            std::cerr << "[shaders] erro de link em '" << e.name << "':\n" << log.c_str() << std::endl;
+        }
+
+        for (GLuint shader : { e.vertex, e.fragment, e.compute }) {
+            if (!shader)
+                continue;
+            glDetachShader(e.program, shader);
+            glDeleteShader(shader);
+        }
+        e.vertex = e.fragment = e.compute = 0;
+
+        e.state = (vsOk && fsOk && csOk && linked) ? READY : FAILED;
+        e.readyMs = elapsedMs();
+        if (e.state == READY && cache)
+            cache->store(e.name, e.firstSource(), e.secondSource(), e.program);
+    }
+
+    static bool checkShader(const std::string& name, const char* stage, GLuint shader)
+    {
+        GLint ok = GL_FALSE, length = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        if (length > 1) {
+            std::string log(length, '\0');
+            glGetShaderInfoLog(shader, length, NULL, &log[0]);
+            std::cerr << "[shaders] " << (ok ? "avisos" : "erro") << " no " << stage << " shader de '" << name << "':\n"
+                      << log.c_str() << std::endl;
+        }
+        return ok == GL_TRUE;
+    }
+};
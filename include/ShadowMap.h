@@ -0,0 +1,158 @@
+#pragma once
+
+// ============== SHADOW MAP DO SPOTLIGHT (COM CACHE) ==============
+// Mapa de profundidade em perspectiva a partir do spotlight, amostrado com
+// sampler2DShadow (comparação + filtro linear = PCF 2x2 por amostra).
+//
+// Com o cache ligado há três camadas:
+//   - estática: casters que não se movem (casa, chão). Só é refeita quando
+//     a posição ou a direção da luz mudam;
+//   - dinâmica: cópia (blit) da estática + casters que se movem às vezes
+//     (vaca, vacas do rebanho). Só é refeita quando a luz ou a chave dos
+//     dinâmicos (as matrizes e uma geração, como a do rebanho) mudam;
+//   - final: cópia da dinâmica + casters animados (o ovni gira todo frame,
+//     com as partes e os ovnis do rebanho), redesenhados a cada frame.
+// Sem o cache, tudo é desenhado de novo a cada frame.
+
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+struct ShadowStats {
+    int frames = 0;
+    int staticRenders = 0;   // camada estática redesenhada
+    int dynamicRenders = 0;  // camada dinâmica recomposta
+    int skipped = 0;         // frames que reaproveitaram a camada dinâmica
+    double cpuMs = 0.0;      // tempo de CPU gasto em render()
+};
+
+class SpotShadowMap {
+public:
+    typedef std::function<void(const glm::mat4& lightSpace)> DrawFn;
+
+    bool cacheEnabled = true;
+
+    void init(int size, float fovDegrees = 100.0f, float nearPlane = 0.5f, float farPlane = 60.0f)
+    {
+        this->size = size;
+        fov = fovDegrees;
+        zNear = nearPlane;
+        zFar = farPlane;
+        createLayer(staticTex, staticFbo);
+        createLayer(dynamicTex, dynamicFbo);
+        createLayer(finalTex, finalFbo);
+    }
+
+    int resolution() const { return size; }
+    GLuint texture() const { return finalTex; }
+    GLuint framebuffer() const { return finalFbo; }
+    const glm::mat4& lightSpace() const { return lightMatrix; }
+    const ShadowStats& stats() const { return counters; }
+    void resetStats() { counters = ShadowStats(); }
+
+    // Informa a luz e a chave dos casters dinâmicos deste frame: as transformações
+    // e uma geração para o que não cabe nelas (instâncias)
+    void update(const glm::vec3& lightPos, const glm::vec3& lightDir, const std::vector<glm::mat4>& dynamicTransforms,
+                uint64_t dynamicGeneration = 0)
+    {
+        if (lightPos != lastPos || lightDir != lastDir || !valid) {
+            lastPos = lightPos;
+            lastDir = lightDir;
+            glm::vec3 up = std::abs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            glm::mat4 proj = glm::perspective(glm::radians(fov), 1.0f, zNear, zFar);
+            lightMatrix = proj * glm::lookAt(lightPos, lightPos + lightDir, up);
+            staticDirty = dynamicDirty = true;
+        }
+        if (dynamicTransforms != lastDynamic || dynamicGeneration != lastGeneration) {
+            lastDynamic = dynamicTransforms;
+            lastGeneration = dynamicGeneration;
+            dynamicDirty = true;
+        }
+        valid = true;
+    }
+
+    // Desenha o que estiver desatualizado e os animados; espera o estado de profundidade aplicado
+    // e deixa o FBO final ligado
+    void render(const DrawFn& drawStatic, const DrawFn& drawDynamic, const DrawFn& drawAnimated)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        counters.frames++;
+        if (!cacheEnabled) {
+            glBindFramebuffer(GL_FRAMEBUFFER, finalFbo);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            drawStatic(lightMatrix);
+            drawDynamic(lightMatrix);
+            drawAnimated(lightMatrix);
+            counters.staticRenders++;
+            counters.dynamicRenders++;
+            staticDirty = dynamicDirty = true; // ao religar o cache, tudo é refeito
+        } else {
+            if (staticDirty) {
+                glBindFramebuffer(GL_FRAMEBUFFER, staticFbo);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                drawStatic(lightMatrix);
+                counters.staticRenders++;
+            }
+            if (staticDirty || dynamicDirty) {
+                copyLayer(staticFbo, dynamicFbo);
+                glBindFramebuffer(GL_FRAMEBUFFER, dynamicFbo);
+                drawDynamic(lightMatrix);
+                counters.dynamicRenders++;
+            } else {
+                counters.skipped++;
+            }
+            copyLayer(dynamicFbo, finalFbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, finalFbo);
+            drawAnimated(lightMatrix);
+            staticDirty = dynamicDirty = false;
+        }
+        counters.cpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+private:
+    int size = 1024;
+    float fov = 100.0f, zNear = 0.5f, zFar = 60.0f;
+    GLuint staticTex = 0, staticFbo = 0, dynamicTex = 0, dynamicFbo = 0, finalTex = 0, finalFbo = 0;
+
+    glm::mat4 lightMatrix = glm::mat4(1.0f);
+    glm::vec3 lastPos = glm::vec3(0.0f), lastDir = glm::vec3(0.0f);
+    std::vector<glm::mat4> lastDynamic;
+    uint64_t lastGeneration = 0;
+    bool valid = false, staticDirty = true, dynamicDirty = true;
+    ShadowStats counters;
+
+    void copyLayer(GLuint from, GLuint to) const
+    {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, from);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, to);
+        glBlitFramebuffer(0, 0, size, size, 0, 0, size, size, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    }
+
+    void createLayer(GLuint& tex, GLuint& fbo)
+    {
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, size, size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        float border[4] = { 1.0f, 1.0f, 1.0f, 1.0f }; // fora do mapa = iluminado
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, border);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, tex, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+// ============== SOMBREAMENTO EM CPU ==============
+// Texturas, materiais, luz e o modelo de iluminação dos fragment shaders em
+// CPU, compartilhados pelo rasterizador em software e pelo ray tracer (as
+// duas imagens precisam sair iguais às do GL para serem comparáveis).
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include <ObjLoader.h>
+
+// Textura RGBA8 com amostragem bilinear e GL_REPEAT (linha 0 = t = 0, como no glTexImage2D)
+struct SoftTexture {
+    int width = 0, height = 0;
+    std::vector<uint8_t> texels; // RGBA
+
+    // Converte 1, 2, 3 ou 4 canais (saída do stbi_load) para RGBA
+    void assign(const unsigned char* data, int w, int h, int channels)
+    {
+        width = w;
+        height = h;
+        texels.resize((size_t)w * h * 4);
+        for (size_t i = 0; i < (size_t)w * h; i++) {
+            const unsigned char* s = data + i * channels;
+            uint8_t* d = &texels[i * 4];
+            d[0] = s[0];
+            d[1] = channels > 2 ? s[1] : s[0];
+            d[2] = channels > 2 ? s[2] : s[0];
+            d[3] = channels == 4 ? s[3] : (channels == 2 ? s[1] : 255);
+        }
+    }
+
+    glm::vec3 sample(float u, float v) const
+    {
+        if (width == 0)
+            return glm::vec3(1.0f);
+        float x = u * width - 0.5f, y = v * height - 0.5f;
+        float fx = std::floor(x), fy = std::floor(y);
+        float ax = x - fx, ay = y - fy;
+        int x0 = wrap((int)fx, width), x1 = wrap((int)fx + 1, width);
+        int y0 = wrap((int)fy, height), y1 = wrap((int)fy + 1, height);
+        glm::vec3 c00 = texel(x0, y0), c10 = texel(x1, y0), c01 = texel(x0, y1), c11 = texel(x1, y1);
+        return glm::mix(glm::mix(c00, c10, ax), glm::mix(c01, c11, ax), ay);
+    }
+
+private:
+    static int wrap(int i, int n)
+    {
+        i %= n;
+        return i < 0 ? i + n : i;
+    }
+
+    glm::vec3 texel(int x, int y) const
+    {
+        const uint8_t* t = &texels[((size_t)y * width + x) * 4];
+        return glm::vec3(t[0], t[1], t[2]) * (1.0f / 255.0f);
+    }
+};
+
+// Parâmetros do fragment shader. Os padrões reproduzem o shader principal da
+// CenaFinal; o Phong.cpp usa spot = false, attenuation = false, gain = 1 e
+// specColor = 1.
+struct SoftLight {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 direction = glm::vec3(0.0f, -1.0f, 0.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    glm::vec3 specColor = glm::vec3(0.6f); // CenaFinal: lightColor * 0.4 + 0.2
+    bool spot = true;
+    float cutoff = 0.85f, outerCutoff = 0.70f;
+    bool attenuation = true;
+    float gain = 2.0f;
+};
+
+struct SoftMaterial {
+    Material material;
+    const SoftTexture* texture = nullptr; // nullptr = branco
+};
+
+// Cone do spot em fragPos (1 sem spot); é o fator que a sombra multiplica
+inline float spotIntensity(const SoftLight& light, const glm::vec3& fragPos)
+{
+    if (!light.spot)
+        return 1.0f;
+    float theta = glm::dot(glm::normalize(light.position - fragPos), glm::normalize(-light.direction));
+    return glm::clamp((theta - light.outerCutoff) / (light.cutoff - light.outerCutoff), 0.0f, 1.0f);
+}
+
+// Mesmo cálculo do fragment shader; 'intensity' = spotIntensity * sombra
+inline glm::vec3 shadeFragment(const SoftMaterial& m, const SoftLight& light, const glm::vec3& fragPos,
+                               const glm::vec3& normal, const glm::vec2& uv, const glm::vec3& viewPos, float intensity)
+{
+    glm::vec3 norm = glm::normalize(normal);
+    glm::vec3 baseColor = m.texture ? m.texture->sample(uv.x, uv.y) : glm::vec3(1.0f);
+
+    glm::vec3 ambient = m.material.ka * baseColor;
+    glm::vec3 lightDirection = glm::normalize(light.position - fragPos);
+    float diff = std::max(glm::dot(norm, lightDirection), 0.0f);
+    glm::vec3 diffuse = m.material.kd * diff * baseColor * light.color * intensity;
+
+    glm::vec3 viewDir = glm::normalize(viewPos - fragPos);
+    glm::vec3 reflectDir = glm::reflect(-lightDirection, norm);
+    float spec = std::pow(std::max(glm::dot(viewDir, reflectDir), 0.0f), m.material.shininess);
+    glm::vec3 specular = m.material.ks * spec * light.specColor * intensity;
+
+    float attenuation = 1.0f;
+    if (light.attenuation) {
+        float distance = glm::length(light.position - fragPos);
+        attenuation = 1.0f / (1.0f + 0.05f * distance + 0.01f * distance * distance);
+    }
+    return (ambient + diffuse + specular) * attenuation * light.gain;
+}
+
+// RGBA8 empacotado (R no byte menos significativo), com clamp em [0, 1]
+inline uint32_t packColor(const glm::vec3& c)
+{
+    auto channel = [](float v) { return (uint32_t)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f); };
+    return channel(c.r) | (channel(c.g) << 8) | (channel(c.b) << 16) | (255u << 24);
+}
@@ -0,0 +1,436 @@
+#pragma once
+
+// ============== RASTERIZADOR EM SOFTWARE (TILES + THREADS) ==============
+// Desenha na CPU os mesmos triângulos texturizados das cenas em GL, com o
+// modelo de iluminação dos fragment shaders (ambiente + difusa + especular,
+// cone do spot e atenuação opcionais). Não precisa de driver GL.
+//
+// Etapas:
+//   draw()   transforma os vértices, recorta no plano near, faz o setup de
+//            cada triângulo (planos das arestas, da profundidade, de 1/w e dos
+//            atributos/w, tudo em double e relativo a um ponto da tela) e
+//            distribui o triângulo nos bins dos tiles que a caixa toca;
+//   finish() as threads pegam tiles de um contador atômico; cada tile percorre
+//            o seu bin na ordem de submissão, testando 8 pixels por vez
+//            (funções de aresta e profundidade em SIMD: AVX, 2x SSE ou
+//            escalar), guardando o triângulo visível em cada pixel; no fim
+//            sombreia cada pixel uma vez, com interpolação correta em
+//            perspectiva e amostragem bilinear.
+//
+// Cada pixel é escrito só pela thread dono do tile e na ordem de submissão,
+// então a imagem é idêntica com qualquer número de threads. A regra top-left
+// garante que arestas compartilhadas não são desenhadas duas vezes.
+//
+// O framebuffer segue a convenção do GL: linha 0 embaixo, RGBA8.
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include <SoftShading.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SOFTRAST_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOFTRAST_SSE 1
+#endif
+
+struct SoftRasterStats {
+    int drawCalls = 0;
+    int triangles = 0;       // submetidos
+    int setupTriangles = 0;  // após recorte e descarte de área nula
+    int binEntries = 0;      // soma dos tamanhos dos bins
+    double setupMs = 0.0, rasterMs = 0.0;
+};
+
+class SoftRasterizer {
+public:
+    static constexpr int TILE = 64; // múltiplo de 8
+
+    void resize(int w, int h)
+    {
+        width = w;
+        height = h;
+        tilesX = (w + TILE - 1) / TILE;
+        tilesY = (h + TILE - 1) / TILE;
+        color.assign((size_t)w * h, 0);
+        depth.assign((size_t)w * h, 1.0f);
+        bins.assign((size_t)tilesX * tilesY, std::vector<uint32_t>());
+    }
+
+    void setThreads(int n) { numThreads = n > 0 ? n : std::max(1u, std::thread::hardware_concurrency()); }
+    int threads() const { return numThreads; }
+    int framebufferWidth() const { return width; }
+    int framebufferHeight() const { return height; }
+
+    // Início do frame: cor de fundo ou textura de fundo (quad de tela cheia, como o céu da CenaFinal)
+    void begin(const glm::vec3& clearColor, const SoftTexture* background = nullptr)
+    {
+        clear = clearColor;
+        this->background = background;
+        triangles.clear();
+        materials.clear();
+        for (std::vector<uint32_t>& b : bins)
+            b.clear();
+        counters = SoftRasterStats();
+    }
+
+    void setCamera(const glm::mat4& view, const glm::mat4& proj, const glm::vec3& viewPos)
+    {
+        viewProj = proj * view;
+        cameraPos = viewPos;
+    }
+
+    void setLight(const SoftLight& l) { light = l; }
+
+    // Equivalente a glDrawArrays(GL_TRIANGLES) com o material e o model dados
+    void draw(const std::vector<Vertex>& vertices, const glm::mat4& model, const SoftMaterial& material)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        uint32_t matIndex = (uint32_t)materials.size();
+        materials.push_back(material);
+        glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
+        counters.drawCalls++;
+
+        for (size_t i = 0; i + 2 < vertices.size(); i += 3) {
+            ClipVertex tri[3];
+            for (int k = 0; k < 3; k++) {
+                const Vertex& v = vertices[i + k];
+                ClipVertex& c = tri[k];
+                glm::vec3 world = glm::vec3(model * glm::vec4(v.position, 1.0f));
+                c.clip = viewProj * glm::vec4(world, 1.0f);
+                c.attr[0] = world.x; c.attr[1] = world.y; c.attr[2] = world.z;
+                glm::vec3 n = normalMatrix * v.normal;
+                c.attr[3] = n.x; c.attr[4] = n.y; c.attr[5] = n.z;
+                c.attr[6] = v.texCoord.x; c.attr[7] = v.texCoord.y;
+            }
+            counters.triangles++;
+            clipAndSetup(tri, matIndex);
+        }
+        counters.setupMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // Rasteriza todos os tiles; depois disso pixels() tem o frame pronto
+    void finish()
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        std::atomic<int> nextTile(0);
+        int total = tilesX * tilesY;
+        auto worker = [&]() {
+            for (int t = nextTile++; t < total; t = nextTile++)
+                rasterizeTile(t % tilesX, t / tilesX);
+        };
+        int extra = std::min(numThreads, total) - 1;
+        std::vector<std::thread> pool;
+        pool.reserve(extra);
+        for (int i = 0; i < extra; i++)
+            pool.emplace_back(worker);
+        worker();
+        for (std::thread& th : pool)
+            th.join();
+        for (const std::vector<uint32_t>& b : bins)
+            counters.binEntries += (int)b.size();
+        counters.rasterMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    const std::vector<uint32_t>& pixels() const { return color; } // RGBA8, linha 0 embaixo
+    const SoftRasterStats& stats() const { return counters; }
+
+private:
+    static constexpr int ATTRS = 8; // posição no mundo (3), normal (3), uv (2)
+
+    struct ClipVertex {
+        glm::vec4 clip;
+        float attr[ATTRS];
+    };
+
+    // Plano a(x, y) = ref + dx * (x - refX) + dy * (y - refY)
+    struct Plane {
+        float ref, dx, dy;
+        float at(float x, float y) const { return ref + dx * x + dy * y; }
+    };
+
+    struct SetupTriangle {
+        float refX, refY;           // ponto de referência (canto da caixa na tela)
+        int minX, minY, maxX, maxY; // caixa em pixels, já recortada na tela
+        Plane edge[3];
+        bool topLeft[3];
+        Plane z, invW;
+        Plane attr[ATTRS];          // atributo / w
+        uint32_t material;
+    };
+
+    int width = 0, height = 0, tilesX = 0, tilesY = 0;
+    int numThreads = 1;
+    std::vector<uint32_t> color;
+    std::vector<float> depth;
+    std::vector<std::vector<uint32_t>> bins;
+    std::vector<SetupTriangle> triangles;
+    std::vector<SoftMaterial> materials;
+
+    glm::mat4 viewProj = glm::mat4(1.0f);
+    glm::vec3 cameraPos = glm::vec3(0.0f);
+    SoftLight light;
+    glm::vec3 clear = glm::vec3(0.0f);
+    const SoftTexture* background = nullptr;
+    SoftRasterStats counters;
+
+    // ==== RECORTE (z >= -w) E SETUP ====
+    void clipAndSetup(const ClipVertex in[3], uint32_t matIndex)
+    {
+        ClipVertex poly[4];
+        int n = 0;
+        for (int i = 0; i < 3; i++) {
+            const ClipVertex& a = in[i];
+            const ClipVertex& b = in[(i + 1) % 3];
+            float da = a.clip.z + a.clip.w, db = b.clip.z + b.clip.w;
+            if (da >= 0.0f)
+                poly[n++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                float t = da / (da - db);
+                ClipVertex& c = poly[n++];
+                c.clip = glm::mix(a.clip, b.clip, t);
+                for (int k = 0; k < ATTRS; k++)
+                    c.attr[k] = a.attr[k] + (b.attr[k] - a.attr[k]) * t;
+            }
+        }
+        for (int i = 1; i + 1 < n; i++)
+            setup(poly[0], poly[i], poly[i + 1], matIndex);
+    }
+
+    void setup(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, uint32_t matIndex)
+    {
+        const ClipVertex* v[3] = { &v0, &v1, &v2 };
+        double X[3], Y[3], Z[3], W[3];
+        for (int i = 0; i < 3; i++) {
+            double w = v[i]->clip.w;
+            if (w <= 0.0)
+                return;
+            W[i] = 1.0 / w;
+            X[i] = (v[i]->clip.x * W[i] * 0.5 + 0.5) * width;
+            Y[i] = (v[i]->clip.y * W[i] * 0.5 + 0.5) * height;
+            Z[i] = v[i]->clip.z * W[i] * 0.5 + 0.5;
+        }
+        double area = (X[1] - X[0]) * (Y[2] - Y[0]) - (X[2] - X[0]) * (Y[1] - Y[0]);
+        if (std::fabs(area) < 1e-12)
+            return;
+        if (area < 0.0) { // sem culling: inverte para ficar anti-horário
+            std::swap(X[1], X[2]); std::swap(Y[1], Y[2]); std::swap(Z[1], Z[2]); std::swap(W[1], W[2]);
+            std::swap(v[1], v[2]);
+            area = -area;
+        }
+
+        double bx0 = std::min({ X[0], X[1], X[2] }), bx1 = std::max({ X[0], X[1], X[2] });
+        double by0 = std::min({ Y[0], Y[1], Y[2] }), by1 = std::max({ Y[0], Y[1], Y[2] });
+        SetupTriangle t;
+        t.minX = std::max(0, (int)std::floor(bx0));
+        t.minY = std::max(0, (int)std::floor(by0));
+        t.maxX = std::min(width - 1, (int)std::ceil(bx1));
+        t.maxY = std::min(height - 1, (int)std::ceil(by1));
+        if (t.minX > t.maxX || t.minY > t.maxY)
+            return;
+        // Os planos são avaliados em (x + 0.5 - refX, y + 0.5 - refY): valores pequenos mesmo com vértices fora da tela
+        t.refX = (float)t.minX;
+        t.refY = (float)t.minY;
+        t.material = matIndex;
+
+        double lambda[3][3]; // [vértice] = (no ponto de referência, d/dx, d/dy)
+        for (int e = 0; e < 3; e++) {
+            int a = (e + 1) % 3, b = (e + 2) % 3; // aresta oposta ao vértice e
+            double A = -(Y[b] - Y[a]), B = X[b] - X[a];
+            double Eref = A * (t.refX - X[a]) + B * (t.refY - Y[a]);
+            t.edge[e] = { (float)Eref, (float)A, (float)B };
+            t.topLeft[e] = A > 0.0 || (A == 0.0 && B < 0.0);
+            lambda[e][0] = Eref / area;
+            lambda[e][1] = A / area;
+            lambda[e][2] = B / area;
+        }
+        auto plane = [&](const double value[3]) {
+            double r = 0.0, dx = 0.0, dy = 0.0;
+            for (int i = 0; i < 3; i++) {
+                r += value[i] * lambda[i][0];
+                dx += value[i] * lambda[i][1];
+                dy += value[i] * lambda[i][2];
+            }
+            return Plane{ (float)r, (float)dx, (float)dy };
+        };
+        t.z = plane(Z);
+        t.invW = plane(W);
+        for (int k = 0; k < ATTRS; k++) {
+            double values[3] = { v[0]->attr[k] * W[0], v[1]->attr[k] * W[1], v[2]->attr[k] * W[2] };
+            t.attr[k] = plane(values);
+        }
+
+        uint32_t index = (uint32_t)triangles.size();
+        triangles.push_back(t);
+        counters.setupTriangles++;
+        for (int ty = t.minY / TILE; ty <= t.maxY / TILE; ty++)
+            for (int tx = t.minX / TILE; tx <= t.maxX / TILE; tx++)
+                bins[(size_t)ty * tilesX + tx].push_back(index);
+    }
+
+    // ==== RASTERIZAÇÃO ====
+    // Em duas passadas por tile: primeiro só profundidade e o índice do triângulo
+    // visível em cada pixel (buffer de visibilidade local), depois o sombreamento
+    // de cada pixel uma única vez, sem custo de overdraw.
+    static constexpr uint32_t NO_TRIANGLE = 0xffffffffu;
+
+    void rasterizeTile(int tx, int ty)
+    {
+        int x0 = tx * TILE, y0 = ty * TILE;
+        int x1 = std::min(width, x0 + TILE) - 1, y1 = std::min(height, y0 + TILE) - 1;
+        uint32_t visible[TILE * TILE];
+        std::fill(visible, visible + TILE * TILE, NO_TRIANGLE);
+        for (int y = y0; y <= y1; y++)
+            std::fill(&depth[(size_t)y * width + x0], &depth[(size_t)y * width + x1] + 1, 1.0f);
+
+        for (uint32_t index : bins[(size_t)ty * tilesX + tx]) {
+            const SetupTriangle& t = triangles[index];
+            int rx0 = std::max(x0, t.minX), ry0 = std::max(y0, t.minY);
+            int rx1 = std::min(x1, t.maxX), ry1 = std::min(y1, t.maxY);
+            if (rx0 > rx1 || ry0 > ry1)
+                continue;
+            int gx0 = x0 + ((rx0 - x0) & ~7); // grupos de 8 alinhados ao tile
+            for (int y = ry0; y <= ry1; y++) {
+                float py = y + 0.5f - t.refY;
+                for (int gx = gx0; gx <= rx1; gx += 8)
+                    rasterizeGroup(t, index, gx, y, py, rx0, rx1, &visible[(y - y0) * TILE + (gx - x0)]);
+            }
+        }
+
+        // Sombreamento (ou fundo, onde nenhum triângulo passou)
+        uint32_t clearPacked = packColor(clear);
+        for (int y = y0; y <= y1; y++) {
+            const uint32_t* ids = &visible[(y - y0) * TILE];
+            for (int x = x0; x <= x1; x++) {
+                uint32_t id = ids[x - x0];
+                glm::vec3 c;
+                if (id != NO_TRIANGLE) {
+                    const SetupTriangle& t = triangles[id];
+                    c = shade(t, x + 0.5f - t.refX, y + 0.5f - t.refY);
+                } else if (background) {
+                    c = background->sample((x + 0.5f) / width, (y + 0.5f) / height);
+                } else {
+                    color[(size_t)y * width + x] = clearPacked;
+                    continue;
+                }
+                color[(size_t)y * width + x] = packColor(c);
+            }
+        }
+    }
+
+    // 8 pixels (gx .. gx+7) da linha y; 'ids' aponta para o pixel gx no buffer de visibilidade
+    void rasterizeGroup(const SetupTriangle& t, uint32_t index, int gx, int y, float py, int rx0, int rx1, uint32_t* ids)
+    {
+        float px = gx + 0.5f - t.refX;
+        int mask = coverage(t, px, py);
+        // Fora da caixa / da tela
+        int lo = rx0 - gx, hi = rx1 - gx;
+        if (lo > 0)
+            mask &= ~((1 << lo) - 1);
+        if (hi < 7)
+            mask &= (1 << (hi + 1)) - 1;
+        if (!mask)
+            return;
+
+        // Teste de profundidade (GL_LESS)
+        float z[8];
+        depthPlane(t, px, py, z);
+        float* row = &depth[(size_t)y * width + gx];
+        for (int lane = 0; lane < 8; lane++) {
+            if (!(mask & (1 << lane)) || !(z[lane] < row[lane]) || z[lane] > 1.0f)
+                continue;
+            row[lane] = z[lane];
+            ids[lane] = index;
+        }
+    }
+
+#if defined(SOFTRAST_AVX)
+    int coverage(const SetupTriangle& t, float px, float py) const
+    {
+        const __m256 lanes = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256 x = _mm256_add_ps(_mm256_set1_ps(px), lanes), zero = _mm256_setzero_ps();
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int e = 0; e < 3; e++) {
+            const Plane& p = t.edge[e];
+            __m256 E = _mm256_add_ps(_mm256_set1_ps(p.ref + p.dy * py), _mm256_mul_ps(_mm256_set1_ps(p.dx), x));
+            __m256 ok = t.topLeft[e] ? _mm256_cmp_ps(E, zero, _CMP_GE_OQ) : _mm256_cmp_ps(E, zero, _CMP_GT_OQ);
+            inside = _mm256_and_ps(inside, ok);
+        }
+        return _mm256_movemask_ps(inside);
+    }
+
+    void depthPlane(const SetupTriangle& t, float px, float py, float out[8]) const
+    {
+        const __m256 lanes = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256 x = _mm256_add_ps(_mm256_set1_ps(px), lanes);
+        _mm256_storeu_ps(out, _mm256_add_ps(_mm256_set1_ps(t.z.ref + t.z.dy * py), _mm256_mul_ps(_mm256_set1_ps(t.z.dx), x)));
+    }
+#elif defined(SOFTRAST_SSE)
+    int coverage(const SetupTriangle& t, float px, float py) const
+    {
+        int mask = 0;
+        for (int half = 0; half < 2; half++) {
+            __m128 x = _mm_add_ps(_mm_set1_ps(px), _mm_setr_ps(half * 4.0f, half * 4.0f + 1, half * 4.0f + 2, half * 4.0f + 3));
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1)), zero = _mm_setzero_ps();
+            for (int e = 0; e < 3; e++) {
+                const Plane& p = t.edge[e];
+                __m128 E = _mm_add_ps(_mm_set1_ps(p.ref + p.dy * py), _mm_mul_ps(_mm_set1_ps(p.dx), x));
+                inside = _mm_and_ps(inside, t.topLeft[e] ? _mm_cmpge_ps(E, zero) : _mm_cmpgt_ps(E, zero));
+            }
+            mask |= _mm_movemask_ps(inside) << (half * 4);
+        }
+        return mask;
+    }
+
+    void depthPlane(const SetupTriangle& t, float px, float py, float out[8]) const
+    {
+        __m128 base = _mm_set1_ps(t.z.ref + t.z.dy * py), dx = _mm_set1_ps(t.z.dx);
+        __m128 x0 = _mm_add_ps(_mm_set1_ps(px), _mm_setr_ps(0, 1, 2, 3));
+        __m128 x1 = _mm_add_ps(_mm_set1_ps(px), _mm_setr_ps(4, 5, 6, 7));
+        _mm_storeu_ps(out, _mm_add_ps(base, _mm_mul_ps(dx, x0)));
+        _mm_storeu_ps(out + 4, _mm_add_ps(base, _mm_mul_ps(dx, x1)));
+    }
+#else
+    int coverage(const SetupTriangle& t, float px, float py) const
+    {
+        int mask = 0;
+        for (int lane = 0; lane < 8; lane++) {
+            bool inside = true;
+            for (int e = 0; e < 3; e++) {
+                const Plane& p = t.edge[e];
+                float E = (p.ref + p.dy * py) + p.dx * (px + lane);
+                inside = inside && (t.topLeft[e] ? E >= 0.0f : E > 0.0f);
+            }
+            mask |= inside << lane;
+        }
+        return mask;
+    }
+
+    void depthPlane(const SetupTriangle& t, float px, float py, float out[8]) const
+    {
+        for (int lane = 0; lane < 8; lane++)
+            out[lane] = (t.z.ref + t.z.dy * py) + t.z.dx * (px + lane);
+    }
+#endif
+
+    // Atributos corrigidos pela perspectiva no centro do pixel + fragment shader
+    glm::vec3 shade(const SetupTriangle& t, float px, float py) const
+    {
+        float w = 1.0f / t.invW.at(px, py);
+        float a[ATTRS];
+        for (int k = 0; k < ATTRS; k++)
+            a[k] = t.attr[k].at(px, py) * w;
+        glm::vec3 fragPos(a[0], a[1], a[2]);
+        return shadeFragment(materials[t.material], light, fragPos, glm::vec3(a[3], a[4], a[5]), glm::vec2(a[6], a[7]),
+                             cameraPos, spotIntensity(light, fragPos));
+    }
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+// ============== TRAJETÓRIA EM SPLINE ==============
+// Caminho Catmull-Rom pelos pontos de controle, percorrido com velocidade
+// constante por comprimento de arco:
+//   - alpha 0 = uniforme, 0.5 = centrípeta (sem laços nem cúspides em pontos
+//     muito desiguais), 1 = cordal; cada segmento vira um cúbico
+//     a + b u + c u² + d u³ em u ∈ [0, 1], calculado uma vez no build();
+//   - a tabela de comprimento de arco (LUT) divide cada segmento em
+//     'samplesPerSegment' trechos e guarda a distância acumulada (quadratura
+//     de Gauss de 3 pontos por trecho); a posição a uma distância s acha o
+//     trecho por busca binária (O(log n)) ou, com um cursor guardado por quem
+//     anda, em O(1) amortizado andando para frente;
+//   - dentro do trecho, u(s) é um Hermite cúbico com as derivadas du/ds das
+//     pontas (1 / velocidade da curva), limitadas para continuar monotônico
+//     (num passeio aleatório irregular, a interpolação linear com 8 trechos
+//     tirava 1/3 dos passos de ±5% da velocidade; o Hermite com 16, < 1%);
+//   - fechado: o último ponto liga no primeiro (o laço das trajetórias dos
+//     exercícios); aberto: pontos fantasmas refletidos nas pontas.
+// SplineFollowers anda com N objetos no mesmo caminho, em SoA.
+//
+// Sem GL: CameraTrajetoria e Vivencial2 desenham, o cg_bench mede.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class SplinePath {
+public:
+    // Reconstrói coeficientes e LUT: O(pontos * samplesPerSegment)
+    void build(const std::vector<glm::vec3>& points, bool closed, float alpha = 0.5f, int samplesPerSegment = 16)
+    {
+        isClosed = closed;
+        samples = std::max(1, samplesPerSegment);
+        a.clear();
+        b.clear();
+        c.clear();
+        d.clear();
+        lut.clear();
+        slope0.clear();
+        slope1.clear();
+        size_t n = points.size();
+        single = n == 1 ? points[0] : glm::vec3(0.0f);
+        if (n < 2) {
+            total = 0.0f;
+            return;
+        }
+
+        auto point = [&](long i) {
+            if (closed)
+                return points[(size_t)((i % (long)n + (long)n) % (long)n)];
+            if (i < 0)
+                return 2.0f * points[0] - points[1];
+            if (i >= (long)n)
+                return 2.0f * points[n - 1] - points[n - 2];
+            return points[(size_t)i];
+        };
+
+        size_t segments = closed ? n : n - 1;
+        a.resize(segments);
+        b.resize(segments);
+        c.resize(segments);
+        d.resize(segments);
+        for (size_t s = 0; s < segments; s++) {
+            glm::vec3 p0 = point((long)s - 1), p1 = point((long)s), p2 = point((long)s + 1), p3 = point((long)s + 2);
+            // Nós t_i = t_{i-1} + |P_i - P_{i-1}|^alpha; tangentes de Hermite escaladas para u ∈ [0, 1]
+            float t01 = knot(p0, p1, alpha), t12 = knot(p1, p2, alpha), t23 = knot(p2, p3, alpha);
+            glm::vec3 m1 = t12 * ((p1 - p0) / t01 - (p2 - p0) / (t01 + t12) + (p2 - p1) / t12);
+            glm::vec3 m2 = t12 * ((p2 - p1) / t12 - (p3 - p1) / (t12 + t23) + (p3 - p2) / t23);
+            a[s] = p1;
+            b[s] = m1;
+            c[s] = -3.0f * p1 + 3.0f * p2 - 2.0f * m1 - m2;
+            d[s] = 2.0f * p1 - 2.0f * p2 + m1 + m2;
+        }
+
+        size_t intervals = segments * samples;
+        lut.resize(intervals + 1);
+        slope0.resize(intervals);
+        slope1.resize(intervals);
+        lut[0] = 0.0f;
+        float acc = 0.0f, h = 1.0f / samples;
+        const float gx[3] = { 0.1127017f, 0.5f, 0.8872983f }, gw[3] = { 5.0f / 18.0f, 8.0f / 18.0f, 5.0f / 18.0f };
+        for (size_t s = 0; s < segments; s++) {
+            float v0 = speed(s, 0.0f);
+            for (int j = 0; j < samples; j++) {
+                size_t i = s * samples + j;
+                float u0 = j * h, span = 0.0f;
+                for (int g = 0; g < 3; g++)
+                    span += gw[g] * speed(s, u0 + gx[g] * h) * h;
+                acc += span;
+                lut[i + 1] = acc;
+                // df/dx nas pontas, com f = fração do trecho em u e x = fração em distância
+                float v1 = speed(s, u0 + h);
+                slope0[i] = hermiteSlope(span, v0 * h);
+                slope1[i] = hermiteSlope(span, v1 * h);
+                v0 = v1;
+            }
+        }
+        total = acc;
+    }
+
+    float length() const { return total; }
+    bool closed() const { return isClosed; }
+    int segmentCount() const { return (int)a.size(); }
+    bool empty() const { return a.empty(); }
+
+    // Distância no caminho: fechado dá a volta, aberto fica nas pontas
+    float wrap(float s) const
+    {
+        if (total <= 0.0f)
+            return 0.0f;
+        if (isClosed) {
+            s = std::fmod(s, total);
+            return s < 0.0f ? s + total : s;
+        }
+        return std::min(std::max(s, 0.0f), total);
+    }
+
+    // Posição a uma distância s (já dentro de [0, length()]); 'cursor' é a amostra da LUT da última chamada
+    glm::vec3 position(float s, uint32_t& cursor) const
+    {
+        if (a.empty())
+            return single;
+        size_t seg;
+        float u;
+        locate(s, cursor, seg, u);
+        return evaluate(seg, u);
+    }
+
+    // Sem cursor: busca binária na LUT inteira
+    glm::vec3 position(float s) const
+    {
+        uint32_t cursor = NO_CURSOR;
+        return position(s, cursor);
+    }
+
+    // Direção do movimento (derivada normalizada) na mesma distância
+    glm::vec3 tangent(float s, uint32_t& cursor) const
+    {
+        if (a.empty())
+            return glm::vec3(0.0f, 0.0f, -1.0f);
+        size_t seg;
+        float u;
+        locate(s, cursor, seg, u);
+        glm::vec3 t = derivative(seg, u);
+        float len = glm::length(t);
+        return len > 1e-6f ? t / len : glm::vec3(0.0f, 0.0f, -1.0f);
+    }
+
+    static constexpr uint32_t NO_CURSOR = 0xffffffffu;
+
+private:
+    bool isClosed = true;
+    int samples = 16;
+    float total = 0.0f;
+    glm::vec3 single = glm::vec3(0.0f);   // caminho de um ponto só
+    std::vector<glm::vec3> a, b, c, d;    // coeficientes por segmento
+    std::vector<float> lut;               // distância acumulada: segmento i / samples, u = (i % samples) / samples
+    std::vector<float> slope0, slope1;    // derivadas do Hermite u(s) nas pontas de cada trecho
+
+    static float knot(const glm::vec3& p, const glm::vec3& q, float alpha)
+    {
+        float dist = glm::length(q - p);
+        return std::max(std::pow(dist, alpha), 1e-4f); // pontos repetidos não dividem por zero
+    }
+
+    glm::vec3 evaluate(size_t seg, float u) const { return a[seg] + u * (b[seg] + u * (c[seg] + u * d[seg])); }
+    glm::vec3 derivative(size_t seg, float u) const { return b[seg] + u * (2.0f * c[seg] + 3.0f * u * d[seg]); }
+    float speed(size_t seg, float u) const { return glm::length(derivative(seg, u)); }
+
+    // span / (velocidade * h), em [0, 3] (Fritsch-Carlson: o Hermite não volta nem passa de 1)
+    static float hermiteSlope(float span, float localSpeed)
+    {
+        return localSpeed > 1e-8f ? std::min(span / localSpeed, 3.0f) : 3.0f;
+    }
+
+    // Amostra i com lut[i] <= s < lut[i+1]: alguns passos a partir do cursor, senão busca binária
+    void locate(float s, uint32_t& cursor, size_t& seg, float& u) const
+    {
+        uint32_t last = (uint32_t)lut.size() - 2; // última amostra que começa um trecho
+        uint32_t i = cursor;
+        bool found = false;
+        if (i <= last && s >= lut[i]) {
+            for (int step = 0; step < 4 && !found; step++) {
+                if (i >= last || s < lut[i + 1])
+                    found = true;
+                else
+                    i++;
+            }
+        }
+        if (!found) {
+            auto it = std::upper_bound(lut.begin(), lut.end(), s);
+            i = it == lut.begin() ? 0 : std::min((uint32_t)(it - lut.begin()) - 1, last);
+        }
+        cursor = i;
+        float span = lut[i + 1] - lut[i];
+        float x = span > 0.0f ? std::min(std::max((s - lut[i]) / span, 0.0f), 1.0f) : 0.0f;
+        // Hermite com f(0) = 0, f(1) = 1 e as derivadas guardadas
+        float x2 = x * x, x3 = x2 * x;
+        float f = (-2.0f * x3 + 3.0f * x2) + (x3 - 2.0f * x2 + x) * slope0[i] + (x3 - x2) * slope1[i];
+        seg = i / samples;
+        u = ((i % samples) + f) / samples;
+    }
+};
+
+// N objetos andando no mesmo caminho, cada um com distância, velocidade e cursor próprios
+class SplineFollowers {
+public:
+    void resize(size_t n)
+    {
+        distance.resize(n, 0.0f);
+        speed.resize(n, 1.0f);
+        cursor.resize(n, SplinePath::NO_CURSOR);
+        position.resize(n, glm::vec3(0.0f));
+    }
+
+    size_t size() const { return distance.size(); }
+
+    // Caminho trocado (build de novo): as distâncias continuam, os cursores não valem mais
+    void resetCursors() { std::fill(cursor.begin(), cursor.end(), SplinePath::NO_CURSOR); }
+
+    // Objetos [begin, end): avança 'speed * dt' e recalcula a posição
+    void update(const SplinePath& path, float dt, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++) {
+            distance[i] = path.wrap(distance[i] + speed[i] * dt);
+            position[i] = path.position(distance[i], cursor[i]);
+        }
+    }
+    void update(const SplinePath& path, float dt) { update(path, dt, 0, size()); }
+
+    std::vector<float> distance, speed;
+    std::vector<uint32_t> cursor;
+    std::vector<glm::vec3> position;
+};
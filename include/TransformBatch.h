@@ -0,0 +1,358 @@
+#pragma once
+
+// ============== TRANSFORMAÇÕES EM LOTE (SIMD) ==============
+// Monta as matrizes de muitos objetos de uma vez a partir de componentes em
+// SoA (posição, rotação como quaternion unitário e escala), no lugar de
+// encadear glm::translate/rotate/scale objeto a objeto:
+//   model  = T(pos) * R(quat) * S(escala)   (o mesmo que glm::translate *
+//            glm::mat4_cast * glm::scale)
+//   mvp    = viewProj * model
+//   normal = transposta da inversa de mat3(model) = R * S^-1 (sem inversa
+//            genérica: a rotação é ortonormal)
+//
+// Kernels: escalar (qualquer CPU), SSE (4 objetos por vez, base do x86-64)
+// e AVX2 (8 por vez). O melhor suportado pela CPU é escolhido em tempo
+// de execução; o AVX2 é compilado com atributo de alvo, sem exigir -mavx2 no
+// resto do programa. Cada lane calcula um objeto; as colunas saem das lanes
+// com uma transposição 4x4 (4x8 no AVX) e vão direto para os mat4.
+// Os três fazem as mesmas operações na mesma ordem, sem FMA (mul e add
+// separados; a normal multiplica pelo 1/escala): dão os mesmos bits, então
+// o rebanho não muda com o kernel escolhido. Em relação ao glm só o
+// arredondamento difere; o cg_bench confere as duas coisas em ulps.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TRANSFORMBATCH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TRANSFORMBATCH_AVX2_TARGET
+#else
+#define TRANSFORMBATCH_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+enum class TransformKernel { Auto, Scalar, Sse, Avx2 };
+
+// Componentes de entrada, um vetor por campo (índice = objeto)
+struct TransformSoA {
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> rotX, rotY, rotZ, rotW; // quaternion unitário (x, y, z, w)
+    std::vector<float> scaleX, scaleY, scaleZ;
+
+    // Novos objetos: origem, sem rotação, escala 1
+    void resize(size_t n)
+    {
+        for (std::vector<float>* v : { &posX, &posY, &posZ, &rotX, &rotY, &rotZ })
+            v->resize(n, 0.0f);
+        for (std::vector<float>* v : { &rotW, &scaleX, &scaleY, &scaleZ })
+            v->resize(n, 1.0f);
+    }
+
+    size_t size() const { return posX.size(); }
+
+    void setPosition(size_t i, const glm::vec3& p)
+    {
+        posX[i] = p.x;
+        posY[i] = p.y;
+        posZ[i] = p.z;
+    }
+
+    // Quaternion em glm::vec4 (x, y, z, w), para não depender de gtc/quaternion
+    void setRotation(size_t i, const glm::vec4& q)
+    {
+        rotX[i] = q.x;
+        rotY[i] = q.y;
+        rotZ[i] = q.z;
+        rotW[i] = q.w;
+    }
+
+    void setScale(size_t i, const glm::vec3& s)
+    {
+        scaleX[i] = s.x;
+        scaleY[i] = s.y;
+        scaleZ[i] = s.z;
+    }
+};
+
+// Rotação de 'angle' radianos em torno do eixo unitário 'axis', como glm::angleAxis
+inline glm::vec4 axisAngleQuat(float angle, const glm::vec3& axis)
+{
+    float s = std::sin(angle * 0.5f);
+    return glm::vec4(axis * s, std::cos(angle * 0.5f));
+}
+
+// Destinos indexados como a entrada (nullptr: não calcula)
+struct TransformOutputs {
+    glm::mat4* model = nullptr;
+    glm::mat4* mvp = nullptr; // usa viewProj
+    glm::mat3* normal = nullptr;
+    glm::mat4 viewProj = glm::mat4(1.0f);
+};
+
+// ==== DETECÇÃO DA CPU ====
+inline bool transformKernelSupported(TransformKernel k)
+{
+    switch (k) {
+    case TransformKernel::Auto:
+    case TransformKernel::Scalar:
+        return true;
+#if defined(TRANSFORMBATCH_X86)
+    case TransformKernel::Sse:
+        return true;
+    case TransformKernel::Avx2: {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int r[4];
+        __cpuid(r, 1);
+        bool osxsave = (r[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 6) != 6) // SO salva os registradores YMM
+            return false;
+        __cpuidex(r, 7, 0);
+        return (r[1] & (1 << 5)) != 0;
+#else
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+#endif
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+inline TransformKernel bestTransformKernel()
+{
+    static const TransformKernel best = transformKernelSupported(TransformKernel::Avx2)  ? TransformKernel::Avx2
+                                        : transformKernelSupported(TransformKernel::Sse) ? TransformKernel::Sse
+                                                                                         : TransformKernel::Scalar;
+    return best;
+}
+
+inline const char* transformKernelName(TransformKernel k)
+{
+    switch (k) {
+    case TransformKernel::Scalar:
+        return "escalar";
+    case TransformKernel::Sse:
+        return "sse";
+    case TransformKernel::Avx2:
+        return "avx2";
+    default:
+        return transformKernelName(bestTransformKernel());
+    }
+}
+
+// ==== KERNEL ESCALAR ====
+// Também termina as sobras dos kernels SIMD
+inline void transformBatchScalar(const TransformSoA& in, size_t begin, size_t end, const TransformOutputs& out)
+{
+    const glm::mat4& vp = out.viewProj;
+    for (size_t i = begin; i < end; i++) {
+        float x = in.rotX[i], y = in.rotY[i], z = in.rotZ[i], w = in.rotW[i];
+        float xx = x * x, yy = y * y, zz = z * z, xy = x * y, xz = x * z, yz = y * z, wx = w * x, wy = w * y,
+              wz = w * z;
+        glm::vec3 r0(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy));
+        glm::vec3 r1(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx));
+        glm::vec3 r2(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy));
+        glm::vec3 s(in.scaleX[i], in.scaleY[i], in.scaleZ[i]);
+        glm::mat4 m(glm::vec4(r0 * s.x, 0.0f), glm::vec4(r1 * s.y, 0.0f), glm::vec4(r2 * s.z, 0.0f),
+                    glm::vec4(in.posX[i], in.posY[i], in.posZ[i], 1.0f));
+        if (out.model)
+            out.model[i] = m;
+        if (out.mvp)
+            out.mvp[i] = vp * m;
+        if (out.normal)
+            out.normal[i] = glm::mat3(r0 * (1.0f / s.x), r1 * (1.0f / s.y), r2 * (1.0f / s.z));
+    }
+}
+
+#if defined(TRANSFORMBATCH_X86)
+// ==== KERNEL SSE (4 OBJETOS) ====
+// Linhas a..d = componentes 0..3 de uma coluna nas 4 lanes; grava a coluna 'c' de 4 mat4 seguidos
+inline void transformStoreColumns4(glm::mat4* dst, int c, __m128 a, __m128 b, __m128 d2, __m128 d3)
+{
+    _MM_TRANSPOSE4_PS(a, b, d2, d3);
+    _mm_storeu_ps(&dst[0][c][0], a);
+    _mm_storeu_ps(&dst[1][c][0], b);
+    _mm_storeu_ps(&dst[2][c][0], d2);
+    _mm_storeu_ps(&dst[3][c][0], d3);
+}
+
+inline void transformBatchSse(const TransformSoA& in, size_t begin, size_t end, const TransformOutputs& out)
+{
+    const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+    __m128 vp[4][4];
+    for (int c = 0; c < 4; c++)
+        for (int r = 0; r < 4; r++)
+            vp[c][r] = _mm_set1_ps(out.viewProj[c][r]);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_loadu_ps(&in.rotX[i]), y = _mm_loadu_ps(&in.rotY[i]), z = _mm_loadu_ps(&in.rotZ[i]),
+               w = _mm_loadu_ps(&in.rotW[i]);
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+        // r[c][k]: linha k da coluna c da rotação
+        __m128 r[3][3] = {
+            { _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), _mm_mul_ps(two, _mm_add_ps(xy, wz)),
+              _mm_mul_ps(two, _mm_sub_ps(xz, wy)) },
+            { _mm_mul_ps(two, _mm_sub_ps(xy, wz)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))),
+              _mm_mul_ps(two, _mm_add_ps(yz, wx)) },
+            { _mm_mul_ps(two, _mm_add_ps(xz, wy)), _mm_mul_ps(two, _mm_sub_ps(yz, wx)),
+              _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))) },
+        };
+        __m128 s[3] = { _mm_loadu_ps(&in.scaleX[i]), _mm_loadu_ps(&in.scaleY[i]), _mm_loadu_ps(&in.scaleZ[i]) };
+        __m128 m[4][4];
+        for (int c = 0; c < 3; c++) {
+            for (int k = 0; k < 3; k++)
+                m[c][k] = _mm_mul_ps(r[c][k], s[c]);
+            m[c][3] = zero;
+        }
+        m[3][0] = _mm_loadu_ps(&in.posX[i]);
+        m[3][1] = _mm_loadu_ps(&in.posY[i]);
+        m[3][2] = _mm_loadu_ps(&in.posZ[i]);
+        m[3][3] = one;
+
+        if (out.model)
+            for (int c = 0; c < 4; c++)
+                transformStoreColumns4(out.model + i, c, m[c][0], m[c][1], m[c][2], m[c][3]);
+        if (out.mvp) {
+            for (int c = 0; c < 4; c++) {
+                __m128 col[4];
+                for (int k = 0; k < 4; k++) {
+                    __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vp[0][k], m[c][0]), _mm_mul_ps(vp[1][k], m[c][1])),
+                                          _mm_mul_ps(vp[2][k], m[c][2]));
+                    col[k] = c == 3 ? _mm_add_ps(v, vp[3][k]) : v;
+                }
+                transformStoreColumns4(out.mvp + i, c, col[0], col[1], col[2], col[3]);
+            }
+        }
+        if (out.normal) {
+            alignas(16) float lanes[9][4];
+            for (int c = 0; c < 3; c++) {
+                __m128 inv = _mm_div_ps(one, s[c]);
+                for (int k = 0; k < 3; k++)
+                    _mm_store_ps(lanes[c * 3 + k], _mm_mul_ps(r[c][k], inv));
+            }
+            for (int j = 0; j < 4; j++)
+                for (int e = 0; e < 9; e++)
+                    out.normal[i + j][e / 3][e % 3] = lanes[e][j];
+        }
+    }
+    transformBatchScalar(in, i, end, out);
+}
+
+// ==== KERNEL AVX2 (8 OBJETOS) ====
+TRANSFORMBATCH_AVX2_TARGET inline void transformStoreColumns8(glm::mat4* dst, int c, __m256 a, __m256 b, __m256 d2,
+                                                               __m256 d3)
+{
+    __m256 t0 = _mm256_unpacklo_ps(a, b), t1 = _mm256_unpackhi_ps(a, b);
+    __m256 t2 = _mm256_unpacklo_ps(d2, d3), t3 = _mm256_unpackhi_ps(d2, d3);
+    // Metade baixa: objetos 0..3; alta: 4..7
+    __m256 o0 = _mm256_shuffle_ps(t0, t2, 0x44), o1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    __m256 o2 = _mm256_shuffle_ps(t1, t3, 0x44), o3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    _mm_storeu_ps(&dst[0][c][0], _mm256_castps256_ps128(o0));
+    _mm_storeu_ps(&dst[1][c][0], _mm256_castps256_ps128(o1));
+    _mm_storeu_ps(&dst[2][c][0], _mm256_castps256_ps128(o2));
+    _mm_storeu_ps(&dst[3][c][0], _mm256_castps256_ps128(o3));
+    _mm_storeu_ps(&dst[4][c][0], _mm256_extractf128_ps(o0, 1));
+    _mm_storeu_ps(&dst[5][c][0], _mm256_extractf128_ps(o1, 1));
+    _mm_storeu_ps(&dst[6][c][0], _mm256_extractf128_ps(o2, 1));
+    _mm_storeu_ps(&dst[7][c][0], _mm256_extractf128_ps(o3, 1));
+}
+
+TRANSFORMBATCH_AVX2_TARGET inline void transformBatchAvx2(const TransformSoA& in, size_t begin, size_t end,
+                                                          const TransformOutputs& out)
+{
+    const __m256 one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f), zero = _mm256_setzero_ps();
+    __m256 vp[4][4];
+    for (int c = 0; c < 4; c++)
+        for (int r = 0; r < 4; r++)
+            vp[c][r] = _mm256_set1_ps(out.viewProj[c][r]);
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 x = _mm256_loadu_ps(&in.rotX[i]), y = _mm256_loadu_ps(&in.rotY[i]), z = _mm256_loadu_ps(&in.rotZ[i]),
+               w = _mm256_loadu_ps(&in.rotW[i]);
+        __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+        __m256 r[3][3] = {
+            { _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), _mm256_mul_ps(two, _mm256_add_ps(xy, wz)),
+              _mm256_mul_ps(two, _mm256_sub_ps(xz, wy)) },
+            { _mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))),
+              _mm256_mul_ps(two, _mm256_add_ps(yz, wx)) },
+            { _mm256_mul_ps(two, _mm256_add_ps(xz, wy)), _mm256_mul_ps(two, _mm256_sub_ps(yz, wx)),
+              _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))) },
+        };
+        __m256 s[3] = { _mm256_loadu_ps(&in.scaleX[i]), _mm256_loadu_ps(&in.scaleY[i]), _mm256_loadu_ps(&in.scaleZ[i]) };
+        __m256 m[4][4];
+        for (int c = 0; c < 3; c++) {
+            for (int k = 0; k < 3; k++)
+                m[c][k] = _mm256_mul_ps(r[c][k], s[c]);
+            m[c][3] = zero;
+        }
+        m[3][0] = _mm256_loadu_ps(&in.posX[i]);
+        m[3][1] = _mm256_loadu_ps(&in.posY[i]);
+        m[3][2] = _mm256_loadu_ps(&in.posZ[i]);
+        m[3][3] = one;
+
+        if (out.model)
+            for (int c = 0; c < 4; c++)
+                transformStoreColumns8(out.model + i, c, m[c][0], m[c][1], m[c][2], m[c][3]);
+        if (out.mvp) {
+            for (int c = 0; c < 4; c++) {
+                __m256 col[4];
+                for (int k = 0; k < 4; k++) {
+                    __m256 v = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vp[0][k], m[c][0]), _mm256_mul_ps(vp[1][k], m[c][1])),
+                                             _mm256_mul_ps(vp[2][k], m[c][2]));
+                    col[k] = c == 3 ? _mm256_add_ps(v, vp[3][k]) : v;
+                }
+                transformStoreColumns8(out.mvp + i, c, col[0], col[1], col[2], col[3]);
+            }
+        }
+        if (out.normal) {
+            alignas(32) float lanes[9][8];
+            for (int c = 0; c < 3; c++) {
+                __m256 inv = _mm256_div_ps(one, s[c]);
+                for (int k = 0; k < 3; k++)
+                    _mm256_store_ps(lanes[c * 3 + k], _mm256_mul_ps(r[c][k], inv));
+            }
+            for (int j = 0; j < 8; j++)
+                for (int e = 0; e < 9; e++)
+                    out.normal[i + j][e / 3][e % 3] = lanes[e][j];
+        }
+    }
+    transformBatchScalar(in, i, end, out);
+}
+#endif
+
+// ==== ENTRADA ====
+// Objetos [begin, end) de 'in'; um kernel não suportado cai no melhor disponível
+inline void transformBatch(const TransformSoA& in, size_t begin, size_t end, const TransformOutputs& out,
+                           TransformKernel kernel = TransformKernel::Auto)
+{
+    end = std::min(end, in.size());
+    if (begin >= end)
+        return;
+    if (kernel == TransformKernel::Auto || !transformKernelSupported(kernel))
+        kernel = bestTransformKernel();
+#if defined(TRANSFORMBATCH_X86)
+    if (kernel == TransformKernel::Avx2) {
+        transformBatchAvx2(in, begin, end, out);
+        return;
+    }
+    if (kernel == TransformKernel::Sse) {
+        transformBatchSse(in, begin, end, out);
+        return;
+    }
+#endif
+    transformBatchScalar(in, begin, end, out);
+}
@@ -15,6 +15,14 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <Headless.h>
+
+#include <ShaderManager.h>
+#include <Camera.h>
+#include <Input.h>
+#include <SplinePath.h>
+
 using namespace std;
 using namespace glm;
 
@@ -34,59 +42,21 @@ GLuint shaderProgram, VAO, VBO, textureID;
 vec3 ka(0.1f), kd(1.0f), ks(0.5f);
 float shininess = 32.0f;
 
-// Trajetória
+// Trajetória: spline fechada pelos pontos, percorrida com velocidade constante
 vector<vec3> trajectoryPoints;
-int currentPointIndex = 0;
+SplinePath trajectory;
+float trajectoryDistance = 0.0f; // distância percorrida no caminho
+uint32_t trajectoryCursor = SplinePath::NO_CURSOR;
 float moveSpeed = 1.0f;
 vec3 objectPos(0.0f);
 
-// Camera
-class Camera {
-public:
-    vec3 position, front, up, right, worldUp;
-    float yaw, pitch, speed, sensitivity;
-
-    Camera(vec3 pos) : position(pos), worldUp(0.0f, 1.0f, 0.0f), yaw(-90.0f), pitch(0.0f), speed(2.5f), sensitivity(0.1f) {
-        updateCameraVectors();
-    }
-
-    mat4 GetViewMatrix() {
-        return lookAt(position, position + front, up);
-    }
-
-    void Move(string dir, float deltaTime) {
-        float velocity = speed * deltaTime;
-        if (dir == "FORWARD")  position += front * velocity;
-        if (dir == "BACKWARD") position -= front * velocity;
-        if (dir == "LEFT")     position -= right * velocity;
-        if (dir == "RIGHT")    position += right * velocity;
-    }
-
-    void Rotate(float xoffset, float yoffset) {
-        xoffset *= sensitivity;
-        yoffset *= sensitivity;
-        yaw += xoffset;
-        pitch += yoffset;
-        pitch = clamp(pitch, -89.0f, 89.0f);
-        updateCameraVectors();
-    }
-
-private:
-    void updateCameraVectors() {
-        vec3 f;
-        f.x = cos(radians(yaw)) * cos(radians(pitch));
-        f.y = sin(radians(pitch));
-        f.z = sin(radians(yaw)) * cos(radians(pitch));
-        front = normalize(f);
-        right = normalize(cross(front, worldUp));
-        up = normalize(cross(right, front));
-    }
-};
-
 Camera camera(vec3(0.0f, 0.0f, 5.0f));
 float deltaTime = 0.0f, lastFrame = 0.0f;
-float lastX = 400.0f, lastY = 300.0f;
-bool firstMouse = true;
+
+// WASD seguradas; P adiciona um ponto à trajetória a cada pressionamento
+enum class Acao { Frente, Tras, Esquerda, Direita, AdicionarPonto, Count };
+InputSystem<Acao> input;
+InputLatency latencia;
 
 const char* vertexShaderSource = R"(
 #version 450 core
@@ -137,22 +107,6 @@ void main() {
     FragColor = vec4(result, 1.0);
 })";
 
-GLuint compileShader() {
-    GLuint vShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vShader);
-    GLuint fShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fShader);
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vShader);
-    glAttachShader(program, fShader);
-    glLinkProgram(program);
-    glDeleteShader(vShader);
-    glDeleteShader(fShader);
-    return program;
-}
-
 GLuint loadTexture(const string& path) {
     int w, h, ch;
     unsigned char* data = stbi_load(path.c_str(), &w, &h, &ch, 0);
@@ -247,62 +201,67 @@ void setupBuffers() {
 
 void updateTrajectory(float deltaTime) {
     if (trajectoryPoints.empty()) return;
-    vec3 target = trajectoryPoints[currentPointIndex];
-    vec3 direction = normalize(target - objectPos);
-    float distance = length(target - objectPos);
-    float step = moveSpeed * deltaTime;
-
-    if (step >= distance) {
-        objectPos = target;
-        currentPointIndex = (currentPointIndex + 1) % trajectoryPoints.size();
-    } else {
-        objectPos += direction * step;
-    }
+    trajectoryDistance = trajectory.wrap(trajectoryDistance + moveSpeed * deltaTime);
+    objectPos = trajectory.position(trajectoryDistance, trajectoryCursor);
 }
 
-void mouse_callback(GLFWwindow*, double xpos, double ypos) {
-    if (firstMouse) { lastX = xpos; lastY = ypos; firstMouse = false; }
-    float xoffset = xpos - lastX;
-    float yoffset = lastY - ypos;
-    lastX = xpos;
-    lastY = ypos;
-    camera.Rotate(xoffset, yoffset);
+// Ponto novo: refaz a spline (coeficientes e tabela de comprimento de arco)
+void addTrajectoryPoint(const vec3& point) {
+    trajectoryPoints.push_back(point);
+    trajectory.build(trajectoryPoints, true);
+    trajectoryCursor = SplinePath::NO_CURSOR;
 }
 
-void processInput(GLFWwindow* window) {
+void processInput() {
     float currentFrame = glfwGetTime();
     deltaTime = currentFrame - lastFrame;
     lastFrame = currentFrame;
 
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) camera.Move("FORWARD", deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) camera.Move("BACKWARD", deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) camera.Move("LEFT", deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) camera.Move("RIGHT", deltaTime);
+    if (input.down(Acao::Frente)) camera.Move(CameraMovement::Forward, deltaTime);
+    if (input.down(Acao::Tras)) camera.Move(CameraMovement::Backward, deltaTime);
+    if (input.down(Acao::Esquerda)) camera.Move(CameraMovement::Left, deltaTime);
+    if (input.down(Acao::Direita)) camera.Move(CameraMovement::Right, deltaTime);
 
-    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) {
+    // Um ponto por pressionamento, sem travar o frame esperando a tecla soltar
+    while (input.pressed(Acao::AdicionarPonto)) {
         vec3 point = camera.position + camera.front * 3.0f; // ponto à frente da câmera
-        trajectoryPoints.push_back(point);
+        addTrajectoryPoint(point);
         cout << "Ponto adicionado: " << to_string(point) << endl;
-        glfwWaitEventsTimeout(0.2);
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    Headless headless(argc, argv);
+    headless.initHints();
     glfwInit();
+    headless.windowHints();
     GLFWwindow* window = glfwCreateWindow(800, 600, "Phong + Camera + Trajetoria", nullptr, nullptr);
-    glfwMakeContextCurrent(window);
-    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    headless.makeCurrent(window);
+    gladLoadGLLoader(headless.loader());
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-    glfwSetCursorPosCallback(window, mouse_callback);
+    input.attach(window);
+    input.bind(GLFW_KEY_W, Acao::Frente);
+    input.bind(GLFW_KEY_S, Acao::Tras);
+    input.bind(GLFW_KEY_A, Acao::Esquerda);
+    input.bind(GLFW_KEY_D, Acao::Direita);
+    input.bind(GLFW_KEY_P, Acao::AdicionarPonto);
+    latencia.init();
     glEnable(GL_DEPTH_TEST);
 
-    shaderProgram = compileShader();
+    // Compila em paralelo com o carregamento do modelo
+    ShaderManager shaders;
+    shaders.init(headless.loader());
+    int programa = shaders.add("trajetoria", vertexShaderSource, fragmentShaderSource);
     if (!loadOBJWithMTL("../assets/Modelos3D/Cube.obj", "../assets/Modelos3D")) {
         cerr << "Erro ao carregar modelo." << endl;
         return -1;
     }
 
+    shaders.waitAll();
+    shaderProgram = shaders.program(programa);
+    shaders.report();
+
     setupBuffers();
     glUseProgram(shaderProgram);
     glUniform1i(glGetUniformLocation(shaderProgram, "texBuff"), 0);
@@ -310,15 +269,20 @@ int main() {
     mat4 projection = perspective(radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
 
     while (!glfwWindowShouldClose(window)) {
-        processInput(window);
-        updateTrajectory(deltaTime);
         glfwPollEvents();
+        processInput();
+        latencia.poll();
+        updateTrajectory(deltaTime);
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         float angle = (float)glfwGetTime();
         mat4 model = translate(mat4(1.0f), objectPos);
         model = rotate(model, angle, vec3(1, 1, 0));
+        // Late latch: o mouse mais recente entra na view logo antes de desenhar
+        input.latch();
+        vec2 giro = input.takeMouseDelta();
+        camera.Rotate(giro.x, giro.y);
         mat4 view = camera.GetViewMatrix();
 
         glUseProgram(shaderProgram);
@@ -346,9 +310,12 @@ int main() {
             glDrawArrays(GL_TRIANGLES, 0, vertices.size());
         }
 
-        glfwSwapBuffers(window);
+        latencia.submitted(input.takeFrameInputTime(), input.lastLatchTime());
+        headless.swapBuffers(window);
     }
 
+    latencia.printSummary();
+    latencia.release();
     glfwTerminate();
     return 0;
 }
@@ -16,6 +16,28 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <OcclusionCulling.h>
+#include <ShaderCache.h>
+#include <ShaderManager.h>
+#include <FrameGraph.h>
+#include <ClusteredLighting.h>
+#include <ShadowMap.h>
+#include <FixedTimestep.h>
+#include <Config.h>
+#include <Camera.h>
+#include <Input.h>
+#include <ObjLoader.h>
+#include <Profiler.h>
+#include <Animation.h>
+#include <Herd.h>
+#include <JobSystem.h>
+#include <SceneGraph.h>
+#include <GpuParticles.h>
+#include <RenderThread.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <Headless.h>
+
 using namespace std;
 using namespace glm;
 
@@ -23,27 +45,15 @@ using namespace glm;
 #include <algorithm>
 #include <unordered_map>
 #include <cctype>
-
-map<string, string> config;
-
-struct Vertex {
-    vec3 position;
-    vec2 texCoord;
-    vec3 normal;
-};
-
-struct Material {
-    vec3 ka = vec3(0.1f);
-    vec3 kd = vec3(1.0f);
-    vec3 ks = vec3(0.5f);
-    float shininess = 32.0f;
-};
+#include <atomic>
+#include <thread>
 
 struct Submesh {
     vector<Vertex> vertices;
     GLuint VAO, VBO, textureID;
     int vertexCount;
     Material material;
+    int no = 0; // nó do grafo do modelo (objeto "o" do OBJ)
 };
 
 struct Modelo {
@@ -51,150 +61,175 @@ struct Modelo {
     int vertexCount = 0;
     Material material;
     std::vector<Submesh> partes;
+    vec3 aabbMin = vec3(0.0f), aabbMax = vec3(0.0f); // em espaço de objeto
+    SceneGraph grafo;   // raiz (o arquivo) + um filho por objeto "o"
+    vector<vec3> pivos; // centro da AABB de cada nó: eixo dos giros das partes
 };
 
 vec3 ka(0.1f), kd(1.0f), ks(0.5f);
 float shininess = 32.0f;
-vec3 lightColor;
-vec3 lightPos;
 GLuint shaderProgram;
 Modelo ovni, vaca, casa, chao;
 GLuint skyboxTexture, quadVAO;
 GLuint skyboxShader;
 
-// ============== CONFIGURATION LOADER ==============
-void loadConfig(const string& filename) {
-    ifstream file(filename);
-    string line;
-    string section;
-    while (getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
-
-        if (line[0] == '[') {
-            section = line.substr(1, line.find(']') - 1);
-            continue;
-        }
-
-        size_t eq = line.find('=');
-        if (eq == string::npos) continue;
-
-        string key = line.substr(0, eq);
-        string value = line.substr(eq + 1);
-
-        string fullKey = section.empty() ? key : section + "." + key;
-        config[fullKey] = value;
-    }
-}
+// Occlusion culling em CPU (casa e chão como oclusores)
+OcclusionCuller occlusion;
+bool occlusionAtiva = true;
+bool mostrarOclusao = false;
+GLuint occlusionDebugTex, occlusionDebugShader;
+
+ShaderCache shaderCache;
+ShaderManager shaderManager;
+int progPrincipal, progCeu, progOclusao, progClustered; // handles no shaderManager
+int progGBuffer, progDeferredSpot, progDeferredLuzes, progSombra, progParticulas;
+int progParticulasAtualizar, progParticulasPrefixo, progParticulasCompactar;
+
+// Clustered forward lighting: demo com centenas de luzes orbitando a vaca
+ClusterGrid clusters;
+vector<ClusterLight> luzesDemo;
+bool demoLuzes = false;
+GLuint clusteredShader;
+GLuint programaCena; // programa usado pelo pass "cena" neste frame
+
+// Renderer deferred, alternativo ao forward (tecla G ou renderer.modo = deferred)
+bool deferred = false;
+bool imprimirTempos = false;
+GLuint gbufferShader, deferredSpotShader, deferredLuzesShader;
+
+// Sombra do spotlight com cache das camadas estática/dinâmica (tecla K liga/desliga o cache)
+SpotShadowMap sombraSpot;
+bool sombraAtiva = true;
+bool alternarCacheSombra = false;
+GLuint sombraShader;
+
+// Partículas do raio trator: na GPU (compute + draw indireto) ou no fallback em CPU
+GpuParticles particulasGpu;
+CpuParticles particulasCpu;
+BeamEmitter raio;
+bool particulasAtivas = false, particulasNaGpu = false;
+GLuint particulasShader, particulasVAO = 0, particulasVBO = 0;
+double particulasCpuMs = 0.0, particulasEnvioMs = 0.0; // somados pelo render, a partir dos pacotes
+int particulasFrames = 0;
+size_t particulasVivasCpu = 0;
+
+// Profiler: P grava o trace (chrome://tracing / Perfetto) com os últimos frames
+bool gravarTrace = false;
+// F12: exporta as estatísticas de frame; com a thread de render o pedido vai no pacote
+bool exportarEstatisticas = false;
+
+bool casaLuz = true; // estado_inicial.casa_luz, lido depois do loadConfig
+
+// config.ini tipado: snapshot do frame e recarga em segundo plano
+SettingsSnapshot cfg;
+ConfigWatcher configWatcher;
 
-float getFloat(const string& key, float def) {
-    return config.count(key) ? stof(config[key]) : def;
-}
+Camera camera(vec3(0.0f, 1.5f, 10.0f));
+float deltaTime = 0.0f; // duração do frame (real ou --dt), usada pela câmera
+
+// ============== ENTRADA ==============
+// WASD seguradas movem a câmera; as demais são toggles por pressionamento
+enum class Acao {
+    Frente, Tras, Esquerda, Direita,
+    LuzCasa,      // H
+    Oclusao,      // O: mostra o buffer de oclusão
+    Renderer,     // G: forward <-> deferred
+    TemposGpu,    // T: imprime os tempos de GPU por pass e a latência de entrada
+    CacheSombra,  // K
+    Trace,        // P: grava o trace do profiler
+    Estatisticas, // F12: exporta as estatísticas de frame (FrameStats.h)
+    DemoLuzes,    // L
+    MaisLuzes,    // +
+    MenosLuzes,   // -
+    Count
+};
+InputSystem<Acao> input;
+InputLatency latencia;
+
+// ============== ESTADO DA SIMULAÇÃO ==============
+// A abdução são clips de keyframes (animacao.arquivo, Animation.h): a cada passo
+// fixo o player avança e a pose vira o estado; o frame desenha a interpolação
+// entre o passo anterior e o atual
+AnimationLibrary animacoes;
+AbductionClips clipsAbducao;
+
+struct EstadoSim {
+    float ovniY, vacaY;
+    vec3 vacaDesloc; // balanço da subida e oito no alto
+    quat vacaRot;    // giro da queda
+    float tempo;     // tempo simulado (giro do ovni, luzes da demo)
+};
 
-vec3 getVec3(const string& key, vec3 def) {
-    if (!config.count(key)) return def;
-    stringstream ss(config[key]);
-    float x, y, z;
-    char sep; // ignora vírgulas
-    ss >> x >> sep >> y >> sep >> z;
-    return vec3(x, y, z);
+EstadoSim poseParaEstado(const AnimationPose& pose, float tempo) {
+    EstadoSim e;
+    e.ovniY = pose.floats[clipsAbducao.ufoY];
+    e.vacaY = pose.floats[clipsAbducao.cowY];
+    e.vacaDesloc = pose.vec3s[clipsAbducao.cowOffset];
+    e.vacaRot = pose.quats[clipsAbducao.cowRot];
+    e.tempo = tempo;
+    return e;
 }
 
-string getString(const string& key, const string& def) {
-    return config.count(key) ? config[key] : def;
+EstadoSim interpolar(const EstadoSim& a, const EstadoSim& b, float alpha) {
+    EstadoSim e;
+    e.ovniY = mix(a.ovniY, b.ovniY, alpha);
+    e.vacaY = mix(a.vacaY, b.vacaY, alpha);
+    e.vacaDesloc = mix(a.vacaDesloc, b.vacaDesloc, alpha);
+    e.vacaRot = slerp(a.vacaRot, b.vacaRot, alpha);
+    e.tempo = mix(a.tempo, b.tempo, alpha);
+    return e;
 }
 
-bool getBool(const std::string& key, bool def) {
-    if (config.count(key) == 0) return def;
-
-    std::string val = config[key];
-    std::transform(val.begin(), val.end(), val.begin(), ::tolower);
-
-    return (val == "true");
-}
-
-bool casaLuz = getFloat("estado_inicial.casa_luz", true);
-
-// ============== CAMERA ==============
-class Camera
-{
-public:
-    vec3 position, front, up, right, worldUp;
-    float yaw, pitch, speed, sensitivity;
-
-    Camera(vec3 pos) : position(pos), worldUp(0.0f, 1.0f, 0.0f), yaw(-90.0f), pitch(0.0f), speed(2.5f), sensitivity(0.1f)
-    {
-        updateCameraVectors();
-    }
-
-    mat4 GetViewMatrix()
-    {
-        return lookAt(position, position + front, up);
-    }
-
-    void Move(string dir, float deltaTime)
-    {
-        float velocity = speed * deltaTime;
-        if (dir == "FORWARD")
-            position += front * velocity;
-        if (dir == "BACKWARD")
-            position -= front * velocity;
-        if (dir == "LEFT")
-            position -= right * velocity;
-        if (dir == "RIGHT")
-            position += right * velocity;
-    }
-
-    void Rotate(float xoffset, float yoffset)
-    {
-        xoffset *= sensitivity;
-        yoffset *= sensitivity;
-        yaw += xoffset;
-        pitch += yoffset;
-        pitch = glm::clamp(pitch, -89.0f, 89.0f);
-        updateCameraVectors();
-    }
-
-private:
-    void updateCameraVectors()
-    {
-        vec3 f;
-        f.x = cos(radians(yaw)) * cos(radians(pitch));
-        f.y = sin(radians(pitch));
-        f.z = sin(radians(yaw)) * cos(radians(pitch));
-        front = normalize(f);
-        right = normalize(cross(front, worldUp));
-        up = normalize(cross(right, front));
-    }
-};
-
-Camera camera(vec3(0.0f, 1.5f, 10.0f));
-float deltaTime = 0.0f, lastFrame = 0.0f;
-float lastX = 400.0f, lastY = 300.0f;
-
 // ============== SHADERS ==============
 const char *vertexShaderSource = R"(
     #version 450 core
     layout(location = 0) in vec3 position;
     layout(location = 1) in vec2 texCoord;
     layout(location = 2) in vec3 normal;
+    layout(location = 3) in mat4 instanceModel; // rebanho: uma matriz por instância
 
     out vec3 FragPos;
     out vec3 Normal;
     out vec2 TexCoord;
 
     uniform mat4 model; // transformações do objeto
+    uniform bool instanced; // desenho instanciado: instanceModel * model (model = nó da parte)
     uniform mat4 view; // câmera
     uniform mat4 projection; // perspectiva
 
     void main() {
-    FragPos = vec3(model * vec4(position, 1.0));
-    Normal = mat3(transpose(inverse(model))) * normal;
+    mat4 m = instanced ? instanceModel * model : model;
+    FragPos = vec3(m * vec4(position, 1.0));
+    Normal = mat3(transpose(inverse(m))) * normal;
     TexCoord = texCoord;
     gl_Position = projection * view * vec4(FragPos, 1.0);
 })";
 
-const char* fragmentShaderSource = R"(
-   #version 450 core
+// Sombra do spotlight (concatenada nos fragment shaders que iluminam com ele): 3x3 amostras com comparação (PCF)
+const string sombraComum = R"(
+    uniform sampler2DShadow shadowMap;
+    uniform mat4 lightSpace;
+    uniform bool sombraAtiva;
+
+    float sombra(vec3 pos) {
+    if (!sombraAtiva)
+        return 1.0;
+    vec4 p = lightSpace * vec4(pos, 1.0);
+    if (p.w <= 0.0)
+        return 1.0;
+    vec3 c = p.xyz / p.w * 0.5 + 0.5;
+    if (c.z >= 1.0)
+        return 1.0;
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0));
+    float soma = 0.0;
+    for (int x = -1; x <= 1; x++)
+        for (int y = -1; y <= 1; y++)
+            soma += texture(shadowMap, vec3(c.xy + vec2(x, y) * texel, c.z - 0.0005));
+    return soma / 9.0;
+    }
+)";
+
+const string fragmentShaderSource = "#version 450 core\n" + sombraComum + R"(
     in vec3 FragPos;
     in vec3 Normal;
     in vec2 TexCoord;
@@ -221,7 +256,7 @@ const char* fragmentShaderSource = R"(
     float theta = dot(lightDirection, normalize(-lightDir)); // ângulo do cone spotlight
     float cutoff = 0.85; // ângulo central
     float outerCutoff = 0.70; // ângulo externo
-    float intensity = clamp((theta - outerCutoff) / (cutoff - outerCutoff), 0.0, 1.0);
+    float intensity = clamp((theta - outerCutoff) / (cutoff - outerCutoff), 0.0, 1.0) * sombra(FragPos);
 
     // Componente difusa (baseada no ângulo entre luz e normal)
     float diff = max(dot(norm, lightDirection), 0.0);
@@ -246,6 +281,270 @@ const char* fragmentShaderSource = R"(
     FragColor = vec4(result, 1.0);
 })";
 
+// Mesmo modelo do shader principal + as luzes do cluster do fragmento (SSBOs do ClusterGrid)
+const string fragmentShaderClustered = "#version 450 core\n" + sombraComum + R"(
+    in vec3 FragPos;
+    in vec3 Normal;
+    in vec2 TexCoord;
+
+    out vec4 FragColor;
+
+    uniform sampler2D texBuff;
+    uniform vec3 ka, kd, ks;
+    uniform float shininess;
+    uniform vec3 viewPos;
+    uniform mat4 view;
+
+    // luz do ovni
+    uniform vec3 lightPos;
+    uniform vec3 lightColor;
+    uniform vec3 lightDir;
+
+    struct Luz {
+        vec4 positionRadius;
+        vec4 colorType;    // w: 0 pontual, 1 spot
+        vec4 directionCos; // w: cos do ângulo externo
+        vec4 params;       // x: cos do ângulo interno
+    };
+    layout(std430, binding = 0) readonly buffer Luzes { Luz luzes[]; };
+    layout(std430, binding = 1) readonly buffer Clusters { uvec2 clusters[]; }; // (offset, quantidade)
+    layout(std430, binding = 2) readonly buffer Indices { uint indices[]; };
+
+    uniform ivec3 clusterDims;
+    uniform vec2 tileSize;
+    uniform float zNear;
+    uniform float zFar;
+
+    // Difusa + especular de uma luz, já multiplicadas pelo cone e pela atenuação
+    vec3 phong(vec3 L, vec3 color, float factor, vec3 norm, vec3 viewDir, vec3 baseColor) {
+    float diff = max(dot(norm, L), 0.0);
+    float spec = pow(max(dot(viewDir, reflect(-L, norm)), 0.0), shininess);
+    return (kd * diff * baseColor * color + ks * spec * (color * 0.4 + vec3(0.2))) * factor;
+    }
+
+    void main() {
+    vec3 baseColor = texture(texBuff, TexCoord).rgb;
+    vec3 norm = normalize(Normal);
+    vec3 viewDir = normalize(viewPos - FragPos);
+
+    // Spotlight principal (igual ao shader sem clusters)
+    vec3 lightDirection = normalize(lightPos - FragPos);
+    float theta = dot(lightDirection, normalize(-lightDir));
+    float intensity = clamp((theta - 0.70) / (0.85 - 0.70), 0.0, 1.0) * sombra(FragPos);
+    float distance = length(lightPos - FragPos);
+    float attenuation = 1.0 / (1.0 + 0.05 * distance + 0.01 * distance * distance);
+    vec3 result = (ka * baseColor + phong(lightDirection, lightColor, intensity, norm, viewDir, baseColor)) * attenuation * 2.0;
+
+    // Cluster do fragmento: tile de tela + fatia exponencial de profundidade
+    float viewZ = -(view * vec4(FragPos, 1.0)).z;
+    int slice = int(log(max(viewZ, zNear) / zNear) / log(zFar / zNear) * float(clusterDims.z));
+    ivec3 c = clamp(ivec3(ivec2(gl_FragCoord.xy / tileSize), slice), ivec3(0), clusterDims - 1);
+    uvec2 lista = clusters[(c.z * clusterDims.y + c.y) * clusterDims.x + c.x];
+
+    for (uint i = 0u; i < lista.y; i++) {
+        Luz luz = luzes[indices[lista.x + i]];
+        vec3 toLight = luz.positionRadius.xyz - FragPos;
+        float d = length(toLight);
+        vec3 L = toLight / d;
+        // Atenuação com janela suave: chega a zero exatamente no raio de influência
+        float janela = clamp(1.0 - pow(d / luz.positionRadius.w, 4.0), 0.0, 1.0);
+        float factor = janela * janela / (1.0 + d * d);
+        if (luz.colorType.w > 0.5) {
+            float cosTheta = dot(-L, luz.directionCos.xyz);
+            factor *= clamp((cosTheta - luz.directionCos.w) / (luz.params.x - luz.directionCos.w), 0.0, 1.0);
+        }
+        result += phong(L, luz.colorType.rgb, factor, norm, viewDir, baseColor);
+    }
+
+    FragColor = vec4(result, 1.0);
+})";
+
+// ==== DEFERRED: G-BUFFER ====
+// gAlbedo (RGBA8): kd * textura, a = shininess / 256
+// gNormal (RG16F): normal em codificação octaédrica
+// gMaterial (RGBA8): ka * textura, a = ks (média dos canais)
+// a profundidade fica no depth/stencil do próprio G-buffer
+const char* gbufferFragment = R"(
+   #version 450 core
+    in vec3 FragPos;
+    in vec3 Normal;
+    in vec2 TexCoord;
+
+    layout(location = 0) out vec4 gAlbedo;
+    layout(location = 1) out vec2 gNormal;
+    layout(location = 2) out vec4 gMaterial;
+
+    uniform sampler2D texBuff;
+    uniform vec3 ka, kd, ks;
+    uniform float shininess;
+
+    vec2 octEncode(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 s = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * s;
+    }
+
+    void main() {
+    vec3 baseColor = texture(texBuff, TexCoord).rgb;
+    gAlbedo = vec4(kd * baseColor, clamp(shininess / 256.0, 0.0, 1.0));
+    gNormal = octEncode(normalize(Normal));
+    gMaterial = vec4(ka * baseColor, (ks.r + ks.g + ks.b) / 3.0);
+})";
+
+// Trecho comum aos passes de iluminação (concatenado no início do fragment shader): lê o G-buffer e reconstrói a posição pela profundidade
+const string deferredComum = R"(
+    uniform sampler2D gAlbedo;
+    uniform sampler2D gNormal;
+    uniform sampler2D gMaterial;
+    uniform sampler2D gDepth;
+    uniform mat4 invViewProj;
+    uniform vec2 screenSize;
+    uniform vec3 viewPos;
+
+    struct Superficie {
+        vec3 pos, normal, albedo, ambient;
+        float ks, shininess;
+    };
+
+    vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+    }
+
+    // false para pixels de céu (nada escrito no G-buffer)
+    bool lerSuperficie(out Superficie s) {
+    ivec2 px = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(gDepth, px, 0).r;
+    if (depth >= 1.0)
+        return false;
+    vec4 ndc = vec4(gl_FragCoord.xy / screenSize * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 world = invViewProj * ndc;
+    vec4 a = texelFetch(gAlbedo, px, 0);
+    vec4 m = texelFetch(gMaterial, px, 0);
+    s.pos = world.xyz / world.w;
+    s.normal = octDecode(texelFetch(gNormal, px, 0).rg);
+    s.albedo = a.rgb;
+    s.shininess = a.a * 256.0;
+    s.ambient = m.rgb;
+    s.ks = m.a;
+    return true;
+    }
+
+    vec3 phong(Superficie s, vec3 L, vec3 color, float factor) {
+    vec3 viewDir = normalize(viewPos - s.pos);
+    float diff = max(dot(s.normal, L), 0.0);
+    float spec = pow(max(dot(viewDir, reflect(-L, s.normal)), 0.0), s.shininess);
+    return (s.albedo * diff * color + s.ks * spec * (color * 0.4 + vec3(0.2))) * factor;
+    }
+)";
+
+// Tela cheia: ambiente + spotlight principal (mesmo modelo do forward)
+const string deferredSpotFragment = "#version 450 core\n" + deferredComum + sombraComum + R"(
+    out vec4 FragColor;
+    uniform vec3 lightPos;
+    uniform vec3 lightColor;
+    uniform vec3 lightDir;
+
+    void main() {
+    Superficie s;
+    if (!lerSuperficie(s))
+        discard;
+    vec3 L = normalize(lightPos - s.pos);
+    float theta = dot(L, normalize(-lightDir));
+    float intensity = clamp((theta - 0.70) / (0.85 - 0.70), 0.0, 1.0) * sombra(s.pos);
+    float distance = length(lightPos - s.pos);
+    float attenuation = 1.0 / (1.0 + 0.05 * distance + 0.01 * distance * distance);
+    FragColor = vec4((s.ambient + phong(s, L, lightColor, intensity)) * attenuation * 2.0, 1.0);
+})";
+
+// Volumes de luz: um quad por luz cobrindo só o retângulo de tela da esfera de
+// influência (equivalente ao scissor, mas num único draw instanciado)
+const char* deferredLuzesVertex = R"(
+    #version 450 core
+    struct Luz {
+        vec4 positionRadius;
+        vec4 colorType;
+        vec4 directionCos;
+        vec4 params;
+    };
+    layout(std430, binding = 0) readonly buffer Luzes { Luz luzes[]; };
+
+    uniform mat4 view;
+    uniform mat4 projection;
+    uniform float zNear;
+    flat out int luzIndex;
+
+    void main() {
+    vec2 canto[6] = vec2[](vec2(-1, -1), vec2(1, -1), vec2(1, 1), vec2(-1, -1), vec2(1, 1), vec2(-1, 1));
+    Luz luz = luzes[gl_InstanceID];
+    vec3 c = (view * vec4(luz.positionRadius.xyz, 1.0)).xyz;
+    float r = luz.positionRadius.w;
+    float d = -c.z;
+    luzIndex = gl_InstanceID;
+
+    vec2 centro, metade;
+    if (d - r <= zNear) {
+        // câmera dentro (ou perto) da esfera: tela inteira
+        centro = vec2(0.0);
+        metade = vec2(1.0);
+    } else {
+        // limite conservador da projeção da esfera
+        centro = vec2(projection[0][0] * c.x, projection[1][1] * c.y) / d;
+        metade = vec2(projection[0][0], projection[1][1]) * r / (d - r);
+    }
+    gl_Position = vec4(centro + canto[gl_VertexID] * metade, 0.0, 1.0);
+})";
+
+const string deferredLuzesFragment = "#version 450 core\n" + deferredComum + R"(
+    struct Luz {
+        vec4 positionRadius;
+        vec4 colorType;
+        vec4 directionCos;
+        vec4 params;
+    };
+    layout(std430, binding = 0) readonly buffer Luzes { Luz luzes[]; };
+
+    flat in int luzIndex;
+    out vec4 FragColor;
+
+    void main() {
+    Superficie s;
+    if (!lerSuperficie(s))
+        discard;
+    Luz luz = luzes[luzIndex];
+    vec3 toLight = luz.positionRadius.xyz - s.pos;
+    float d = length(toLight);
+    if (d >= luz.positionRadius.w)
+        discard; // fora do volume (o quad é só um limite na tela)
+    vec3 L = toLight / d;
+    float janela = clamp(1.0 - pow(d / luz.positionRadius.w, 4.0), 0.0, 1.0);
+    float factor = janela * janela / (1.0 + d * d);
+    if (luz.colorType.w > 0.5) {
+        float cosTheta = dot(-L, luz.directionCos.xyz);
+        factor *= clamp((cosTheta - luz.directionCos.w) / (luz.params.x - luz.directionCos.w), 0.0, 1.0);
+    }
+    FragColor = vec4(phong(s, L, luz.colorType.rgb, factor), 1.0);
+})";
+
+// Só profundidade, do ponto de vista do spotlight
+const char *sombraVertex = R"(
+    #version 450 core
+    layout(location = 0) in vec3 position;
+    layout(location = 3) in mat4 instanceModel;
+    uniform mat4 lightSpace;
+    uniform mat4 model;
+    uniform bool instanced;
+    void main() {
+        gl_Position = lightSpace * (instanced ? instanceModel * model : model) * vec4(position, 1.0);
+})";
+
+const char *sombraFragment = R"(
+    #version 450 core
+    void main() {
+})";
+
 const char *skyboxVertex = R"(
     #version 450 core
     out vec2 TexCoord;
@@ -271,47 +570,258 @@ const char *skyboxFragment = R"(
         FragColor = texture(skyTexture, TexCoord);
 })";
 
-GLuint compileSkyboxShader()
+// Visualiza o buffer de oclusão (profundidade [0,1] linearizada em tons de cinza)
+const char *occlusionDebugFragment = R"(
+    #version 450 core
+    in vec2 TexCoord;
+    out vec4 FragColor;
+    uniform sampler2D depthTex;
+    uniform float nearPlane;
+    uniform float farPlane;
+    void main() {
+        float z = texture(depthTex, TexCoord).r * 2.0 - 1.0;
+        float linear = (2.0 * nearPlane * farPlane) / (farPlane + nearPlane - z * (farPlane - nearPlane));
+        float g = 1.0 - clamp(linear / farPlane, 0.0, 1.0);
+        FragColor = z >= 1.0 ? vec4(0.2, 0.0, 0.0, 1.0) : vec4(vec3(g), 1.0);
+})";
+
+// ==== PARTÍCULAS DO RAIO ====
+// Compute shaders do GpuParticles: as regras do CpuParticles (ParticleSystem.h)
+const string particulasComum = R"(
+    layout(local_size_x = 256) in;
+    struct Particula {
+        vec4 posVida; // xyz = posição relativa à base do raio, w = vida restante (0 = morta)
+        vec4 mov;     // x = subida, y = giro, z = vida total
+    };
+    layout(std430, binding = 0) buffer Particulas { Particula particulas[]; };
+    layout(std430, binding = 1) buffer Vivas { uint vivas[]; };
+    layout(std430, binding = 2) buffer Grupos { uvec2 grupos[]; }; // (mortas, vivas) por grupo
+    layout(std430, binding = 3) buffer Contadores {
+        uint nMortas, nVivas, nascem, pad0;
+        uint drawCount, drawInstancias, drawFirst, drawBase; // glDrawArraysIndirect
+    };
+    uniform uint total;
+    uniform float dt, altura, raioBase, raioTopo, vidaMin, vidaMax, subida, giro, contracao;
+
+    // Prefixo exclusivo de (mortas, vivas) entre as 256 invocações do grupo, na
+    // ordem dos índices; 'soma' recebe o total do grupo. Todas têm que chamar
+    shared uvec2 prefixoGrupo[256];
+    uvec2 prefixo(uvec2 v, out uvec2 soma) {
+        uint l = gl_LocalInvocationIndex;
+        prefixoGrupo[l] = v;
+        barrier();
+        for (uint d = 1u; d < 256u; d <<= 1) {
+            uvec2 antes = l >= d ? prefixoGrupo[l - d] : uvec2(0u);
+            barrier();
+            prefixoGrupo[l] += antes;
+            barrier();
+        }
+        soma = prefixoGrupo[255];
+        return prefixoGrupo[l] - v;
+    }
+)";
+
+// Uma invocação por partícula: integra as vivas e conta mortas/vivas do grupo
+const string particulasAtualizar = "#version 450 core\n" + particulasComum + R"(
+    void main() {
+        uint p = gl_GlobalInvocationID.x;
+        uvec2 estado = uvec2(0u);
+        if (p < total) {
+            vec4 q = particulas[p].posVida;
+            if (q.w > 0.0) {
+                vec4 m = particulas[p].mov;
+                float a = m.y * dt, encolhe = max(0.0, 1.0 - contracao * dt);
+                vec3 pos = vec3((q.x - q.z * a) * encolhe, q.y + m.x * dt, (q.z + q.x * a) * encolhe);
+                float vida = q.w - dt;
+                if (vida <= 0.0 || pos.y > altura)
+                    vida = 0.0;
+                particulas[p].posVida = vec4(pos, vida);
+                q.w = vida;
+            }
+            estado = q.w > 0.0 ? uvec2(0u, 1u) : uvec2(1u, 0u);
+        }
+        uvec2 soma;
+        prefixo(estado, soma);
+        if (gl_LocalInvocationIndex == 0u)
+            grupos[gl_WorkGroupID.x] = soma;
+})";
+
+// Um grupo: troca as contagens dos grupos pelo prefixo exclusivo (cada invocação
+// soma um trecho contíguo) e fecha os totais e o draw indireto
+const string particulasPrefixo = "#version 450 core\n" + particulasComum + R"(
+    uniform int quantidade;
+    void main() {
+        uint nGrupos = (total + 255u) / 256u;
+        uint trecho = (nGrupos + 255u) / 256u;
+        uint inicio = min(gl_LocalInvocationIndex * trecho, nGrupos), fim = min(inicio + trecho, nGrupos);
+        uvec2 v = uvec2(0u);
+        for (uint g = inicio; g < fim; g++)
+            v += grupos[g];
+        uvec2 soma;
+        uvec2 base = prefixo(v, soma);
+        for (uint g = inicio; g < fim; g++) {
+            uvec2 c = grupos[g];
+            grupos[g] = base;
+            base += c;
+        }
+        if (gl_LocalInvocationIndex == 0u) {
+            nMortas = soma.x;
+            nVivas = soma.y;
+            nascem = min(uint(max(quantidade, 0)), soma.x);
+            drawCount = soma.y + nascem;
+            drawInstancias = 1u;
+        }
+})";
+
+// Uma invocação por partícula: as vivas vão para o seu lugar na lista; a k-ésima
+// morta (ordem dos índices) renasce com a semente k se k < nascem, depois das vivas
+const string particulasCompactar = "#version 450 core\n" + particulasComum + R"(
+    uniform uint frame;
+    uint hash(uint x) {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+    float aleatorio(inout uint s) {
+        s = hash(s);
+        return float(s >> 8) * (1.0 / 16777216.0);
+    }
+    void main() {
+        uint p = gl_GlobalInvocationID.x;
+        bool dentro = p < total;
+        bool viva = dentro && particulas[p].posVida.w > 0.0;
+        uvec2 soma;
+        uvec2 k = grupos[gl_WorkGroupID.x] + prefixo(uvec2(dentro && !viva ? 1u : 0u, viva ? 1u : 0u), soma);
+        if (viva) {
+            vivas[k.y] = p;
+        } else if (dentro && k.x < nascem) {
+            uint s = hash(k.x + frame * 0x9e3779b9u);
+            float h = aleatorio(s);
+            float r = sqrt(aleatorio(s)) * mix(raioBase, raioTopo, h);
+            float a = aleatorio(s) * 6.2831853;
+            float vida = mix(vidaMin, vidaMax, aleatorio(s));
+            particulas[p].posVida = vec4(cos(a) * r, h * altura, sin(a) * r, vida);
+            float sobe = subida * (0.7 + 0.6 * aleatorio(s));
+            particulas[p].mov = vec4(sobe, giro * (0.5 + aleatorio(s)), vida, 0.0);
+            vivas[nVivas + k.x] = p;
+        }
+})";
+
+// Pontos do desenho indireto: o vértice i é a i-ésima viva
+const char *particulasGpuVertex = R"(
+    #version 450 core
+    struct Particula { vec4 posVida; vec4 mov; };
+    layout(std430, binding = 0) readonly buffer Particulas { Particula particulas[]; };
+    layout(std430, binding = 1) readonly buffer Vivas { uint vivas[]; };
+    uniform mat4 view;
+    uniform mat4 projection;
+    uniform vec3 base;
+    uniform float tamanho;
+    out float alpha;
+    void main() {
+        Particula q = particulas[vivas[gl_VertexID]];
+        alpha = clamp(q.posVida.w / q.mov.z, 0.0, 1.0);
+        gl_Position = projection * view * vec4(base + q.posVida.xyz, 1.0);
+        gl_PointSize = tamanho;
+})";
+
+// Fallback em CPU (sem compute): (posição, alpha) de todas as partículas; as mortas saem do clip
+const char *particulasCpuVertex = R"(
+    #version 450 core
+    layout(location = 0) in vec4 posAlpha;
+    uniform mat4 view;
+    uniform mat4 projection;
+    uniform vec3 base;
+    uniform float tamanho;
+    out float alpha;
+    void main() {
+        alpha = posAlpha.w;
+        gl_Position = alpha > 0.0 ? projection * view * vec4(base + posAlpha.xyz, 1.0) : vec4(2.0, 2.0, 2.0, 1.0);
+        gl_PointSize = tamanho;
+})";
+
+// Disco suave e aditivo; no deferred o teste de profundidade é contra o gDepth
+const char *particulasFragment = R"(
+    #version 450 core
+    in float alpha;
+    out vec4 FragColor;
+    uniform vec3 cor;
+    uniform float brilho; // cai com a quantidade: o raio fica com a mesma intensidade total
+    uniform bool testarGDepth;
+    uniform sampler2D gDepth;
+    void main() {
+        if (testarGDepth && gl_FragCoord.z > texelFetch(gDepth, ivec2(gl_FragCoord.xy), 0).r)
+            discard;
+        vec2 d = gl_PointCoord * 2.0 - 1.0;
+        float r2 = dot(d, d);
+        if (r2 > 1.0)
+            discard;
+        FragColor = vec4(cor * (alpha * brilho * (1.0 - r2)), 1.0);
+})";
+
+// Emite todas as compilações de uma vez; o driver compila enquanto os assets carregam
+void compileShaders()
 {
-    GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vs, 1, &skyboxVertex, NULL);
-    glCompileShader(vs);
-    GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fs, 1, &skyboxFragment, NULL);
-    glCompileShader(fs);
-    GLuint prog = glCreateProgram();
-    glAttachShader(prog, vs);
-    glAttachShader(prog, fs);
-    glLinkProgram(prog);
-    glDeleteShader(vs);
-    glDeleteShader(fs);
-    return prog;
-}
-
-GLuint compileShader()
+    progPrincipal = shaderManager.add("principal", vertexShaderSource, fragmentShaderSource.c_str());
+    progCeu = shaderManager.add("ceu", skyboxVertex, skyboxFragment);
+    progOclusao = shaderManager.add("oclusao_debug", skyboxVertex, occlusionDebugFragment);
+    progClustered = shaderManager.add("clustered", vertexShaderSource, fragmentShaderClustered.c_str());
+    progGBuffer = shaderManager.add("gbuffer", vertexShaderSource, gbufferFragment);
+    progDeferredSpot = shaderManager.add("deferred_spot", skyboxVertex, deferredSpotFragment.c_str());
+    progDeferredLuzes = shaderManager.add("deferred_luzes", deferredLuzesVertex, deferredLuzesFragment.c_str());
+    progSombra = shaderManager.add("sombra", sombraVertex, sombraFragment);
+    if (particulasAtivas)
+        progParticulas = shaderManager.add("particulas", particulasNaGpu ? particulasGpuVertex : particulasCpuVertex,
+                                           particulasFragment);
+    if (particulasAtivas && particulasNaGpu) {
+        progParticulasAtualizar = shaderManager.addCompute("particulas_atualizar", particulasAtualizar.c_str());
+        progParticulasPrefixo = shaderManager.addCompute("particulas_prefixo", particulasPrefixo.c_str());
+        progParticulasCompactar = shaderManager.addCompute("particulas_compactar", particulasCompactar.c_str());
+    }
+}
+
+// Espera o fim das compilações e atribui os programas globais
+void resolveShaders()
 {
-    GLuint v = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(v, 1, &vertexShaderSource, NULL);
-    glCompileShader(v);
-    GLuint f = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(f, 1, &fragmentShaderSource, NULL);
-    glCompileShader(f);
-    GLuint program = glCreateProgram();
-    glAttachShader(program, v);
-    glAttachShader(program, f);
-    glLinkProgram(program);
-    glDeleteShader(v);
-    glDeleteShader(f);
-    return program;
+    shaderManager.waitAll();
+    shaderProgram = shaderManager.program(progPrincipal);
+    skyboxShader = shaderManager.program(progCeu);
+    occlusionDebugShader = shaderManager.program(progOclusao);
+    clusteredShader = shaderManager.program(progClustered);
+    gbufferShader = shaderManager.program(progGBuffer);
+    deferredSpotShader = shaderManager.program(progDeferredSpot);
+    deferredLuzesShader = shaderManager.program(progDeferredLuzes);
+    sombraShader = shaderManager.program(progSombra);
+    if (particulasAtivas)
+        particulasShader = shaderManager.program(progParticulas);
+    programaCena = shaderProgram;
+    shaderManager.report();
 }
 
-GLuint loadTexture(const string &path) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    int width, height, nrChannels;
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+// Pixels decodificados (em qualquer thread); o envio ao GL fica na thread principal
+struct Imagem {
+    unsigned char* data = nullptr;
+    int width = 0, height = 0, channels = 0;
+};
+
+Imagem decodeImage(const string& path) {
+    Imagem img;
+    img.data = stbi_load(path.c_str(), &img.width, &img.height, &img.channels, 0);
+    return img;
+}
+
+// Cria a textura e libera os pixels
+GLuint uploadTexture(const string& path, Imagem& img) {
+    unsigned char* data = img.data;
+    int width = img.width, height = img.height, nrChannels = img.channels;
+    img.data = nullptr;
 
     if (data) {
+        GLuint textureID;
+        glGenTextures(1, &textureID);
         GLenum format;
         if (nrChannels == 1)
             format = GL_RED;
@@ -322,6 +832,7 @@ GLuint loadTexture(const string &path) {
         else {
             std::cerr << "Unsupported channel count: " << nrChannels << " in texture " << path << std::endl;
             stbi_image_free(data);
+            glDeleteTextures(1, &textureID);
             return 0;
         }
 
@@ -336,126 +847,64 @@ GLuint loadTexture(const string &path) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
         stbi_image_free(data);
-    } else {
-        std::cerr << "Failed to load texture: " << path << std::endl;
-        return 0;
+        return textureID;
     }
+    std::cerr << "Failed to load texture: " << path << std::endl;
+    return 0;
+}
 
-    return textureID;
+GLuint loadTexture(const string &path) {
+    Imagem img = decodeImage(path);
+    return uploadTexture(path, img);
 }
 
-void initSkybox()
+void initOcclusion()
 {
-    glGenVertexArrays(1, &quadVAO);
-    skyboxTexture = loadTexture(getString("texturas.textura_ceu", "../assets/Modelos3D/final/ceu.png"));
-    skyboxShader = compileSkyboxShader();
+    occlusionAtiva = cfg->oclusao.ativa;
+    occlusion.resize(cfg->oclusao.largura, cfg->oclusao.altura);
+    occlusion.setThreads(cfg->oclusao.threads);
+
+    glGenTextures(1, &occlusionDebugTex);
+    glBindTexture(GL_TEXTURE_2D, occlusionDebugTex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, occlusion.width(), occlusion.height(), 0, GL_RED, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 }
 
-bool loadOBJWithMTL(const string& objPath, const string& mtlDir, vector<Submesh>& submeshes)
+// Desenha o buffer de oclusão (o pass do frame graph ajusta viewport e profundidade);
+// 'depth' é o resolveDepth() feito na simulação, no tamanho do buffer (fixo depois do init)
+void drawOcclusionDebug(const vector<float>& depth, float nearPlane, float farPlane)
 {
-    ifstream file(objPath);
-    if (!file.is_open())
-        return false;
-
-    vector<vec3> positions, normals;
-    vector<vec2> texCoords;
-    map<string, string> texturesPorMaterial;
-    map<string, Material> materiais;
-
-    string activeMaterial;
-    Submesh submeshAtual;
-    string line;
-
-    while (getline(file, line))
-    {
-        istringstream iss(line);
-        string prefix;
-        iss >> prefix;
-
-        if (prefix == "v")
-        {
-            float x, y, z;
-            iss >> x >> y >> z;
-            positions.emplace_back(x, y, z);
-        }
-        else if (prefix == "vt")
-        {
-            float u, v;
-            iss >> u >> v;
-            texCoords.emplace_back(u, 1.0f - v);
-        }
-        else if (prefix == "vn")
-        {
-            float x, y, z;
-            iss >> x >> y >> z;
-            normals.emplace_back(x, y, z);
-        }
-        else if (prefix == "f")
-        {
-            string v1, v2, v3;
-            iss >> v1 >> v2 >> v3;
-            string vs[] = {v1, v2, v3};
-            for (auto& v : vs)
-            {
-                int p = 0, t = 0, n = 0;
-                sscanf(v.c_str(), "%d/%d/%d", &p, &t, &n);
-                submeshAtual.vertices.push_back({positions[p - 1], texCoords[t - 1], normals[n - 1]});
-            }
-        }
-        else if (prefix == "mtllib")
-        {
-            string mtlFile;
-            iss >> mtlFile;
-            ifstream mtl(mtlDir + "/" + mtlFile);
-            string mline, matName;
-
-            while (getline(mtl, mline))
-            {
-                istringstream mss(mline);
-                string tag;
-                mss >> tag;
-
-                if (tag == "newmtl") {
-                    mss >> matName;
-                    materiais[matName] = Material(); // inicia material
-                }
-                else if (tag == "Ka")
-                    mss >> materiais[matName].ka.r >> materiais[matName].ka.g >> materiais[matName].ka.b;
-                else if (tag == "Kd")
-                    mss >> materiais[matName].kd.r >> materiais[matName].kd.g >> materiais[matName].kd.b;
-                else if (tag == "Ks")
-                    mss >> materiais[matName].ks.r >> materiais[matName].ks.g >> materiais[matName].ks.b;
-                else if (tag == "Ns")
-                    mss >> materiais[matName].shininess;
-                else if (tag == "map_Kd")
-                    mss >> texturesPorMaterial[matName];
-            }
-        }
-        else if (prefix == "usemtl")
-        {
-            if (!submeshAtual.vertices.empty()) {
-                // Finaliza o submesh atual
-                submeshAtual.vertexCount = submeshAtual.vertices.size();
-                submeshes.push_back(submeshAtual);
-                submeshAtual = Submesh();
-            }
-
-            string mtlName;
-            iss >> mtlName;
-            activeMaterial = mtlName;
-            submeshAtual.material = materiais[mtlName];
+    glBindTexture(GL_TEXTURE_2D, occlusionDebugTex);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, occlusion.width(), occlusion.height(), GL_RED, GL_FLOAT, depth.data());
+
+    glUseProgram(occlusionDebugShader);
+    glUniform1f(glGetUniformLocation(occlusionDebugShader, "nearPlane"), nearPlane);
+    glUniform1f(glGetUniformLocation(occlusionDebugShader, "farPlane"), farPlane);
+    glUniform1i(glGetUniformLocation(occlusionDebugShader, "depthTex"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
 
-            if (texturesPorMaterial.count(mtlName))
-                submeshAtual.textureID = loadTexture(mtlDir + "/" + texturesPorMaterial[mtlName]);
-            else
-                submeshAtual.textureID = 0;
-        }
-    }
+void initSkybox()
+{
+    glGenVertexArrays(1, &quadVAO);
+    skyboxTexture = loadTexture(cfg->texturas.ceu);
+}
 
-    // Adiciona último submesh
-    if (!submeshAtual.vertices.empty()) {
-        submeshAtual.vertexCount = submeshAtual.vertices.size();
-        submeshes.push_back(submeshAtual);
+// VAO/VBO de cada parte; as texturas já estão no GL (caminho -> id)
+void criarSubmeshes(vector<MeshPart>& parts, const map<string, GLuint>& texturas, vector<Submesh>& submeshes)
+{
+    for (MeshPart& part : parts) {
+        Submesh sub;
+        sub.vertices = std::move(part.vertices);
+        sub.vertexCount = sub.vertices.size();
+        sub.material = part.material;
+        sub.textureID = part.texture.empty() ? 0 : texturas.at(part.texture);
+        submeshes.push_back(std::move(sub));
     }
 
     // Cria os VAOs e VBOs para cada submesh
@@ -473,110 +922,1079 @@ bool loadOBJWithMTL(const string& objPath, const string& mtlDir, vector<Submesh>
         glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
         glEnableVertexAttribArray(2);
     }
+}
 
-    return !submeshes.empty();
+// Grafo do modelo: raiz + um nó por objeto "o", na ordem do arquivo; devolve o nó de cada parte
+vector<int> montarGrafo(Modelo& modelo, const string& nome, const vector<MeshPart>& parts) {
+    modelo.grafo.clear();
+    int raiz = modelo.grafo.addNode(nome);
+    vector<vec3> minimos(1, vec3(1e30f)), maximos(1, vec3(-1e30f));
+    vector<int> nos;
+    for (const MeshPart& part : parts) {
+        int no = part.object.empty() ? raiz : modelo.grafo.find(part.object);
+        if (no == SceneGraph::NONE) {
+            no = modelo.grafo.addNode(part.object, raiz);
+            minimos.push_back(vec3(1e30f));
+            maximos.push_back(vec3(-1e30f));
+        }
+        for (const Vertex& v : part.vertices) {
+            minimos[no] = min(minimos[no], v.position);
+            maximos[no] = max(maximos[no], v.position);
+        }
+        nos.push_back(no);
+    }
+    modelo.pivos.resize(minimos.size());
+    for (size_t i = 0; i < minimos.size(); i++)
+        modelo.pivos[i] = minimos[i].x <= maximos[i].x ? (minimos[i] + maximos[i]) * 0.5f : vec3(0.0f);
+    modelo.grafo.update();
+    return nos;
 }
 
-bool loadModel(const string& path, Modelo& modelo) {
-    modelo.partes.clear(); // limpa se já existia algo
+// Carrega os modelos no JobSystem: um job de parse (OBJ + MTL) por modelo e,
+// depois, um job de decodificação por textura distinta. A thread do GL executa
+// jobs enquanto espera e no fim cria as texturas e os VAOs.
+void loadModels(const vector<pair<string, Modelo*>>& modelos) {
+    JobSystem& jobs = JobSystem::global();
+    size_t n = modelos.size();
+    vector<vector<MeshPart>> partes(n);
+    vector<char> ok(n, 0);
+
+    JobCounter parse;
+    for (size_t i = 0; i < n; i++) {
+        jobs.run([&, i]() {
+            PROFILE_SCOPE("parse_obj");
+            ObjData obj;
+            ok[i] = parseOBJ(modelos[i].first, "../assets/Modelos3D/final", obj);
+            if (ok[i])
+                assembleMeshParts(obj, partes[i]);
+        }, &parse);
+    }
+    jobs.wait(parse);
+
+    map<string, Imagem> imagens;
+    for (const vector<MeshPart>& p : partes)
+        for (const MeshPart& part : p)
+            if (!part.texture.empty())
+                imagens[part.texture];
+    JobCounter decodificacao;
+    for (auto& entrada : imagens) {
+        const string* caminho = &entrada.first;
+        Imagem* img = &entrada.second;
+        jobs.run([caminho, img]() {
+            PROFILE_SCOPE("decodifica_textura");
+            *img = decodeImage(*caminho);
+        }, &decodificacao);
+    }
+    jobs.wait(decodificacao);
 
-    if (!loadOBJWithMTL(path, "../assets/Modelos3D/final", modelo.partes)) {
-        cerr << "Erro ao carregar modelo: " << path << endl;
-        return false;
+    map<string, GLuint> texturas;
+    for (auto& entrada : imagens)
+        texturas[entrada.first] = uploadTexture(entrada.first, entrada.second);
+
+    for (size_t i = 0; i < n; i++) {
+        Modelo& modelo = *modelos[i].second;
+        modelo.partes.clear(); // limpa se já existia algo
+        if (!ok[i] || partes[i].empty()) {
+            cerr << "Erro ao carregar modelo: " << modelos[i].first << endl;
+            continue;
+        }
+        vector<int> nos = montarGrafo(modelo, modelos[i].first, partes[i]);
+        criarSubmeshes(partes[i], texturas, modelo.partes);
+        for (size_t k = 0; k < nos.size(); k++)
+            modelo.partes[k].no = nos[k];
+
+        modelo.vertexCount = 0;
+        modelo.aabbMin = vec3(1e30f);
+        modelo.aabbMax = vec3(-1e30f);
+        for (Submesh& sub : modelo.partes) {
+            modelo.vertexCount += sub.vertexCount;
+            for (const Vertex& v : sub.vertices) {
+                modelo.aabbMin = min(modelo.aabbMin, v.position);
+                modelo.aabbMax = max(modelo.aabbMax, v.position);
+            }
+        }
     }
+}
 
-    modelo.vertexCount = 0;
-    for (Submesh& sub : modelo.partes) {
-        modelo.vertexCount += sub.vertexCount;
+// ============== LUZES DINÂMICAS (CLUSTERED) ==============
+// Parâmetros de órbita de cada luz da demo; a posição é recalculada todo frame
+struct OrbitaLuz {
+    float raio, altura, fase, velocidade;
+};
+vector<OrbitaLuz> orbitas;
+
+// Gera 'quantidade' luzes determinísticas (mesma semente sempre): 3/4 pontuais, 1/4 spots apontando para a vaca
+void initLuzesDemo(int quantidade) {
+    uint32_t seed = 12345u;
+    auto rnd = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0f;
+    };
+
+    float raioLuz = cfg->luzes.raio;
+    luzesDemo.resize(quantidade);
+    orbitas.resize(quantidade);
+    for (int i = 0; i < quantidade; i++) {
+        orbitas[i] = { 1.5f + rnd() * 12.0f, 0.3f + rnd() * 4.0f, rnd() * 6.2831853f, (rnd() - 0.5f) * 1.5f };
+        ClusterLight& l = luzesDemo[i];
+        l.positionRadius = vec4(0.0f, 0.0f, 0.0f, raioLuz * (0.6f + rnd() * 0.8f));
+        bool spot = (i % 4) == 3;
+        l.colorType = vec4(0.3f + rnd() * 0.7f, 0.3f + rnd() * 0.7f, 0.3f + rnd() * 0.7f, spot ? 1.0f : 0.0f);
+        l.directionCos = vec4(0.0f, -1.0f, 0.0f, cos(radians(35.0f)));
+        l.params = vec4(cos(radians(20.0f)), 0.0f, 0.0f, 0.0f);
     }
+}
 
-    return true;
+void atualizarLuzesDemo(float t, const vec3& alvo) {
+    for (size_t i = 0; i < luzesDemo.size(); i++) {
+        const OrbitaLuz& o = orbitas[i];
+        float a = o.fase + o.velocidade * t;
+        vec3 p = vec3(alvo.x + o.raio * cos(a), o.altura + 0.5f * sin(a * 3.0f), alvo.z + o.raio * sin(a));
+        luzesDemo[i].positionRadius = vec4(p, luzesDemo[i].positionRadius.w);
+        if (luzesDemo[i].colorType.w > 0.5f)
+            luzesDemo[i].directionCos = vec4(normalize(alvo - p), luzesDemo[i].directionCos.w);
+    }
 }
 
-void mouse_callback(GLFWwindow *, double xpos, double ypos)
-{
-    static bool first = true;
-    if (first)
-    {
-        lastX = xpos;
-        lastY = ypos;
-        first = false;
+// Tempo médio de frame por quantidade de luzes; com luzes.varredura = true dobra a
+// quantidade a cada medição (64 ... luzes.max) e imprime a tabela no final
+void medirLuzes(float t, float frameMs) {
+    static float inicio = -1.0f, somaMs = 0.0f, somaAtribuicao = 0.0f;
+    static int frames = 0;
+    static size_t descartadas = 0;
+    static size_t quantidadeMedida = 0;
+    static bool varredura = cfg->luzes.varredura;
+    static vector<string> tabela;
+
+    if (luzesDemo.size() != quantidadeMedida || inicio < 0.0f) {
+        quantidadeMedida = luzesDemo.size();
+        inicio = t;
+        somaMs = somaAtribuicao = 0.0f;
+        frames = 0;
+        descartadas = 0;
+        return; // descarta o frame da troca
+    }
+    somaMs += frameMs;
+    somaAtribuicao += clusters.assignMs;
+    descartadas = std::max(descartadas, clusters.overflow);
+    frames++;
+    if (t - inicio < cfg->luzes.intervalo || frames == 0)
+        return;
+
+    char linha[192];
+    snprintf(linha, sizeof(linha), "[clustered] %6zu luzes: %7.2f ms/frame, atribuicao CPU %6.3f ms, %zu indices, %zu pares descartados (pior frame)",
+             quantidadeMedida, somaMs / frames, somaAtribuicao / frames, clusters.totalIndices(), descartadas);
+    cout << linha << endl;
+    inicio = t;
+    somaMs = somaAtribuicao = 0.0f;
+    frames = 0;
+    descartadas = 0;
+
+    if (varredura) {
+        tabela.push_back(linha);
+        int proxima = (int)quantidadeMedida * 2;
+        if (proxima <= cfg->luzes.max) {
+            initLuzesDemo(proxima);
+        } else {
+            cout << "==== varredura de luzes ====" << endl;
+            for (const string& l : tabela)
+                cout << l << endl;
+            varredura = false;
+        }
     }
-    float xoffset = xpos - lastX;
-    float yoffset = lastY - ypos;
-    lastX = xpos;
-    lastY = ypos;
-    camera.Rotate(xoffset, yoffset);
 }
 
-void processInput(GLFWwindow *window)
+// ============== REBANHO ==============
+// Modo de estresse (rebanho.ativo): N vacas e M ovnis do Herd com a lógica do
+// par principal, uma matriz por instância e um glDrawArraysInstanced por
+// submesh. Sem occlusion culling por instância: o custo é todo de GPU.
+// A simulação monta as matrizes; o envio e o desenho usam as do pacote do frame.
+Herd rebanho;
+bool rebanhoAtivo = false;
+GLuint rebanhoVacasVBO = 0, rebanhoOvnisVBO = 0;
+
+// Buffer de matrizes nos atributos 3..6 (uma coluna cada, avança por instância) dos VAOs do modelo
+void ligarInstancias(Modelo& m, GLuint vbo) {
+    for (Submesh& sub : m.partes) {
+        glBindVertexArray(sub.VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        for (int c = 0; c < 4; c++) {
+            glVertexAttribPointer(3 + c, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (void*)(sizeof(vec4) * c));
+            glEnableVertexAttribArray(3 + c);
+            glVertexAttribDivisor(3 + c, 1);
+        }
+    }
+    glBindVertexArray(0);
+}
+
+void criarBuffersRebanho() {
+    glGenBuffers(1, &rebanhoVacasVBO);
+    glGenBuffers(1, &rebanhoOvnisVBO);
+    ligarInstancias(vaca, rebanhoVacasVBO);
+    ligarInstancias(ovni, rebanhoOvnisVBO);
+}
+
+// Sem GL: a varredura troca o tamanho do rebanho na thread da simulação
+void initRebanho(int vacas, int ovnis) {
+    rebanho.setThreads(cfg->rebanho.threads);
+    rebanho.init(vacas, ovnis, cfg->rebanho.espaco, cfg->rebanho.centro, animacoes);
+    cout << "[rebanho] " << rebanho.cowCount() << " vacas, " << rebanho.ufoCount() << " ovnis, "
+         << rebanho.threads() << " threads" << endl;
+}
+
+// Matrizes do frame para a GPU; glBufferData troca o armazenamento (não espera o frame anterior)
+double enviarRebanho(const vector<mat4>& vacas, const vector<mat4>& ovnis) {
+    auto t0 = chrono::steady_clock::now();
+    auto enviar = [](GLuint vbo, const vector<mat4>& matrizes) {
+        static const mat4 identidade(1.0f); // os VAOs também desenham o par principal: nunca fica vazio
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        if (matrizes.empty())
+            glBufferData(GL_ARRAY_BUFFER, sizeof(mat4), value_ptr(identidade), GL_STREAM_DRAW);
+        else
+            glBufferData(GL_ARRAY_BUFFER, matrizes.size() * sizeof(mat4), matrizes.data(), GL_STREAM_DRAW);
+    };
+    enviar(rebanhoVacasVBO, vacas);
+    enviar(rebanhoOvnisVBO, ovnis);
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+// Tempos médios do rebanho a cada rebanho.intervalo s; com rebanho.varredura = true
+// multiplica vacas e ovnis por 10 a cada medição (até rebanho.max vacas) e imprime a tabela
+void medirRebanho(float t, float frameMs, double simMs, double uploadMs, double gpuMs) {
+    static float inicio = -1.0f;
+    static double soma[5] = {};
+    static int frames = 0, vacasMedidas = -1;
+    static bool varredura = cfg->rebanho.varredura;
+    static vector<string> tabela;
+
+    if (rebanho.cowCount() != vacasMedidas || inicio < 0.0f) {
+        vacasMedidas = rebanho.cowCount();
+        inicio = t;
+        fill(begin(soma), end(soma), 0.0);
+        frames = 0;
+        return; // descarta o frame da troca
+    }
+    const double amostra[5] = { simMs, rebanho.stats().matricesMs, uploadMs, gpuMs, frameMs };
+    for (int i = 0; i < 5; i++)
+        soma[i] += amostra[i];
+    frames++;
+    if (t - inicio < cfg->rebanho.intervalo)
+        return;
+
+    char linha[200];
+    snprintf(linha, sizeof(linha),
+             "[rebanho] %7d vacas + %6d ovnis: simulacao %7.3f ms/frame, matrizes %7.3f ms, upload %7.3f ms, "
+             "GPU %7.2f ms, frame %7.2f ms",
+             rebanho.cowCount(), rebanho.ufoCount(), soma[0] / frames, soma[1] / frames, soma[2] / frames,
+             soma[3] / frames, soma[4] / frames);
+    cout << linha << endl;
+    inicio = t;
+    fill(begin(soma), end(soma), 0.0);
+    frames = 0;
+
+    if (varredura) {
+        tabela.push_back(linha);
+        long long proxima = (long long)rebanho.cowCount() * 10;
+        if (proxima <= cfg->rebanho.max) {
+            initRebanho((int)proxima, rebanho.ufoCount() * 10);
+        } else {
+            cout << "==== varredura do rebanho ====" << endl;
+            for (const string& l : tabela)
+                cout << l << endl;
+            varredura = false;
+        }
+    }
+}
+
+void bindInput(GLFWwindow *w)
 {
-    float current = glfwGetTime();
-    deltaTime = current - lastFrame;
-    lastFrame = current;
-
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-        camera.Move("FORWARD", deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-        camera.Move("BACKWARD", deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-        camera.Move("LEFT", deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-        camera.Move("RIGHT", deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS)
-    {
+    input.attach(w);
+    input.bind(GLFW_KEY_W, Acao::Frente);
+    input.bind(GLFW_KEY_S, Acao::Tras);
+    input.bind(GLFW_KEY_A, Acao::Esquerda);
+    input.bind(GLFW_KEY_D, Acao::Direita);
+    input.bind(GLFW_KEY_H, Acao::LuzCasa);
+    input.bind(GLFW_KEY_O, Acao::Oclusao);
+    input.bind(GLFW_KEY_G, Acao::Renderer);
+    input.bind(GLFW_KEY_T, Acao::TemposGpu);
+    input.bind(GLFW_KEY_K, Acao::CacheSombra);
+    input.bind(GLFW_KEY_P, Acao::Trace);
+    input.bind(GLFW_KEY_F12, Acao::Estatisticas);
+    input.bind(GLFW_KEY_L, Acao::DemoLuzes);
+    input.bind(GLFW_KEY_EQUAL, Acao::MaisLuzes);
+    input.bind(GLFW_KEY_KP_ADD, Acao::MaisLuzes);
+    input.bind(GLFW_KEY_MINUS, Acao::MenosLuzes);
+    input.bind(GLFW_KEY_KP_SUBTRACT, Acao::MenosLuzes);
+}
+
+// Depois do glfwPollEvents: movimento pelas teclas seguradas, um toggle por
+// pressionamento (sem esperar o próximo evento nem debounce por tempo)
+void processInput()
+{
+    if (input.down(Acao::Frente))
+        camera.Move(CameraMovement::Forward, deltaTime);
+    if (input.down(Acao::Tras))
+        camera.Move(CameraMovement::Backward, deltaTime);
+    if (input.down(Acao::Esquerda))
+        camera.Move(CameraMovement::Left, deltaTime);
+    if (input.down(Acao::Direita))
+        camera.Move(CameraMovement::Right, deltaTime);
+    vec2 giro = input.takeMouseDelta();
+    camera.Rotate(giro.x, giro.y);
+
+    if (input.pressed(Acao::LuzCasa))
         casaLuz = !casaLuz;
-        glfwWaitEventsTimeout(0.1);
+    if (input.pressed(Acao::Oclusao))
+        mostrarOclusao = !mostrarOclusao;
+
+    // G alterna entre forward e deferred; T imprime os tempos de GPU por pass
+    if (input.pressed(Acao::Renderer))
+    {
+        deferred = !deferred;
+        cout << "[renderer] " << (deferred ? "deferred" : "forward") << endl;
     }
+    if (input.pressed(Acao::TemposGpu))
+        imprimirTempos = true;
+    if (input.pressed(Acao::CacheSombra))
+        alternarCacheSombra = true;
+    if (input.pressed(Acao::Trace))
+        gravarTrace = true;
+    if (input.pressed(Acao::Estatisticas))
+        exportarEstatisticas = true;
+
+    // L liga/desliga a demo de luzes; + e - dobram/reduzem pela metade a quantidade
+    if (input.pressed(Acao::DemoLuzes))
+        demoLuzes = !demoLuzes;
+    if (input.pressed(Acao::MaisLuzes) && demoLuzes)
+        initLuzesDemo((int)std::min<size_t>(luzesDemo.size() * 2, 65536));
+    if (input.pressed(Acao::MenosLuzes) && demoLuzes)
+        initLuzesDemo((int)std::max<size_t>(luzesDemo.size() / 2, 1));
 }
 
-void carregarJanela(GLFWwindow*& w) {
-    int width = (int)getFloat("window.width", 800);
-    int height = (int)getFloat("window.height", 600);
-    string title = getString("window.title", "OVNI vs Vaca");
+// Campos "ao vivo" que ficam guardados fora do snapshot (material do chão)
+// Giro de cada objeto do ovni ([ovni_partes]), resolvido para nós do grafo
+vector<pair<int, float>> girosOvni;
+
+void aplicarConfigAoVivo() {
+    chao.material.ka = cfg->chao.ka;
+    chao.material.kd = cfg->chao.kd;
+    chao.material.ks = cfg->chao.ks;
+    chao.material.shininess = cfg->chao.shininess;
+
+    girosOvni.clear();
+    for (const auto& giro : cfg->ovniPartes) {
+        int no = ovni.grafo.find(giro.first);
+        if (no == SceneGraph::NONE || no == 0)
+            cerr << "[ovni_partes] objeto '" << giro.first << "' não existe no ovni" << endl;
+        else
+            girosOvni.push_back({ no, giro.second });
+    }
+    // Parte que deixou de girar volta à pose do arquivo
+    for (int no = 1; no < ovni.grafo.size(); no++)
+        ovni.grafo.setLocal(no, mat4(1.0f));
+}
 
-    w = glfwCreateWindow(width, height, title.c_str(), NULL, NULL);
+// Locais das partes que giram (em Y, em volta do centro da parte) e matrizes de mundo do grafo
+void animarPartesOvni(float t) {
+    for (const auto& giro : girosOvni) {
+        vec3 pivo = ovni.pivos[giro.first];
+        mat4 local = translate(mat4(1.0f), pivo) * rotate(mat4(1.0f), t * giro.second, vec3(0, 1, 0)) *
+                     translate(mat4(1.0f), -pivo);
+        ovni.grafo.setLocal(giro.first, local);
+    }
+    ovni.grafo.update();
+}
+
+void carregarJanela(GLFWwindow*& w) {
+    w = glfwCreateWindow(cfg->window.width, cfg->window.height, cfg->window.title.c_str(), NULL, NULL);
 }
 
-void drawChao(const Modelo& chao, const mat4& model) {
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, value_ptr(model));
-    glUniform3fv(glGetUniformLocation(shaderProgram, "ka"), 1, value_ptr(chao.material.ka));
-    glUniform3fv(glGetUniformLocation(shaderProgram, "kd"), 1, value_ptr(chao.material.kd));
-    glUniform3fv(glGetUniformLocation(shaderProgram, "ks"), 1, value_ptr(chao.material.ks));
-    glUniform1f(glGetUniformLocation(shaderProgram, "shininess"), chao.material.shininess);
+// 'material' vem do pacote do frame (o do chão muda com o hot reload, na simulação)
+void drawChao(const Modelo& chao, const Material& material, const mat4& model) {
+    glUniformMatrix4fv(glGetUniformLocation(programaCena, "model"), 1, GL_FALSE, value_ptr(model));
+    glUniform3fv(glGetUniformLocation(programaCena, "ka"), 1, value_ptr(material.ka));
+    glUniform3fv(glGetUniformLocation(programaCena, "kd"), 1, value_ptr(material.kd));
+    glUniform3fv(glGetUniformLocation(programaCena, "ks"), 1, value_ptr(material.ks));
+    glUniform1f(glGetUniformLocation(programaCena, "shininess"), material.shininess);
 
     glBindVertexArray(chao.VAO);
     glActiveTexture(GL_TEXTURE0); // ATIVA UNIDADE 0
     glBindTexture(GL_TEXTURE_2D, chao.textura);
-    glUniform1i(glGetUniformLocation(shaderProgram, "texBuff"), 0);
+    glUniform1i(glGetUniformLocation(programaCena, "texBuff"), 0);
     glDrawArrays(GL_TRIANGLES, 0, chao.vertexCount);
 }
 
-int main() {
+// ============== PARTÍCULAS DO RAIO ==============
+// O raio trator entre o ovni e o chão (GpuParticles.h / ParticleSystem.h). Só
+// emite com a casa apagada; quando o raio desliga, as vivas terminam a vida.
+// particulas.modo = auto usa a GPU quando o contexto tem compute shaders.
+
+// Antes do compileShaders: o vertex shader do desenho depende do modo
+void escolherModoParticulas(GLADloadproc load) {
+    particulasAtivas = cfg->particulas.ativo;
+    if (!particulasAtivas)
+        return;
+    bool temCompute = GpuParticles::supported(load);
+    if (cfg->particulas.modo == "gpu" && !temCompute)
+        cerr << "[particulas] contexto sem compute shaders (4.3+), usando a CPU" << endl;
+    particulasNaGpu = cfg->particulas.modo != "cpu" && temCompute;
+}
+
+void initParticulas(GLADloadproc load) {
+    if (!particulasAtivas)
+        return;
+    int n = cfg->particulas.quantidade;
+    if (particulasNaGpu) {
+        auto programa = [](int h) { return shaderManager.ok(h) ? shaderManager.program(h) : 0u; };
+        if (!particulasGpu.init(load, n, programa(progParticulasAtualizar), programa(progParticulasPrefixo),
+                                programa(progParticulasCompactar))) {
+            particulasAtivas = false; // o desenho já foi compilado para a GPU: sem troca de modo aqui
+            return;
+        }
+    } else {
+        particulasCpu.init(n, cfg->particulas.threads);
+        glGenVertexArrays(1, &particulasVAO);
+        glGenBuffers(1, &particulasVBO);
+        glBindVertexArray(particulasVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, particulasVBO);
+        glBufferData(GL_ARRAY_BUFFER, particulasCpu.capacity() * sizeof(vec4), nullptr, GL_STREAM_DRAW);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(vec4), (void*)0);
+        glEnableVertexAttribArray(0);
+        glBindVertexArray(0);
+    }
+    cout << "[particulas] " << (particulasNaGpu ? "GPU (compute + draw indireto)" : "CPU") << ", " << n << " partículas"
+         << (particulasNaGpu ? "" : ", " + to_string(particulasCpu.threads()) + " threads") << endl;
+}
+
+// Raio do chão até a base do ovni; a taxa mantém ~quantidade vivas (quantidade / vida média)
+void atualizarRaio(float ovniY) {
+    raio.base = vec3(0.0f);
+    raio.height = std::max(0.0f, ovniY - 1.0f);
+    raio.rate = casaLuz ? 0.0f : cfg->particulas.quantidade / (0.5f * (raio.minLife + raio.maxLife));
+}
+
+// Fallback: o passo roda na simulação e a saída vai no pacote; aqui, na thread do GL,
+// todas as partículas vão para o VBO (glBufferData troca o armazenamento)
+void enviarParticulasCpu(const vector<vec4>& particulas, double atualizacaoMs, size_t vivas) {
+    auto t0 = chrono::steady_clock::now();
+    glBindBuffer(GL_ARRAY_BUFFER, particulasVBO);
+    glBufferData(GL_ARRAY_BUFFER, particulas.size() * sizeof(vec4), particulas.data(), GL_STREAM_DRAW);
+    particulasEnvioMs += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    particulasCpuMs += atualizacaoMs;
+    particulasVivasCpu = vivas;
+    particulasFrames++;
+}
+
+// ============== FRAME GRAPH ==============
+// Pacote do frame (RenderThread.h): tudo o que os passes leem, preenchido pela
+// simulação e imutável depois de publicado. Os vetores grandes entram por swap
+// (rebanho, listas dos clusters, partículas) e voltam para a simulação quando
+// o pacote é reaproveitado, três frames depois.
+struct FrameData {
+    mat4 view = mat4(1.0f), proj = mat4(1.0f);
+    vec3 viewPos = vec3(0.0f);
+    mat4 modelOvni = mat4(1.0f), modelCasa = mat4(1.0f), modelVaca = mat4(1.0f);
+    bool ovniVisivel = true, vacaVisivel = true;
+    float nearPlane = 0.1f, farPlane = 100.0f;
+    vector<mat4> mundosOvni; // mundo de cada nó do ovni (partes que giram)
+
+    // Luz do spot (casa ou ovni) e material do chão (ao vivo)
+    vec3 lightColor = vec3(1.0f), lightPos = vec3(0.0f), lightDir = vec3(0.0f, -1.0f, 0.0f);
+    Material materialChao;
+
+    // Demo de luzes: cópia das luzes; listas por cluster só no forward
+    vector<ClusterLight> luzes;
+    vector<uint32_t> clusterGrid, clusterIndices;
+    ClusterGrid::ShaderParams clusterParams = {};
+
+    vector<mat4> vacasRebanho, ovnisRebanho;
+    uint64_t geracaoRebanho = 0; // muda junto com as matrizes das vacas do rebanho
+
+    // Partículas: o raio do frame e, no fallback em CPU, a saída do passo
+    BeamEmitter raio;
+    float dt = 0.0f;
+    vector<vec4> particulas;
+    double particulasMs = 0.0;
+    size_t particulasVivas = 0;
+
+    vector<float> oclusaoDepth; // só com mostrarOclusao
+
+    int fbW = 0, fbH = 0;
+    double inputTime = 0.0, latchTime = 0.0; // latência de entrada
+    shared_ptr<const Settings> config;       // snapshot do config.ini do frame
+    bool deferred = false, demoLuzes = false, sombraAtiva = true, mostrarOclusao = false;
+
+    // Eventos das teclas, tratados pelo render
+    bool alternarCacheSombra = false, imprimirTempos = false, gravarTrace = false, exportarEstatisticas = false;
+};
+
+FrameQueue<FrameData> filaQuadros;
+const FrameData* quadro = nullptr; // pacote sendo desenhado (só na thread do GL)
+
+// Do render para a simulação: medições publicadas a cada frame desenhado
+struct RetornoRender {
+    atomic<double> gpuCenaMs{ 0.0 }, rebanhoUploadMs{ 0.0 };
+};
+RetornoRender retornoRender;
+
+FrameGraph frameGraph;
+int backbuffer;
+int passOclusaoDebug;
+int passCena, passGBuffer, passDeferredSpot, passDeferredLuzes, passSombra;
+int passParticulas, passParticulasDeferred;
+int sombraMapa;
+int gAlbedo, gNormal, gMaterial, gDepth;
+
+// Mundo de um nó do modelo: o ovni anima as partes na simulação, então vem do pacote
+const mat4& mundo(const Modelo& m, int no) {
+    return &m == &ovni ? quadro->mundosOvni[no] : m.grafo.world(no);
+}
+
+// instancias > 0: uma instância por matriz do buffer ligado ao VAO (rebanho), 'model' = só o nó da parte.
+// Cada parte usa model * mundo do seu nó (o uniform só muda quando o nó muda)
+void drawPartes(const Modelo& m, const mat4& model, int instancias) {
+    GLint locModel = glGetUniformLocation(programaCena, "model");
+    int noAtual = -1;
+    for (const Submesh& sub : m.partes) {
+        if (sub.no != noAtual) {
+            mat4 parte = instancias > 0 ? mundo(m, sub.no) : model * mundo(m, sub.no);
+            glUniformMatrix4fv(locModel, 1, GL_FALSE, value_ptr(parte));
+            noAtual = sub.no;
+        }
+        glUniform3fv(glGetUniformLocation(programaCena, "ka"), 1, value_ptr(sub.material.ka));
+        glUniform3fv(glGetUniformLocation(programaCena, "kd"), 1, value_ptr(sub.material.kd));
+        glUniform3fv(glGetUniformLocation(programaCena, "ks"), 1, value_ptr(sub.material.ks));
+        glUniform1f(glGetUniformLocation(programaCena, "shininess"), sub.material.shininess);
+
+        glBindVertexArray(sub.VAO);
+        glBindTexture(GL_TEXTURE_2D, sub.textureID);
+        if (instancias > 0)
+            glDrawArraysInstanced(GL_TRIANGLES, 0, sub.vertexCount, instancias);
+        else
+            glDrawArrays(GL_TRIANGLES, 0, sub.vertexCount);
+    }
+}
+
+void drawModelo(const Modelo& m, const mat4& model) {
+    drawPartes(m, model, 0);
+}
+
+void drawRebanho() {
+    GPU_PROFILE_SCOPE("rebanho");
+    GLint instanced = glGetUniformLocation(programaCena, "instanced");
+    glUniform1i(instanced, 1);
+    if (!quadro->vacasRebanho.empty())
+        drawPartes(vaca, mat4(1.0f), (int)quadro->vacasRebanho.size());
+    drawPartes(ovni, mat4(1.0f), (int)quadro->ovnisRebanho.size());
+    glUniform1i(instanced, 0);
+}
+
+void drawCeu() {
+    GPU_PROFILE_SCOPE("ceu");
+    glUseProgram(skyboxShader);
+    glBindVertexArray(quadVAO);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, skyboxTexture);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+void drawObjetos() {
+    {
+        GPU_PROFILE_SCOPE("chao");
+        drawChao(chao, quadro->materialChao, mat4(1.0f));
+    }
+    GPU_PROFILE_SCOPE("modelos");
+    drawModelo(casa, quadro->modelCasa);
+    if (quadro->ovniVisivel)
+        drawModelo(ovni, quadro->modelOvni);
+    if (quadro->vacaVisivel)
+        drawModelo(vaca, quadro->modelVaca);
+    if (rebanhoAtivo)
+        drawRebanho();
+}
+
+// Shadow map do spotlight na unidade 5 (as unidades 0..3 ficam com texturas e G-buffer)
+void bindSombra(GLuint programa) {
+    glActiveTexture(GL_TEXTURE5);
+    glBindTexture(GL_TEXTURE_2D, sombraSpot.texture());
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(glGetUniformLocation(programa, "shadowMap"), 5);
+    glUniform1i(glGetUniformLocation(programa, "sombraAtiva"), quadro->sombraAtiva);
+    glUniformMatrix4fv(glGetUniformLocation(programa, "lightSpace"), 1, GL_FALSE, value_ptr(sombraSpot.lightSpace()));
+}
+
+// Só geometria, sem materiais
+void drawProfundidade(const Modelo& m, const mat4& model) {
+    GLint locModel = glGetUniformLocation(sombraShader, "model");
+    glUniformMatrix4fv(locModel, 1, GL_FALSE, value_ptr(model));
+    if (m.partes.empty()) {
+        glBindVertexArray(m.VAO);
+        glDrawArrays(GL_TRIANGLES, 0, m.vertexCount);
+    }
+    int noAtual = 0; // nó 0 (raiz) fica com 'model'
+    for (const Submesh& sub : m.partes) {
+        if (sub.no != noAtual) {
+            glUniformMatrix4fv(locModel, 1, GL_FALSE, value_ptr(model * mundo(m, sub.no)));
+            noAtual = sub.no;
+        }
+        glBindVertexArray(sub.VAO);
+        glDrawArrays(GL_TRIANGLES, 0, sub.vertexCount);
+    }
+}
+
+// Instâncias do rebanho de um modelo (vacas ou ovnis), com as matrizes já enviadas
+void drawProfundidadeRebanho(const Modelo& m, int instancias) {
+    if (instancias == 0)
+        return;
+    GLint instanced = glGetUniformLocation(sombraShader, "instanced");
+    glUniform1i(instanced, 1);
+    GLint locModel = glGetUniformLocation(sombraShader, "model");
+    for (const Submesh& sub : m.partes) {
+        glUniformMatrix4fv(locModel, 1, GL_FALSE, value_ptr(mundo(m, sub.no)));
+        glBindVertexArray(sub.VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, sub.vertexCount, instancias);
+    }
+    glUniform1i(instanced, 0);
+}
+
+// Estáticos (chão, casa), dinâmicos em cache (vacas) e animados a cada frame (ovnis
+// girando, com as partes)
+void drawSombra() {
+    GPU_PROFILE_SCOPE("sombra");
+    glUseProgram(sombraShader);
+    GLint loc = glGetUniformLocation(sombraShader, "lightSpace");
+    sombraSpot.render([&](const mat4& lightSpace) {
+        glUniformMatrix4fv(loc, 1, GL_FALSE, value_ptr(lightSpace));
+        drawProfundidade(chao, mat4(1.0f));
+        drawProfundidade(casa, quadro->modelCasa);
+    }, [&](const mat4& lightSpace) {
+        glUniformMatrix4fv(loc, 1, GL_FALSE, value_ptr(lightSpace));
+        drawProfundidade(vaca, quadro->modelVaca);
+        if (rebanhoAtivo)
+            drawProfundidadeRebanho(vaca, (int)quadro->vacasRebanho.size());
+    }, [&](const mat4& lightSpace) {
+        glUniformMatrix4fv(loc, 1, GL_FALSE, value_ptr(lightSpace));
+        drawProfundidade(ovni, quadro->modelOvni);
+        if (rebanhoAtivo)
+            drawProfundidadeRebanho(ovni, (int)quadro->ovnisRebanho.size());
+    });
+    frameGraph.invalidateState(); // render() troca de FBO por conta própria
+}
+
+void drawCena() {
+    programaCena = quadro->demoLuzes ? clusteredShader : shaderProgram;
+    glUseProgram(programaCena);
+    glUniformMatrix4fv(glGetUniformLocation(programaCena, "view"), 1, GL_FALSE, value_ptr(quadro->view));
+    glUniformMatrix4fv(glGetUniformLocation(programaCena, "projection"), 1, GL_FALSE, value_ptr(quadro->proj));
+    glUniform3fv(glGetUniformLocation(programaCena, "viewPos"), 1, value_ptr(quadro->viewPos));
+    glUniform3fv(glGetUniformLocation(programaCena, "lightPos"), 1, value_ptr(quadro->lightPos));
+    glUniform3fv(glGetUniformLocation(programaCena, "lightColor"), 1, value_ptr(quadro->lightColor));
+    glUniform3fv(glGetUniformLocation(programaCena, "lightDir"), 1, value_ptr(quadro->lightDir));
+    bindSombra(programaCena);
+    if (quadro->demoLuzes)
+        clusters.bind(programaCena, quadro->clusterParams);
+
+    drawObjetos();
+}
+
+// ==== DEFERRED ====
+void drawGBuffer() {
+    programaCena = gbufferShader;
+    glUseProgram(programaCena);
+    glUniformMatrix4fv(glGetUniformLocation(programaCena, "view"), 1, GL_FALSE, value_ptr(quadro->view));
+    glUniformMatrix4fv(glGetUniformLocation(programaCena, "projection"), 1, GL_FALSE, value_ptr(quadro->proj));
+    drawObjetos();
+}
+
+// Liga as texturas do G-buffer (unidades 0..3) e os uniforms comuns dos passes de iluminação
+void bindGBuffer(GLuint programa, FrameGraphContext& ctx) {
+    const int recursos[4] = { gAlbedo, gNormal, gMaterial, gDepth };
+    const char* nomes[4] = { "gAlbedo", "gNormal", "gMaterial", "gDepth" };
+    glUseProgram(programa);
+    for (int i = 0; i < 4; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, ctx.texture(recursos[i]));
+        glUniform1i(glGetUniformLocation(programa, nomes[i]), i);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    mat4 invViewProj = inverse(quadro->proj * quadro->view);
+    glUniformMatrix4fv(glGetUniformLocation(programa, "invViewProj"), 1, GL_FALSE, value_ptr(invViewProj));
+    glUniform2f(glGetUniformLocation(programa, "screenSize"), (float)ctx.width(), (float)ctx.height());
+    glUniform3fv(glGetUniformLocation(programa, "viewPos"), 1, value_ptr(quadro->viewPos));
+}
+
+void drawDeferredSpot(FrameGraphContext& ctx) {
+    bindGBuffer(deferredSpotShader, ctx);
+    glUniform3fv(glGetUniformLocation(deferredSpotShader, "lightPos"), 1, value_ptr(quadro->lightPos));
+    glUniform3fv(glGetUniformLocation(deferredSpotShader, "lightColor"), 1, value_ptr(quadro->lightColor));
+    glUniform3fv(glGetUniformLocation(deferredSpotShader, "lightDir"), 1, value_ptr(quadro->lightDir));
+    bindSombra(deferredSpotShader);
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+// Um quad por luz (6 vértices, instanciado); o blend aditivo acumula as contribuições
+void drawDeferredLuzes(FrameGraphContext& ctx) {
+    bindGBuffer(deferredLuzesShader, ctx);
+    glUniformMatrix4fv(glGetUniformLocation(deferredLuzesShader, "view"), 1, GL_FALSE, value_ptr(quadro->view));
+    glUniformMatrix4fv(glGetUniformLocation(deferredLuzesShader, "projection"), 1, GL_FALSE, value_ptr(quadro->proj));
+    glUniform1f(glGetUniformLocation(deferredLuzesShader, "zNear"), quadro->nearPlane);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, clusters.lightsSSBO());
+    glBindVertexArray(quadVAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)quadro->luzes.size());
+}
+
+// Na GPU, o passo da simulação entra no mesmo pass (a query mede compute + desenho)
+void drawParticulas(FrameGraphContext& ctx, bool sobreGBuffer) {
+    if (particulasNaGpu) {
+        GPU_PROFILE_SCOPE("particulas_simulacao");
+        particulasGpu.update(quadro->raio, quadro->dt);
+    }
+    GPU_PROFILE_SCOPE("particulas_desenho");
+    const Settings& conf = *quadro->config;
+    glUseProgram(particulasShader);
+    glUniformMatrix4fv(glGetUniformLocation(particulasShader, "view"), 1, GL_FALSE, value_ptr(quadro->view));
+    glUniformMatrix4fv(glGetUniformLocation(particulasShader, "projection"), 1, GL_FALSE, value_ptr(quadro->proj));
+    glUniform3fv(glGetUniformLocation(particulasShader, "base"), 1, value_ptr(quadro->raio.base));
+    glUniform1f(glGetUniformLocation(particulasShader, "tamanho"), conf.particulas.tamanho);
+    glUniform3f(glGetUniformLocation(particulasShader, "cor"), 0.3f, 1.0f, 0.4f);
+    glUniform1f(glGetUniformLocation(particulasShader, "brilho"), std::min(1.0f, 20000.0f / conf.particulas.quantidade));
+    glUniform1i(glGetUniformLocation(particulasShader, "testarGDepth"), sobreGBuffer);
+    if (sobreGBuffer) {
+        glBindTexture(GL_TEXTURE_2D, ctx.texture(gDepth));
+        glUniform1i(glGetUniformLocation(particulasShader, "gDepth"), 0);
+    }
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    if (particulasNaGpu) {
+        particulasGpu.draw();
+    } else {
+        glBindVertexArray(particulasVAO);
+        glDrawArrays(GL_POINTS, 0, (GLsizei)quadro->particulas.size());
+    }
+    glDisable(GL_PROGRAM_POINT_SIZE);
+}
+
+// Liga os passes do renderer escolhido; o frame graph descarta o resto
+void selecionarRenderer(bool deferred, bool demoLuzes, bool sombraAtiva, bool mostrarOclusao) {
+    frameGraph.setEnabled(passCena, !deferred);
+    frameGraph.setEnabled(passGBuffer, deferred);
+    frameGraph.setEnabled(passDeferredSpot, deferred);
+    frameGraph.setEnabled(passDeferredLuzes, deferred && demoLuzes);
+    frameGraph.setEnabled(passSombra, sombraAtiva);
+    frameGraph.setEnabled(passParticulas, particulasAtivas && !deferred);
+    frameGraph.setEnabled(passParticulasDeferred, particulasAtivas && deferred);
+    frameGraph.setEnabled(passOclusaoDebug, mostrarOclusao);
+}
+
+// Redimensiona o G-buffer junto com a janela
+void redimensionarGBuffer(int width, int height) {
+    const int recursos[4] = { gAlbedo, gNormal, gMaterial, gDepth };
+    const GLenum formatos[4] = { GL_RGBA8, GL_RG16F, GL_RGBA8, GL_DEPTH24_STENCIL8 };
+    for (int i = 0; i < 4; i++) {
+        FrameGraphTextureDesc desc;
+        desc.width = width;
+        desc.height = height;
+        desc.internalFormat = formatos[i];
+        desc.filter = GL_NEAREST;
+        frameGraph.setTextureDesc(recursos[i], desc);
+    }
+}
+
+// Custo do pass de sombra no modo atual do cache: GPU pela query do frame graph, CPU medida no SpotShadowMap
+void relatorioSombra() {
+    const ShadowStats& st = sombraSpot.stats();
+    if (st.frames == 0)
+        return;
+    char linha[256];
+    snprintf(linha, sizeof(linha),
+             "[sombra] cache %s: GPU %.3f ms/frame, CPU %.3f ms/frame em %d frames (estatica %dx, dinamica %dx, reaproveitada %dx)",
+             sombraSpot.cacheEnabled ? "ligado" : "desligado", frameGraph.gpuTimeMs(passSombra), st.cpuMs / st.frames, st.frames,
+             st.staticRenders, st.dynamicRenders, st.skipped);
+    cout << linha << endl;
+}
+
+// Custo por frame das partículas: na GPU o pass inteiro (query do frame graph); na CPU a atualização e o envio
+void relatorioParticulas(bool deferred) {
+    if (!particulasAtivas)
+        return;
+    char linha[256];
+    if (particulasNaGpu) {
+        snprintf(linha, sizeof(linha), "[particulas] GPU: %d vivas de %zu, simulacao + desenho %.3f ms/frame (GPU)",
+                 particulasGpu.aliveCount(), particulasGpu.capacity(),
+                 frameGraph.gpuTimeMs(deferred ? passParticulasDeferred : passParticulas));
+    } else if (particulasFrames > 0) {
+        snprintf(linha, sizeof(linha),
+                 "[particulas] CPU (%d threads): %zu vivas de %zu, atualizacao %.3f ms/frame, envio %.3f ms/frame em %d frames",
+                 particulasCpu.threads(), particulasVivasCpu, particulasCpu.capacity(),
+                 particulasCpuMs / particulasFrames, particulasEnvioMs / particulasFrames, particulasFrames);
+    } else {
+        return;
+    }
+    cout << linha << endl;
+}
+
+// Registra os passes do frame; novos passes entram aqui, sem mudar o loop principal
+void buildFrameGraph(int width, int height) {
+    backbuffer = frameGraph.importFramebuffer("janela", 0, width, height);
+    sombraMapa = frameGraph.importFramebuffer("sombra", sombraSpot.framebuffer(), sombraSpot.resolution(), sombraSpot.resolution());
+
+    // Sem clear: o próprio pass decide o que redesenhar (camadas em cache)
+    RenderState sombra;
+    sombra.polygonOffset = true;
+    sombra.offsetFactor = 2.0f;
+    sombra.offsetUnits = 4.0f;
+    passSombra = frameGraph.addPass("sombra", [&](FrameGraph::Builder& b) {
+        b.write(sombraMapa);
+        b.setState(sombra);
+    }, [](FrameGraphContext&) { drawSombra(); });
+
+    RenderState ceu;
+    ceu.depthTest = false;
+    ceu.clear = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+    frameGraph.addPass("ceu", [&](FrameGraph::Builder& b) {
+        b.write(backbuffer);
+        b.setState(ceu);
+    }, [](FrameGraphContext&) { drawCeu(); });
+
+    RenderState cena;
+    cena.polygonOffset = true;
+    cena.offsetFactor = 2.0f;
+    cena.offsetUnits = 2.0f;
+    passCena = frameGraph.addPass("cena", [&](FrameGraph::Builder& b) {
+        b.read(sombraMapa);
+        b.write(backbuffer);
+        b.setState(cena);
+    }, [](FrameGraphContext&) { drawCena(); });
+
+    // Caminho deferred: geometria uma vez no G-buffer, iluminação em espaço de tela
+    FrameGraphTextureDesc desc;
+    desc.width = width;
+    desc.height = height;
+    desc.filter = GL_NEAREST;
+    desc.internalFormat = GL_RGBA8;
+    gAlbedo = frameGraph.createTexture("gAlbedo", desc);
+    gMaterial = frameGraph.createTexture("gMaterial", desc);
+    desc.internalFormat = GL_RG16F;
+    gNormal = frameGraph.createTexture("gNormal", desc);
+    desc.internalFormat = GL_DEPTH24_STENCIL8;
+    gDepth = frameGraph.createTexture("gDepth", desc);
+
+    RenderState gbuffer = cena;
+    gbuffer.clear = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+    passGBuffer = frameGraph.addPass("gbuffer", [&](FrameGraph::Builder& b) {
+        b.write(gAlbedo);
+        b.write(gNormal);
+        b.write(gMaterial);
+        b.write(gDepth);
+        b.setState(gbuffer);
+    }, [](FrameGraphContext&) { drawGBuffer(); });
+
+    RenderState telaCheia;
+    telaCheia.depthTest = false;
+    telaCheia.depthWrite = false;
+    auto lerGBuffer = [&](FrameGraph::Builder& b) {
+        b.read(gAlbedo);
+        b.read(gNormal);
+        b.read(gMaterial);
+        b.read(gDepth);
+        b.write(backbuffer);
+    };
+    passDeferredSpot = frameGraph.addPass("deferred_spot", [&](FrameGraph::Builder& b) {
+        lerGBuffer(b);
+        b.read(sombraMapa);
+        b.setState(telaCheia);
+    }, [](FrameGraphContext& ctx) { drawDeferredSpot(ctx); });
+
+    RenderState aditivo = telaCheia;
+    aditivo.blend = true;
+    aditivo.blendSrc = GL_ONE;
+    aditivo.blendDst = GL_ONE;
+    passDeferredLuzes = frameGraph.addPass("deferred_luzes", [&](FrameGraph::Builder& b) {
+        lerGBuffer(b);
+        b.setState(aditivo);
+    }, [](FrameGraphContext& ctx) { drawDeferredLuzes(ctx); });
+
+    // Raio trator: aditivo e sem escrever profundidade; no deferred o backbuffer
+    // não tem a profundidade da cena e o teste é contra o gDepth no shader
+    RenderState particulas;
+    particulas.depthWrite = false;
+    particulas.blend = true;
+    particulas.blendSrc = GL_ONE;
+    particulas.blendDst = GL_ONE;
+    passParticulas = frameGraph.addPass("particulas", [&](FrameGraph::Builder& b) {
+        b.write(backbuffer);
+        b.setState(particulas);
+    }, [](FrameGraphContext& ctx) { drawParticulas(ctx, false); });
+    passParticulasDeferred = frameGraph.addPass("particulas_deferred", [&](FrameGraph::Builder& b) {
+        b.read(gDepth);
+        b.write(backbuffer);
+        b.setState(particulas);
+    }, [](FrameGraphContext& ctx) { drawParticulas(ctx, true); });
+
+    RenderState overlay;
+    overlay.depthTest = false;
+    overlay.viewport[2] = overlay.viewport[3] = 1.0f / 3.0f; // canto inferior esquerdo
+    passOclusaoDebug = frameGraph.addPass("oclusao_debug", [&](FrameGraph::Builder& b) {
+        b.write(backbuffer);
+        b.setState(overlay);
+    }, [](FrameGraphContext&) { drawOcclusionDebug(quadro->oclusaoDepth, quadro->nearPlane, quadro->farPlane); });
+
+    frameGraph.enableGpuTimings(true);
+    selecionarRenderer(deferred, demoLuzes, sombraAtiva, false);
+    frameGraph.compile();
+    frameGraph.printSummary();
+}
+
+// ============== THREAD DE RENDER ==============
+// A thread principal fica com a janela, a entrada e a simulação; a de render é
+// dona do contexto GL: envia os dados do pacote, executa o frame graph e troca
+// os buffers. Com renderer.thread = false a principal desenha cada pacote logo
+// depois de publicá-lo (mesma fila, em série), para comparar os tempos.
+
+// O que só a thread do GL usa de um frame para o outro
+struct EstadoRender {
+    GLFWwindow* janela = nullptr;
+    Headless* headless = nullptr;
+    string arquivoTrace;
+    bool traceAoSair = false;
+    float ultimosTempos = 0.0f;
+    bool deferred = false; // do último pacote, para os relatórios do fim
+};
+
+void renderizarQuadro(EstadoRender& r, const FrameData& q) {
+    PROFILE_SCOPE("render");
+    quadro = &q;
+    Profiler::beginGpuFrame();
+    latencia.poll();
+
+    // ==== SOMBRA ====
+    // Só marca o que mudou; o pass "sombra" redesenha as camadas desatualizadas. A
+    // chave é o que drawSombra() põe na camada dinâmica: a vaca e as vacas do rebanho
+    static vector<mat4> casterDinamicos(1);
+    casterDinamicos[0] = q.modelVaca;
+    sombraSpot.update(q.lightPos, q.lightDir, casterDinamicos, q.geracaoRebanho);
+    if (q.alternarCacheSombra) {
+        relatorioSombra();
+        sombraSpot.cacheEnabled = !sombraSpot.cacheEnabled;
+        sombraSpot.resetStats();
+    }
+
+    // ==== ENVIOS ====
+    {
+        PROFILE_SCOPE("envios");
+        if (q.demoLuzes) {
+            if (q.deferred)
+                clusters.uploadLights(q.luzes); // os volumes de luz não precisam das listas por cluster
+            else
+                clusters.upload(q.luzes, q.clusterGrid, q.clusterIndices);
+        }
+        if (rebanhoAtivo)
+            retornoRender.rebanhoUploadMs.store(enviarRebanho(q.vacasRebanho, q.ovnisRebanho), memory_order_relaxed);
+        if (particulasAtivas && !particulasNaGpu)
+            enviarParticulasCpu(q.particulas, q.particulasMs, q.particulasVivas);
+    }
+
+    // ==== DESENHO ====
+    frameGraph.resizeImported(backbuffer, q.fbW, q.fbH);
+    redimensionarGBuffer(q.fbW, q.fbH);
+    selecionarRenderer(q.deferred, q.demoLuzes, q.sombraAtiva, q.mostrarOclusao);
+    {
+        PROFILE_SCOPE("submissao");
+        frameGraph.execute();
+    }
+    latencia.submitted(q.inputTime, q.latchTime);
+    retornoRender.gpuCenaMs.store(frameGraph.gpuTimeMs(q.deferred ? passGBuffer : passCena), memory_order_relaxed);
+    r.deferred = q.deferred;
+
+    float agora = glfwGetTime();
+    if (q.imprimirTempos || (q.config->renderer.temposGpu && agora - r.ultimosTempos > 2.0f)) {
+        frameGraph.printGpuTimings();
+        relatorioSombra();
+        relatorioParticulas(q.deferred);
+        latencia.printSummary();
+        r.ultimosTempos = agora;
+    }
+
+    if (q.gravarTrace)
+        Profiler::writeChromeTrace(r.arquivoTrace);
+    if (q.exportarEstatisticas)
+        r.headless->frameStats().requestExport();
+
+    {
+        PROFILE_SCOPE("swap");
+        r.headless->swapBuffers(r.janela);
+    }
+    quadro = nullptr;
+}
+
+// Relatórios e recursos que dependem do contexto, ainda na thread do GL
+void encerrarRender(EstadoRender& r) {
+    relatorioSombra();
+    relatorioParticulas(r.deferred);
+    latencia.printSummary();
+    latencia.release();
+    if (r.traceAoSair)
+        Profiler::writeChromeTrace(r.arquivoTrace);
+    Profiler::releaseGpu();
+}
+
+void threadDeRender(EstadoRender* r) {
+    Profiler::setThreadName("render");
+    r->headless->bindContext(r->janela);
+    while (const FrameData* q = filaQuadros.beginRead()) {
+        r->headless->frameStats().workBegin();
+        renderizarQuadro(*r, *q);
+        filaQuadros.endRead();
+    }
+    encerrarRender(*r);
+    r->headless->releaseContext();
+}
+
+int main(int argc, char** argv) {
+    Headless headless(argc, argv);
+    headless.initHints();
     glfwInit();
     loadConfig("config.ini");
+    cfg.refresh();
+    casaLuz = cfg->estadoInicial.casaLuz;
+    // Pool de jobs (carregamento, culling, clusters, rebanho) com a thread principal como dona
+    JobSystem::configure(cfg->jobs.threads - 1);
+    cout << "[jobs] " << JobSystem::global().threadCount() << " threads" << endl;
+    if (!headless.isEnabled())
+        configWatcher.start("config.ini"); // no headless a configuração fica fixa (capturas reproduzíveis)
     GLFWwindow* w;
+    headless.windowHints();
     carregarJanela(w);
-    glfwMakeContextCurrent(w);
-    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    headless.makeCurrent(w);
+    gladLoadGLLoader(headless.loader());
+    shaderCache.init(headless.loader(), cfg->shaderCache.dir);
+    shaderManager.init(headless.loader(), &shaderCache);
+    escolherModoParticulas(headless.loader());
+    compileShaders();
+    Profiler::setThreadName("principal");
+    Profiler::setEnabled(cfg->profiler.ativo);
+    Profiler::initGpu();
+    string arquivoTrace = cfg->profiler.arquivo;
+    bool traceAoSair = false;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--trace") {
+            arquivoTrace = argv[i + 1];
+            traceAoSair = true;
+        }
+    }
     glfwSetInputMode(w, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-    glfwSetCursorPosCallback(w, mouse_callback);
-
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_POLYGON_OFFSET_FILL);
-    glPolygonOffset(2.0f, 2.0f);
-
-    shaderProgram = compileShader();
-
-    float alturaAbducao = getFloat("alturas.abducao", 5.0f);
-    float alturaFuga = getFloat("alturas.fuga", 15.0f);
-    float curvaAmplitude = getFloat("curvas.amplitude", 1.0f); // raio da curva no plano XZ
+    bindInput(w);
+    latencia.init();
 
     initSkybox();
+    initOcclusion();
+
+    demoLuzes = cfg->luzes.demo;
+    clusters.init(cfg->luzes.threads);
+    initLuzesDemo(cfg->luzes.varredura ? 64 : cfg->luzes.quantidade);
 
-    loadModel(getString("modelo_paths.ovni", "../assets/Modelos3D/final/Nave.obj"), ovni);
-    loadModel(getString("modelo_paths.vaca", "../assets/Modelos3D/final/vaca.obj"), vaca);
-    loadModel(getString("modelo_paths.casa", "../assets/Modelos3D/final/casa.obj"), casa);
+    loadModels({ { cfg->modeloPaths.ovni, &ovni }, { cfg->modeloPaths.vaca, &vaca }, { cfg->modeloPaths.casa, &casa } });
+    shaderManager.poll();
 
     // ==== CHÃO ====
     vector<Vertex> chaoVerts = {
@@ -588,11 +2006,8 @@ int main() {
         {{-50.0f, 0.0f,  50.0f}, {0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
     };
     chao.vertexCount = chaoVerts.size();
-    chao.textura = loadTexture(getString("texturas.textura_chao", "../assets/Modelos3D/final/grama.png"));
-    chao.material.ka = getVec3("chao_ka", vec3(0.2f));
-    chao.material.kd = getVec3("chao_kd", vec3(0.8f));
-    chao.material.ks = getVec3("chao_ks", vec3(0.1f));
-    chao.material.shininess = getFloat("chao_shininess", 8.0f);
+    chao.textura = loadTexture(cfg->texturas.chao);
+    aplicarConfigAoVivo();
     glGenVertexArrays(1, &chao.VAO);
     glGenBuffers(1, &chao.VBO);
     glBindVertexArray(chao.VAO);
@@ -604,139 +2019,298 @@ int main() {
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
     glEnableVertexAttribArray(2);
+    chao.aabbMin = vec3(-50.0f, 0.0f, -50.0f);
+    chao.aabbMax = vec3(50.0f, 0.0f, 50.0f);
+
+    resolveShaders();
+    initParticulas(headless.loader());
+
+    int fbW, fbH;
+    glfwGetFramebufferSize(w, &fbW, &fbH);
+    deferred = cfg->renderer.deferred;
+    sombraAtiva = cfg->sombra.ativa;
+    sombraSpot.cacheEnabled = cfg->sombra.cache;
+    sombraSpot.init(cfg->sombra.resolucao);
+    buildFrameGraph(fbW, fbH);
 
     // ==== ESTADOS INICIAIS ====
-    const float ovniTopo = getFloat("estado_inicial.ovni_topo", (alturaFuga + 5.0f));
-    const float ovniBaixo = getFloat("estado_inicial.ovni_baixo", (alturaAbducao + 1.5f));
-    float ovniY = getFloat("estado_inicial.ovniY", ovniTopo);
-    float vacaY = getFloat("estado_inicial.vacaY", 0.0f);
-    float vacaX = getFloat("estado_inicial.vacaX", 0.0f);
-    float vacaRot = getFloat("estado_inicial.vaca_rot", 0.0f);
-
-    while (!glfwWindowShouldClose(w)) {
-        processInput(w);
-        glfwPollEvents();
-        float t = glfwGetTime();
-
-        float baseSpeed = 1.5f;
-        float vacaDist = alturaAbducao - vacaY;
-        float ovniDist = ovniY - ovniBaixo;
-        float ovniSpeed = (vacaDist > 0.01f && ovniDist > 0.01f) ? baseSpeed * (ovniDist / vacaDist) : baseSpeed;
+    // Alturas e curva do config.ini entram como parâmetros dos clips
+    map<string, float> paramsAnimacao = {
+        { "abducao", cfg->alturas.abducao },
+        { "ovni_topo", cfg->estadoInicial.ovniTopo },
+        { "ovni_baixo", cfg->estadoInicial.ovniBaixo },
+        { "amplitude", cfg->curvas.amplitude }, // raio da curva no plano XZ
+    };
+    if (!animacoes.load(cfg->animacao.arquivo, paramsAnimacao) || !clipsAbducao.resolve(animacoes)) {
+        glfwTerminate();
+        return -1;
+    }
+    // O clip do estado inicial entra na altura da vaca, sem mistura; H troca de clip
+    AnimationPlayer abducao;
+    clipsAbducao.start(abducao, animacoes, casaLuz, cfg->estadoInicial.vacaY);
+    int clipAlvo = abducao.clip();
+    EstadoSim atual = poseParaEstado(abducao.pose(), 0.0f);
+    EstadoSim anterior = atual;
+
+    rebanhoAtivo = cfg->rebanho.ativo;
+    if (rebanhoAtivo) {
+        initRebanho(cfg->rebanho.vacas, cfg->rebanho.ovnis);
+        criarBuffersRebanho();
+    }
 
-        if (casaLuz) {
-            if (ovniY < ovniTopo)
-                ovniY += ovniSpeed * deltaTime;
-            else
-                ovniY = ovniTopo;
-            if (vacaY > 0.0f) {
-                vacaY -= baseSpeed * deltaTime;
-
-                // Aplica rotação decrescente na vaca durante a queda
-                if (vacaY < alturaAbducao) {
-                    vacaRot += 5.0f * deltaTime;  // controla a velocidade da rotação
-                    if (vacaRot > glm::radians(720.0f)) // no máximo 2 voltas
-                        vacaRot = glm::radians(720.0f);
+    // ==== SIMULAÇÃO ====
+    // Um passo fixo da abdução (os mesmos clips das vacas do rebanho, Herd.h); só
+    // roda dentro do laço do acumulador. H (casaLuz) troca para a queda ou a abdução.
+    auto simular = [&](EstadoSim& e, float dt) {
+        int alvo = casaLuz ? clipsAbducao.release : clipsAbducao.abduct;
+        if (alvo != clipAlvo) {
+            clipAlvo = alvo;
+            abducao.play(alvo);
+        }
+        abducao.advance(dt);
+        e = poseParaEstado(abducao.pose(), e.tempo + dt);
+    };
+
+    FixedTimestep relogio(argc, argv, 1.0 / cfg->simulacao.hz);
+    relogio.setMaxSteps(cfg->simulacao.maxPassos);
+
+    // O contexto passa para a thread de render; daqui em diante esta thread não chama GL
+    EstadoRender estadoRender;
+    estadoRender.janela = w;
+    estadoRender.headless = &headless;
+    estadoRender.arquivoTrace = arquivoTrace;
+    estadoRender.traceAoSair = traceAoSair;
+    bool threadRender = cfg->renderer.thread;
+    thread render;
+    if (threadRender) {
+        headless.releaseContext();
+        render = thread(threadDeRender, &estadoRender);
+    }
+
+    // No headless a simulação para no mesmo quadro que o render (--frames): estado final reproduzível
+    int quadrosPublicados = 0;
+    while (!glfwWindowShouldClose(w) && (headless.frameLimit() <= 0 || quadrosPublicados < headless.frameLimit())) {
+        PROFILE_SCOPE("frame");
+        FrameData* pacote;
+        {
+            PROFILE_SCOPE("fila"); // espera se o render estiver com os três pacotes
+            pacote = &filaQuadros.beginWrite();
+        }
+        FrameData& q = *pacote;
+        relogio.beginFrame(glfwGetTime());
+        deltaTime = (float)relogio.frameDelta();
+        {
+            PROFILE_SCOPE("entrada");
+            glfwPollEvents();
+            processInput();
+        }
+        float agora = glfwGetTime(); // relógio real: título, relatórios e medições
+
+        // Snapshot do config.ini: só troca depois de um hot reload
+        if (cfg.refresh())
+            aplicarConfigAoVivo();
+
+        double simRebanhoMs = 0.0;
+        {
+            PROFILE_SCOPE("simulacao");
+            while (relogio.step()) {
+                anterior = atual;
+                simular(atual, (float)relogio.stepSize());
+                if (rebanhoAtivo) {
+                    rebanho.step((float)relogio.stepSize());
+                    simRebanhoMs += rebanho.stats().stepMs;
                 }
-            } else {
-                vacaY = 0.0f;
-                vacaRot = 0.0f; // reseta rotação quando toca o chão
-            }            
-        } else {
-            if (ovniY > ovniBaixo)
-                ovniY -= ovniSpeed * deltaTime;
-            else
-                ovniY = ovniBaixo;
-
-            if (vacaY < alturaAbducao) {
-                vacaY += baseSpeed * deltaTime;
-                vacaX = sin(t * 2.0f) * 0.5f; // curva suave em X
-            } else {
-                vacaY = alturaAbducao;
-                vacaX = 0.0f;
             }
         }
+        if (rebanhoAtivo) {
+            PROFILE_SCOPE("rebanho");
+            rebanho.buildMatrices((float)relogio.alpha());
+            rebanho.swapModels(q.vacasRebanho, q.ovnisRebanho);
+            q.geracaoRebanho = rebanho.cowMatricesGeneration();
+        }
 
-        // ==== DESENHO DO FUNDO ====
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glDisable(GL_DEPTH_TEST);
-        glUseProgram(skyboxShader);
-        glBindVertexArray(quadVAO);
-        glBindTexture(GL_TEXTURE_2D, skyboxTexture);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glEnable(GL_DEPTH_TEST);
-
-        // ==== SHADER PRINCIPAL ====
-        glUseProgram(shaderProgram);
-        mat4 proj = perspective(radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+        // O frame mostra o estado entre os dois últimos passos
+        EstadoSim estado = interpolar(anterior, atual, (float)relogio.alpha());
+        float t = estado.tempo;
+        float ovniY = estado.ovniY, vacaY = estado.vacaY;
+
+        // ==== CÂMERA ====
+        // Aspecto do framebuffer (no headless, o tamanho da saída); minimizada ele é 0x0
+        glfwGetFramebufferSize(w, &fbW, &fbH);
+        float aspecto = fbW > 0 && fbH > 0 ? (float)fbW / fbH : 800.0f / 600.0f;
+        mat4 proj = perspective(radians(45.0f), aspecto, q.nearPlane, q.farPlane);
         mat4 view = camera.GetViewMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, value_ptr(proj));
 
         // === AJUSTE DE MATERIAIS E LUZ ===
         vec3 vacaPos = vec3(0, vacaY, 0);
+        vec3 lightColor, lightPos, lightDir;
 
         if (casaLuz) {
-            ka = getVec3("luz_casa.ka", vec3(0.2f));
-            kd = getVec3("luz_casa.kd", vec3(1.5f));
-            ks = getVec3("luz_casa.ks", vec3(0.3f));
+            ka = cfg->luzCasa.ka;
+            kd = cfg->luzCasa.kd;
+            ks = cfg->luzCasa.ks;
             lightColor = vec3(1.0f);
             lightPos = vec3(5.0f, 1.5f, -6.5f); // dentro da casa
-            vec3 dir = normalize(vacaPos - lightPos);
-            glUniform3fv(glGetUniformLocation(shaderProgram, "lightDir"), 1, value_ptr(dir));
+            lightDir = normalize(vacaPos - lightPos);
         } else {
-            ka = getVec3("luz_ovni.ka", vec3(0.05f, 0.2f, 0.05f));
-            kd = getVec3("luz_ovni.kd", vec3(0.2f, 1.0f, 0.2f));
-            ks = getVec3("luz_ovni.ks", vec3(0.1f, 0.8f, 0.1f));
+            ka = cfg->luzOvni.ka;
+            kd = cfg->luzOvni.kd;
+            ks = cfg->luzOvni.ks;
             lightColor = vec3(0.0f, 1.0f, 0.0f);
             lightPos = vec3(0, ovniY - 1.0f, 0);
-            vec3 dir = normalize(vec3(0, -1, 0));
-            glUniform3fv(glGetUniformLocation(shaderProgram, "lightDir"), 1, value_ptr(dir));
+            lightDir = normalize(vec3(0, -1, 0));
         }
 
-        glUniform3fv(glGetUniformLocation(shaderProgram, "viewPos"), 1, value_ptr(camera.position));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "lightPos"), 1, value_ptr(lightPos));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "lightColor"), 1, value_ptr(lightColor));
-
-        // ==== DESENHO ====
-        auto draw = [&](Modelo& m, mat4 model) {
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, value_ptr(model));
-            
-            for (const Submesh& sub : m.partes) {
-                glUniform3fv(glGetUniformLocation(shaderProgram, "ka"), 1, value_ptr(sub.material.ka));
-                glUniform3fv(glGetUniformLocation(shaderProgram, "kd"), 1, value_ptr(sub.material.kd));
-                glUniform3fv(glGetUniformLocation(shaderProgram, "ks"), 1, value_ptr(sub.material.ks));
-                glUniform1f(glGetUniformLocation(shaderProgram, "shininess"), sub.material.shininess);
-
-                glBindVertexArray(sub.VAO);
-                glBindTexture(GL_TEXTURE_2D, sub.textureID);
-                glDrawArrays(GL_TRIANGLES, 0, sub.vertexCount);
+        // ==== TRANSFORMAÇÕES ====
+        // Partes do ovni que giram sozinhas; o modelo inteiro ainda gira com o tempo
+        animarPartesOvni(t);
+        mat4 modelOvni = ufoModel(vec3(0.0f), ovniY, t);
+        mat4 modelCasa = translate(mat4(1.0f), vec3(5, 0, -5));
+        // Na subida a vaca balança, no alto faz um oito no plano XZ e na queda gira
+        vec3 posVaca = vec3(0.0f, vacaY, 0.0f) + estado.vacaDesloc;
+        mat4 modelVaca = cowModel(vec3(0.0f), vacaY, estado.vacaDesloc, estado.vacaRot);
+
+        // ==== OCCLUSION CULLING ====
+        // Casa e chão são rasterizados no buffer de oclusão; ovni e vaca são testados pela AABB
+        occlusion.beginFrame(proj * view);
+        if (occlusionAtiva || mostrarOclusao) {
+            PROFILE_SCOPE("oclusao");
+            for (const Submesh& sub : casa.partes) {
+                if (sub.vertices.empty()) // grupo o/usemtl sem faces
+                    continue;
+                occlusion.addOccluder(value_ptr(sub.vertices[0].position), sizeof(Vertex), sub.vertices.size(), modelCasa);
             }
+            occlusion.addOccluder(value_ptr(chaoVerts[0].position), sizeof(Vertex), chaoVerts.size(), mat4(1.0f));
+            occlusion.rasterizeOccluders();
+        }
+        auto visivel = [&](const Modelo& m, const mat4& model) {
+            bool v = occlusion.testAABB(m.aabbMin, m.aabbMax, model);
+            return v || !occlusionAtiva;
         };
+        if (mostrarOclusao)
+            occlusion.resolveDepth(q.oclusaoDepth);
+
+        // ==== LUZES CLUSTERIZADAS ====
+        // Atribuição aqui; o envio para os SSBOs fica com o render
+        if (demoLuzes) {
+            PROFILE_SCOPE("luzes");
+            static int clusterW = 0, clusterH = 0;
+            if (fbW != clusterW || fbH != clusterH) {
+                clusters.setProjection(proj, q.nearPlane, q.farPlane, fbW, fbH);
+                clusterW = fbW;
+                clusterH = fbH;
+            }
+            atualizarLuzesDemo(t, posVaca);
+            q.luzes = luzesDemo;
+            q.clusterParams = clusters.shaderParams();
+            if (!deferred) {
+                clusters.assign(luzesDemo, view);
+                clusters.swapLists(q.clusterGrid, q.clusterIndices);
+            }
+        }
 
-        drawChao(chao, mat4(1.0f));
-        draw(ovni, translate(mat4(1.0f), vec3(0, ovniY, 0)) * rotate(mat4(1.0f), t, vec3(0, 1, 0)));
-        draw(casa, translate(mat4(1.0f), vec3(5, 0, -5)));
+        // ==== LATE LATCH ====
+        // O mouse que chegou durante a simulação e o culling entra aqui, logo antes
+        // de publicar o pacote. Oclusão e clusters usaram a view do início do frame:
+        // um frame de giro de diferença, imperceptível nas bordas.
+        {
+            PROFILE_SCOPE("latch");
+            input.latch();
+            vec2 giro = input.takeMouseDelta();
+            if (giro != vec2(0.0f)) {
+                camera.Rotate(giro.x, giro.y);
+                view = camera.GetViewMatrix();
+            }
+        }
 
-        vec3 posVaca;
-        if (!casaLuz && vacaY >= alturaAbducao) {
-            float curvaT = t * 2.0f; // velocidade da curva
-            float vacaX = curvaAmplitude * sin(curvaT);
-            float vacaZ = curvaAmplitude * sin(curvaT) * cos(curvaT);
-            posVaca = vec3(vacaX, vacaY, vacaZ);
-        } else {
-            posVaca = vec3(vacaX, vacaY, 0);
+        // ==== PARTÍCULAS ====
+        // Na GPU o passo roda no pass "particulas"; aqui só o fallback em CPU
+        if (particulasAtivas) {
+            atualizarRaio(ovniY);
+            q.raio = raio;
+            q.dt = deltaTime;
+            if (!particulasNaGpu) {
+                PROFILE_SCOPE("particulas");
+                particulasCpu.update(raio, deltaTime);
+                particulasCpu.swapOutput(q.particulas);
+                q.particulasMs = particulasCpu.updateMs;
+                q.particulasVivas = particulasCpu.aliveCount();
+            }
         }
-        
-        mat4 modelVaca = translate(mat4(1.0f), posVaca);
-        // Aplica rotação na vaca apenas quando estiver caindo (casaLuz == true)
-        if (casaLuz && vacaY < alturaAbducao && vacaY > 0.0f)
-            modelVaca = modelVaca * rotate(mat4(1.0f), vacaRot, vec3(1, 0, 0));
 
-        draw(vaca, modelVaca);
+        // ==== PACOTE ====
+        q.view = view;
+        q.proj = proj;
+        q.viewPos = camera.position;
+        q.modelOvni = modelOvni;
+        q.modelCasa = modelCasa;
+        q.modelVaca = modelVaca;
+        q.ovniVisivel = visivel(ovni, modelOvni);
+        q.vacaVisivel = visivel(vaca, modelVaca);
+        q.mundosOvni.resize(ovni.grafo.size());
+        for (int no = 0; no < ovni.grafo.size(); no++)
+            q.mundosOvni[no] = ovni.grafo.world(no);
+        q.lightColor = lightColor;
+        q.lightPos = lightPos;
+        q.lightDir = lightDir;
+        q.materialChao = chao.material;
+        q.fbW = fbW;
+        q.fbH = fbH;
+        q.inputTime = input.takeFrameInputTime();
+        q.latchTime = input.lastLatchTime();
+        q.config = cfg.shared();
+        q.deferred = deferred;
+        q.demoLuzes = demoLuzes;
+        q.sombraAtiva = sombraAtiva;
+        q.mostrarOclusao = mostrarOclusao;
+        q.alternarCacheSombra = alternarCacheSombra;
+        q.imprimirTempos = imprimirTempos;
+        q.gravarTrace = gravarTrace;
+        q.exportarEstatisticas = exportarEstatisticas;
+        alternarCacheSombra = imprimirTempos = gravarTrace = exportarEstatisticas = false;
+        filaQuadros.publish();
+        quadrosPublicados++;
+
+        if (!threadRender) {
+            renderizarQuadro(estadoRender, *filaQuadros.beginRead());
+            filaQuadros.endRead();
+        }
+
+        // Contagem de objetos ocultos no título da janela
+        static float ultimoTitulo = 0.0f;
+        if (agora - ultimoTitulo > 0.5f) {
+            const OcclusionStats& st = occlusion.stats();
+            string titulo = cfg->window.title + " | oclusao: " + to_string(st.occluded) + "/" +
+                            to_string(st.tested) + " ocultos, " + to_string(st.occluderTriangles) + " tris oclusores" +
+                            (occlusionAtiva ? "" : " (desligado)");
+            glfwSetWindowTitle(w, titulo.c_str());
+            ultimoTitulo = agora;
+        }
 
-        glfwSwapBuffers(w);
+        // Tempos de GPU e de envio chegam do render com até três frames de atraso
+        static float ultimoFrame = agora;
+        if (demoLuzes)
+            medirLuzes(agora, (agora - ultimoFrame) * 1000.0f);
+        if (rebanhoAtivo)
+            medirRebanho(agora, (agora - ultimoFrame) * 1000.0f, simRebanhoMs,
+                         retornoRender.rebanhoUploadMs.load(memory_order_relaxed),
+                         retornoRender.gpuCenaMs.load(memory_order_relaxed));
+        ultimoFrame = agora;
     }
 
+    // O render termina os pacotes que ainda estão na fila
+    filaQuadros.close();
+    if (threadRender)
+        render.join();
+    else
+        encerrarRender(estadoRender);
+    filaQuadros.printSummary(threadRender ? "thread propria" : "em serie");
+
+    relogio.printSummary();
+    if (relogio.isDeterministic())
+        cout << "[simulacao] estado final: ovniY " << atual.ovniY << ", vacaY " << atual.vacaY << ", deslocamento ("
+             << atual.vacaDesloc.x << ", " << atual.vacaDesloc.z << "), clip "
+             << animacoes.clip(abducao.clip()).name << " em " << abducao.clipTime() << " s" << endl;
     glfwTerminate();
     return 0;
 }
\ No newline at end of file
@@ -2,10 +2,15 @@
 #include <vector>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <Headless.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <ShaderManager.h>
+
 using namespace std;
 
 const GLuint WIDTH = 1000, HEIGHT = 1000;
@@ -44,21 +49,29 @@ void main() {
 
 // Prototipação
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
-GLuint setupShader();
 GLuint setupGeometry();
 
-int main() {
+int main(int argc, char** argv) {
+    Headless headless(argc, argv);
+    headless.initHints();
     glfwInit();
+    headless.windowHints();
     GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Cubo 3D - Kevin", nullptr, nullptr);
-    glfwMakeContextCurrent(window);
+    headless.makeCurrent(window);
     glfwSetKeyCallback(window, key_callback);
-    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    gladLoadGLLoader(headless.loader());
 
     glViewport(0, 0, WIDTH, HEIGHT);
     glEnable(GL_DEPTH_TEST);
 
-    GLuint shaderProgram = setupShader();
+    // Compila em paralelo com a criação da geometria
+    ShaderManager shaders;
+    shaders.init(headless.loader());
+    int programa = shaders.add("cubo3d", vertexShaderSource, fragmentShaderSource);
     GLuint VAO = setupGeometry();
+    shaders.waitAll();
+    GLuint shaderProgram = shaders.program(programa);
+    shaders.report();
     GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
     GLint viewLoc = glGetUniformLocation(shaderProgram, "view");
     GLint projLoc = glGetUniformLocation(shaderProgram, "projection");
@@ -105,7 +118,7 @@ int main() {
             glDrawArrays(GL_TRIANGLES, 0, 36);
         }
 
-        glfwSwapBuffers(window);
+        headless.swapBuffers(window);
     }
 
     glDeleteVertexArrays(1, &VAO);
@@ -132,25 +145,6 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     }
 }
 
-GLuint setupShader() {
-    GLuint vShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vShader);
-
-    GLuint fShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fShader);
-
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vShader);
-    glAttachShader(shaderProgram, fShader);
-    glLinkProgram(shaderProgram);
-
-    glDeleteShader(vShader);
-    glDeleteShader(fShader);
-    return shaderProgram;
-}
-
 GLuint setupGeometry() {
     GLfloat vertices[] = {
         // Frente - Vermelho
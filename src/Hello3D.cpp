@@ -18,6 +18,11 @@
  // GLFW
  #include <GLFW/glfw3.h>
  
+ #define STB_IMAGE_WRITE_IMPLEMENTATION
+ #include <Headless.h>
+
+ #include <ShaderManager.h>
+ 
  //GLM
  #include <glm/glm.hpp>
  #include <glm/gtc/matrix_transform.hpp>
@@ -28,7 +33,6 @@
  void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
  
  // Protótipos das funções
- int setupShader();
  int setupGeometry();
  
  // Dimensões da janela (pode ser alterado em tempo de execução)
@@ -59,9 +63,11 @@
  bool rotateX=false, rotateY=false, rotateZ=false;
  
  // Função MAIN
- int main()
+ int main(int argc, char** argv)
  {
 	 // Inicialização da GLFW
+	 Headless headless(argc, argv);
+	 headless.initHints();
 	 glfwInit();
  
 	 //Muita atenção aqui: alguns ambientes não aceitam essas configurações
@@ -78,14 +84,15 @@
  //#endif
  
 	 // Criação da janela GLFW
+	 headless.windowHints();
 	 GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Ola 3D -- Kevin!", nullptr, nullptr);
-	 glfwMakeContextCurrent(window);
+	 headless.makeCurrent(window);
  
 	 // Fazendo o registro da função de callback para a janela GLFW
 	 glfwSetKeyCallback(window, key_callback);
  
 	 // GLAD: carrega todos os ponteiros d funções da OpenGL
-	 if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	 if (!gladLoadGLLoader(headless.loader()))
 	 {
 		 std::cout << "Failed to initialize GLAD" << std::endl;
  
@@ -103,13 +110,19 @@
 	 glViewport(0, 0, width, height);
  
  
-	 // Compilando e buildando o programa de shader
-	 GLuint shaderID = setupShader();
+	 // Compilando e buildando o programa de shader (em paralelo com a geometria)
+	 ShaderManager shaders;
+	 shaders.init(headless.loader());
+	 int programa = shaders.add("hello3d", vertexShaderSource, fragmentShaderSource);
  
 	 // Gerando um buffer simples, com a geometria de um triângulo
 	 GLuint VAO = setupGeometry();
  
  
+	 shaders.waitAll();
+	 GLuint shaderID = shaders.program(programa);
+	 shaders.report();
+
 	 glUseProgram(shaderID);
  
 	 glm::mat4 model = glm::mat4(1); //matriz identidade;
@@ -167,7 +180,7 @@
 		 glBindVertexArray(0);
  
 		 // Troca os buffers da tela
-		 glfwSwapBuffers(window);
+		 headless.swapBuffers(window);
 	 }
 	 // Pede pra OpenGL desalocar os buffers
 	 glDeleteVertexArrays(1, &VAO);
@@ -209,54 +222,6 @@
  
  }
  
- //Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
- // shader simples e único neste exemplo de código
- // O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
- // fragmentShader source no iniçio deste arquivo
- // A função retorna o identificador do programa de shader
- int setupShader()
- {
-	 // Vertex shader
-	 GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	 glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	 glCompileShader(vertexShader);
-	 // Checando erros de compilação (exibição via log no terminal)
-	 GLint success;
-	 GLchar infoLog[512];
-	 glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	 if (!success)
-	 {
-		 glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		 std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-	 }
-	 // Fragment shader
-	 GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	 glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	 glCompileShader(fragmentShader);
-	 // Checando erros de compilação (exibição via log no terminal)
-	 glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	 if (!success)
-	 {
-		 glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		 std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-	 }
-	 // Linkando os shaders e criando o identificador do programa de shader
-	 GLuint shaderProgram = glCreateProgram();
-	 glAttachShader(shaderProgram, vertexShader);
-	 glAttachShader(shaderProgram, fragmentShader);
-	 glLinkProgram(shaderProgram);
-	 // Checando por erros de linkagem
-	 glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	 if (!success) {
-		 glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		 std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-	 }
-	 glDeleteShader(vertexShader);
-	 glDeleteShader(fragmentShader);
- 
-	 return shaderProgram;
- }
- 
  // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a 
  // geometria de um triângulo
  // Apenas atributo coordenada nos vértices
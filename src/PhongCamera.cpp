@@ -15,6 +15,11 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <Headless.h>
+
+#include <ShaderManager.h>
+
 using namespace std;
 using namespace glm;
 
@@ -125,22 +130,6 @@ void main() {
     FragColor = vec4(result, 1.0);
 })";
 
-GLuint compileShader() {
-    GLuint vShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vShader);
-    GLuint fShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fShader);
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vShader);
-    glAttachShader(program, fShader);
-    glLinkProgram(program);
-    glDeleteShader(vShader);
-    glDeleteShader(fShader);
-    return program;
-}
-
 GLuint loadTexture(const string& path) {
     int w, h, ch;
     unsigned char* data = stbi_load(path.c_str(), &w, &h, &ch, 0);
@@ -253,22 +242,32 @@ void processInput(GLFWwindow* window) {
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) camera.Move("RIGHT", deltaTime);
 }
 
-int main() {
+int main(int argc, char** argv) {
+    Headless headless(argc, argv);
+    headless.initHints();
     glfwInit();
+    headless.windowHints();
     GLFWwindow* window = glfwCreateWindow(800, 600, "Phong + Camera - Kevin", nullptr, nullptr);
-    glfwMakeContextCurrent(window);
-    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    headless.makeCurrent(window);
+    gladLoadGLLoader(headless.loader());
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetCursorPosCallback(window, mouse_callback);
     glEnable(GL_DEPTH_TEST);
 
-    shaderProgram = compileShader();
+    // Compila em paralelo com o carregamento do modelo
+    ShaderManager shaders;
+    shaders.init(headless.loader());
+    int programa = shaders.add("phong_camera", vertexShaderSource, fragmentShaderSource);
     if (!loadOBJWithMTL("../assets/Modelos3D/Cube.obj", "../assets/Modelos3D")) {
         cerr << "Erro ao carregar modelo." << endl;
         return -1;
     }
 
+    shaders.waitAll();
+    shaderProgram = shaders.program(programa);
+    shaders.report();
+
     setupBuffers();
     glUseProgram(shaderProgram);
     glUniform1i(glGetUniformLocation(shaderProgram, "texBuff"), 0);
@@ -302,7 +301,7 @@ int main() {
         glUniform3fv(glGetUniformLocation(shaderProgram, "viewPos"), 1, value_ptr(camera.position));
 
         glDrawArrays(GL_TRIANGLES, 0, vertices.size());
-        glfwSwapBuffers(window);
+        headless.swapBuffers(window);
     }
 
     glfwTerminate();
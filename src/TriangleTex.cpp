@@ -28,6 +28,11 @@
  #define STB_IMAGE_IMPLEMENTATION
  #include <stb_image.h>
  
+ #define STB_IMAGE_WRITE_IMPLEMENTATION
+ #include <Headless.h>
+
+ #include <ShaderManager.h>
+ 
  using namespace glm;
  
  #include <cmath>
@@ -36,7 +41,6 @@
  void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
  
  // Protótipos das funções
- int setupShader();
  int setupGeometry();
  GLuint loadTexture(string filePath, int &width, int &height);
  
@@ -71,9 +75,11 @@
  })";
  
  // Função MAIN
- int main()
+ int main(int argc, char** argv)
  {
 	 // Inicialização da GLFW
+	 Headless headless(argc, argv);
+	 headless.initHints();
 	 glfwInit();
  
 	 // Muita atenção aqui: alguns ambientes não aceitam essas configurações
@@ -90,14 +96,15 @@
 	 // #endif
  
 	 // Criação da janela GLFW
+	 headless.windowHints();
 	 GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Triangulo Texturizado!", nullptr, nullptr);
-	 glfwMakeContextCurrent(window);
+	 headless.makeCurrent(window);
  
 	 // Fazendo o registro da função de callback para a janela GLFW
 	 glfwSetKeyCallback(window, key_callback);
  
 	 // GLAD: carrega todos os ponteiros d funções da OpenGL
-	 if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	 if (!gladLoadGLLoader(headless.loader()))
 	 {
 		 std::cout << "Failed to initialize GLAD" << std::endl;
 	 }
@@ -113,8 +120,10 @@
 	 glfwGetFramebufferSize(window, &width, &height);
 	 glViewport(0, 0, width, height);
  
-	 // Compilando e buildando o programa de shader
-	 GLuint shaderID = setupShader();
+	 // Compilando e buildando o programa de shader (em paralelo com a geometria e a textura)
+	 ShaderManager shaders;
+	 shaders.init(headless.loader());
+	 int programa = shaders.add("triangulo_textura", vertexShaderSource, fragmentShaderSource);
  
 	 // Gerando um buffer simples, com a geometria de um triângulo
 	 GLuint VAO = setupGeometry();
@@ -123,6 +132,10 @@
 	 int imgWidth, imgHeight;
 	 GLuint texID = loadTexture("../assets/tex/pixelWall.png",imgWidth,imgHeight);
  
+	 shaders.waitAll();
+	 GLuint shaderID = shaders.program(programa);
+	 shaders.report();
+
 	 glUseProgram(shaderID);
  
 	 // Enviar a informação de qual variável armazenará o buffer da textura
@@ -166,7 +179,7 @@
 		 glBindVertexArray(0); // Desconectando o buffer de geometria
  
 		 // Troca os buffers da tela
-		 glfwSwapBuffers(window);
+		 headless.swapBuffers(window);
 	 }
 	 // Pede pra OpenGL desalocar os buffers
 	 glDeleteVertexArrays(1, &VAO);
@@ -184,58 +197,6 @@
 		 glfwSetWindowShouldClose(window, GL_TRUE);
  }
  
- // Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
- //  shader simples e único neste exemplo de código
- //  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
- //  fragmentShader source no iniçio deste arquivo
- //  A função retorna o identificador do programa de shader
- int setupShader()
- {
-	 // Vertex shader
-	 GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	 glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	 glCompileShader(vertexShader);
-	 // Checando erros de compilação (exibição via log no terminal)
-	 GLint success;
-	 GLchar infoLog[512];
-	 glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	 if (!success)
-	 {
-		 glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		 std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				   << infoLog << std::endl;
-	 }
-	 // Fragment shader
-	 GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	 glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	 glCompileShader(fragmentShader);
-	 // Checando erros de compilação (exibição via log no terminal)
-	 glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	 if (!success)
-	 {
-		 glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		 std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				   << infoLog << std::endl;
-	 }
-	 // Linkando os shaders e criando o identificador do programa de shader
-	 GLuint shaderProgram = glCreateProgram();
-	 glAttachShader(shaderProgram, vertexShader);
-	 glAttachShader(shaderProgram, fragmentShader);
-	 glLinkProgram(shaderProgram);
-	 // Checando por erros de linkagem
-	 glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	 if (!success)
-	 {
-		 glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		 std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				   << infoLog << std::endl;
-	 }
-	 glDeleteShader(vertexShader);
-	 glDeleteShader(fragmentShader);
- 
-	 return shaderProgram;
- }
- 
  // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
  // geometria de um triângulo
  // Apenas atributo coordenada nos vértices
@@ -12,6 +12,12 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <Headless.h>
+
+#include <ShaderManager.h>
+#include <SplinePath.h>
+
 using namespace std;
 using namespace glm;
 
@@ -27,9 +33,11 @@ GLuint shaderProgram, VAO, VBO, textureID;
 vec3 ka(0.1f), kd(1.0f), ks(0.5f);
 float shininess = 32.0f;
 
-// Trajetória
+// Trajetória: spline fechada pelos pontos, percorrida com velocidade constante
 vector<vec3> trajectoryPoints;
-int currentPointIndex = 0;
+SplinePath trajectory;
+float trajectoryDistance = 0.0f; // distância percorrida no caminho
+uint32_t trajectoryCursor = SplinePath::NO_CURSOR;
 float moveSpeed = 1.0f;
 vec3 objectPos(0.0f);
 
@@ -114,20 +122,16 @@ void updateTrajectory(float dt)
 {
     if (trajectoryPoints.empty())
         return;
-    vec3 target = trajectoryPoints[currentPointIndex];
-    vec3 dir = normalize(target - objectPos);
-    float dist = length(target - objectPos);
-    float step = moveSpeed * dt;
+    trajectoryDistance = trajectory.wrap(trajectoryDistance + moveSpeed * dt);
+    objectPos = trajectory.position(trajectoryDistance, trajectoryCursor);
+}
 
-    if (step >= dist)
-    {
-        objectPos = target;
-        currentPointIndex = (currentPointIndex + 1) % trajectoryPoints.size();
-    }
-    else
-    {
-        objectPos += dir * step;
-    }
+// Ponto novo: refaz a spline (coeficientes e tabela de comprimento de arco)
+void addTrajectoryPoint(const vec3 &point)
+{
+    trajectoryPoints.push_back(point);
+    trajectory.build(trajectoryPoints, true);
+    trajectoryCursor = SplinePath::NO_CURSOR;
 }
 
 // Vertex Shader (igual ao seu atual)
@@ -204,23 +208,6 @@ const char *fragmentShaderSource = R"(
         FragColor = vec4(result, 1.0);
     })";
 
-GLuint compileShader()
-{
-    GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vs, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vs);
-    GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fs, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fs);
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vs);
-    glAttachShader(program, fs);
-    glLinkProgram(program);
-    glDeleteShader(vs);
-    glDeleteShader(fs);
-    return program;
-}
-
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     if (firstMouse) {
         lastX = xpos;
@@ -389,25 +376,35 @@ void processInput(GLFWwindow* window) {
 
     if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && currentTime - lastToggleTime > debounceTime) {
         vec3 point = camera.position + camera.front * 3.0f;
-        trajectoryPoints.push_back(point);
+        addTrajectoryPoint(point);
         cout << "Ponto adicionado: " << to_string(point) << endl;
         lastToggleTime = currentTime;
     }
 }
 
 
-int main()
+int main(int argc, char** argv)
 {
+    Headless headless(argc, argv);
+    headless.initHints();
     glfwInit();
+    headless.windowHints();
     GLFWwindow *window = glfwCreateWindow(800, 600, "Carolina Prates, Kevin Kuhn e Vítor Mello", nullptr, nullptr);
-    glfwMakeContextCurrent(window);
-    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    headless.makeCurrent(window);
+    gladLoadGLLoader(headless.loader());
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetCursorPosCallback(window, mouse_callback);
     glEnable(GL_DEPTH_TEST);
 
-    shaderProgram = compileShader();
+    // Compila em paralelo com o carregamento do modelo
+    ShaderManager shaders;
+    shaders.init(headless.loader());
+    int programa = shaders.add("vivencial2", vertexShaderSource, fragmentShaderSource);
     loadOBJWithMTL("../assets/Modelos3D/Cube.obj", "../assets/Modelos3D");
+    shaders.waitAll();
+    shaderProgram = shaders.program(programa);
+    shaders.report();
+
     setupBuffers();
     glUseProgram(shaderProgram);
     glUniform1i(glGetUniformLocation(shaderProgram, "texBuff"), 0);
@@ -463,7 +460,7 @@ int main()
             glDrawArrays(GL_TRIANGLES, 0, vertices.size());
         }
 
-        glfwSwapBuffers(window);
+        headless.swapBuffers(window);
     }
 
     glfwTerminate();